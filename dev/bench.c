@@ -0,0 +1,1043 @@
+/**
+ * \file bench.c
+ * \brief Benchmarks of the IdStack and FftStack functions
+ * \author Quentin.C
+ * \version 0.1
+ * \date October 19th 2026
+ *
+ * Each bench prints a table. Build it with the Bench target of the Makefile.
+ *
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <math.h>
+#include <pthread.h>
+#include <sched.h>
+#include <unistd.h>
+#include "stack.h"
+#include "idStack.h"
+#include "kiss_fft.h"
+#include "kiss_fftr.h"
+#include "fftFreq.h"
+#include "fftStack.h"
+
+/*
+ * Return a monotonic time in nanoseconds.
+ */
+static double benchNow()
+{
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return ts.tv_sec*1e9 + ts.tv_nsec;
+}
+
+/*
+ * Per frame cost of pushing one value per channel, with one dataHandlePush per channel or one dataIdFramePush.
+ * Channels are popped after each round so the spare Elements are reused as in a real housekeeping loop.
+ */
+static void benchFramePush()
+{
+	unsigned int channelNumbers[] = {1,4,16,64,256,1024};
+	unsigned int frameNumber = 256, roundNumber = 20;
+	char name[ID_NAME_SIZE];
+
+	printf("\nFRAME PUSH (ns per frame)\n");
+	printf("CHANNELS\tHANDLE_PUSH\tFRAME_PUSH\tSPEEDUP\n");
+	for (unsigned int c = 0; c < sizeof(channelNumbers)/sizeof(*channelNumbers); c++)
+	{
+		unsigned int channelNumber = channelNumbers[c];
+		IdStack* myIdStack = idInitialize();
+		unsigned int* handles = malloc(channelNumber*sizeof(*handles));
+		float* frame = malloc(channelNumber*sizeof(*frame));
+		for (unsigned int i = 0; i < channelNumber; i++)
+		{
+			sprintf(name, "CH%u", i);
+			handles[i] = idStackRegister(myIdStack, name, OTHER_TYPE, FLOAT, 0, 1)->handle;
+			frame[i] = (float)i;
+		}
+		IdFrame* idFrame = idFrameInitialize(myIdStack, handles, channelNumber);
+		double handleTime = 0, frameTime = 0, t;
+		unsigned int stopTime = 0;
+		for (unsigned int r = 0; r < roundNumber; r++)
+		{
+			t = benchNow();
+			for (unsigned int f = 0; f < frameNumber; f++)
+				for (unsigned int i = 0; i < channelNumber; i++)
+					dataHandlePush(myIdStack, handles[i], &frame[i]);
+			handleTime += benchNow() - t;
+			stopTime += frameNumber;
+			for (unsigned int i = 0; i < channelNumber; i++)
+				free(dataHandlePop(myIdStack, handles[i], stopTime-1));
+
+			t = benchNow();
+			for (unsigned int f = 0; f < frameNumber; f++)
+				dataIdFramePush(idFrame, frame);
+			frameTime += benchNow() - t;
+			stopTime += frameNumber;
+			for (unsigned int i = 0; i < channelNumber; i++)
+				free(dataHandlePop(myIdStack, handles[i], stopTime-1));
+		}
+		handleTime /= frameNumber*roundNumber;
+		frameTime /= frameNumber*roundNumber;
+		printf("%u\t\t%.1f\t\t%.1f\t\t%.2f\n", channelNumber, handleTime, frameTime, handleTime/frameTime);
+		idFrameDeinitialize(idFrame);
+		idDeinitialize(myIdStack);
+		free(handles);
+		free(frame);
+	}
+}
+
+/*
+ * Return the resident memory of the process in kB (Linux only, 0 elsewhere).
+ */
+static long benchResident()
+{
+	long pages = 0, resident = 0;
+	FILE* statm = fopen("/proc/self/statm", "r");
+	if (statm == NULL)
+		return 0;
+	if (fscanf(statm, "%ld %ld", &pages, &resident) != 2)
+		resident = 0;
+	fclose(statm);
+	return resident*4;
+}
+
+/*
+ * Memory of an IdStack with a budget under sustained ingest on 64 channels of different priorities.
+ */
+static void benchBudget()
+{
+	unsigned int channelNumber = 64, frameNumber = 800000;
+	unsigned int handles[64];
+	float frame[64];
+	char name[ID_NAME_SIZE];
+	IdStack* myIdStack = idInitialize();
+	for (unsigned int i = 0; i < channelNumber; i++)
+	{
+		sprintf(name, "CH%u", i);
+		IdElement* idElement = idStackRegister(myIdStack, name, OTHER_TYPE, FLOAT, 0, 1);
+		idElement->priority = i%4;
+		handles[i] = idElement->handle;
+		frame[i] = (float)i;
+	}
+	IdFrame* idFrame = idFrameInitialize(myIdStack, handles, channelNumber);
+	idStackSetBudget(myIdStack, 16*1024*1024, NULL, NULL);
+
+	printf("\nBUDGET (16 MB, %u channels)\n", channelNumber);
+	printf("FRAMES\t\tMEMORY_USED(kB)\tRESIDENT(kB)\tns/frame\n");
+	double t = benchNow();
+	for (unsigned int f = 1; f <= frameNumber; f++)
+	{
+		dataIdFramePush(idFrame, frame);
+		if (f % (frameNumber/8) == 0)
+		{
+			printf("%u\t\t%zu\t\t%ld\t\t%.1f\n", f, myIdStack->memoryUsed/1024, benchResident(), (benchNow()-t)/(frameNumber/8));
+			t = benchNow();
+		}
+	}
+	idFrameDeinitialize(idFrame);
+	idDeinitialize(myIdStack);
+}
+
+typedef struct BenchProducer BenchProducer;
+struct BenchProducer
+{
+	IdStack* idStack;
+	unsigned int handle;
+	unsigned int number;
+};
+
+static void* benchProducer(void* parameter)
+{
+	BenchProducer* producer = parameter;
+	for (unsigned int i = 0; i < producer->number; i++)
+	{
+		float value = (float)i;
+		while (dataHandleProduce(producer->idStack, producer->handle, &value) != 0)
+			sched_yield();
+	}
+	return NULL;
+}
+
+/*
+ * Throughput of a concurrent IdStack : one producer thread per channel, the calling thread drains and pops.
+ */
+static void benchConcurrent()
+{
+	unsigned int producerNumbers[] = {1,2,4,8,16};
+	unsigned int number = 1000000;
+	char name[ID_NAME_SIZE];
+
+	printf("\nCONCURRENT INGEST (%ld cores, %u data per producer)\n", sysconf(_SC_NPROCESSORS_ONLN), number);
+	printf("PRODUCERS\tMdata/s\n");
+	for (unsigned int p = 0; p < sizeof(producerNumbers)/sizeof(*producerNumbers); p++)
+	{
+		unsigned int producerNumber = producerNumbers[p];
+		pthread_t threads[16];
+		BenchProducer producers[16];
+		IdStack* myIdStack = idInitialize();
+		for (unsigned int i = 0; i < producerNumber; i++)
+		{
+			sprintf(name, "CH%u", i);
+			producers[i].idStack = myIdStack;
+			producers[i].handle = idStackRegister(myIdStack, name, OTHER_TYPE, FLOAT, 0, 1)->handle;
+			producers[i].number = number;
+		}
+		idStackConcurrent(myIdStack, 4096);
+		double t = benchNow();
+		for (unsigned int i = 0; i < producerNumber; i++)
+			pthread_create(&threads[i], NULL, benchProducer, &producers[i]);
+		unsigned long consumed = 0;
+		while (consumed < (unsigned long)producerNumber*number)
+		{
+			idStackDrain(myIdStack);
+			for (unsigned int i = 0; i < producerNumber; i++)
+			{
+				IdElement* idElement = handleIdElement(myIdStack, producers[i].handle);
+				if (idElement->dataNumber > 0)
+				{
+					consumed += idElement->dataNumber;
+					free(dataHandlePop(myIdStack, producers[i].handle, idElement->startTime + idElement->dataNumber - 1));
+				}
+			}
+			sched_yield();
+		}
+		for (unsigned int i = 0; i < producerNumber; i++)
+			pthread_join(threads[i], NULL);
+		printf("%u\t\t%.1f\n", producerNumber, consumed/((benchNow()-t)/1e3));
+		idDeinitialize(myIdStack);
+	}
+}
+
+/*
+ * Time of idStackSnapshot and idRestore for 64 channels holding more and more data, then time to pop the restored data.
+ */
+static void benchSnapshot()
+{
+	unsigned int channelNumber = 64, dataNumbers[] = {1000,10000,100000};
+	unsigned int handles[64];
+	float frame[64];
+	char name[ID_NAME_SIZE];
+	const char* path = "/tmp/benchSnapshot.bin";
+
+	printf("\nSNAPSHOT (%u channels, ms)\n", channelNumber);
+	printf("DATA/CHANNEL\tSNAPSHOT\tRESTORE\t\tPOP_RESTORED\n");
+	for (unsigned int d = 0; d < sizeof(dataNumbers)/sizeof(*dataNumbers); d++)
+	{
+		IdStack* myIdStack = idInitialize();
+		for (unsigned int i = 0; i < channelNumber; i++)
+		{
+			sprintf(name, "CH%u", i);
+			handles[i] = idStackRegister(myIdStack, name, OTHER_TYPE, FLOAT, 0, 1)->handle;
+			frame[i] = (float)i;
+		}
+		IdFrame* idFrame = idFrameInitialize(myIdStack, handles, channelNumber);
+		for (unsigned int f = 0; f < dataNumbers[d]; f++)
+			dataIdFramePush(idFrame, frame);
+		idFrameDeinitialize(idFrame);
+		double t = benchNow();
+		idStackSnapshot(myIdStack, path);
+		double snapshotTime = benchNow() - t;
+
+		/*The saved IdStack is freed after the measures, or the allocator would charge its cleanup to the first pop*/
+		t = benchNow();
+		IdStack* restoredIdStack = idRestore(path);
+		double restoreTime = benchNow() - t;
+		t = benchNow();
+		for (unsigned int i = 0; i < channelNumber; i++)
+			free(dataHandlePop(restoredIdStack, handles[i], dataNumbers[d]-1));
+		double popTime = benchNow() - t;
+		printf("%u\t\t%.2f\t\t%.3f\t\t%.2f\n", dataNumbers[d], snapshotTime/1e6, restoreTime/1e6, popTime/1e6);
+		idDeinitialize(restoredIdStack);
+		idDeinitialize(myIdStack);
+	}
+	remove(path);
+}
+
+/*
+ * Irregular channel : bytes per time and cost of reading 100 data at a random time, for more and more data.
+ */
+static void benchIrregular()
+{
+	unsigned int dataNumbers[] = {10000,100000,1000000,10000000};
+	unsigned int readNumber = 10000, number;
+
+	printf("\nIRREGULAR CHANNEL (jittered times)\n");
+	printf("DATA\t\tBYTES/DATA\tREAD_100(ns)\n");
+	for (unsigned int d = 0; d < sizeof(dataNumbers)/sizeof(*dataNumbers); d++)
+	{
+		IdStack* myIdStack = idInitialize();
+		IdElement* idElement = idStackRegister(myIdStack, "EVENTS", OTHER_TYPE, FLOAT, 0, 1);
+		unsigned int time = 0;
+		idElementIrregular(myIdStack, idElement);
+		srand(1);
+		for (unsigned int i = 0; i < dataNumbers[d]; i++)
+		{
+			float value = (float)i;
+			time += 95 + rand()%10;
+			dataHandlePushTime(myIdStack, idElement->handle, time, &value);
+		}
+		double t = benchNow();
+		for (unsigned int r = 0; r < readNumber; r++)
+		{
+			unsigned int startTime = (unsigned int)(((double)rand()/RAND_MAX)*(time - 100*105));
+			free(dataHandleReadTime(myIdStack, idElement->handle, startTime, startTime + 100*100, &number, NULL));
+		}
+		printf("%u\t%s%.2f\t\t%.0f\n", dataNumbers[d], (dataNumbers[d] < 10000000) ? "\t" : "", (double)timeStackMemory(idElement->timeStack)/dataNumbers[d], (benchNow()-t)/readNumber);
+		idDeinitialize(myIdStack);
+	}
+}
+
+/*
+ * Former transform of fftLow/fftHigh : the bloc is copied into complex numbers with zero imaginary parts and
+ * transformed by a real FFT of twice its size.
+ */
+static float benchDoubledFft(float* array, unsigned int size)
+{
+	kiss_fft_cpx* out = malloc((size+1)*sizeof(*out));
+	kiss_fftr_cfg fft = kiss_fftr_alloc(size*2, 0, 0, 0);
+	kiss_fft_cpx* buffer = copycpx(array, size);
+	kiss_fftr(fft, (kiss_fft_scalar*)buffer, out);
+	float result = out[size/2].r;
+	free(fft);
+	free(buffer);
+	free(out);
+	return result;
+}
+
+/*
+ * Cost of the forward transform of a bloc (fftAll, plans cached) against the former doubled transform planned for each bloc.
+ */
+static void benchRealFft()
+{
+	unsigned int blocSizes[] = {16,64,256,1024,4096,255};
+	float array[4096];
+	volatile float sink = 0;
+	for (unsigned int i = 0; i < 4096; i++)
+		array[i] = (float)(i%17) - 8.f;
+
+	printf("\nREAL FFT (ns per bloc)\n");
+	printf("BLOC_SIZE\tDOUBLED_2N\tREAL_N\t\tSPEEDUP\n");
+	for (unsigned int b = 0; b < sizeof(blocSizes)/sizeof(*blocSizes); b++)
+	{
+		unsigned int size = blocSizes[b], roundNumber = 4000000/size;
+		double t = benchNow();
+		for (unsigned int r = 0; r < roundNumber; r++)
+			sink += benchDoubledFft(array, size);
+		double doubledTime = (benchNow() - t)/roundNumber;
+		t = benchNow();
+		for (unsigned int r = 0; r < roundNumber; r++)
+		{
+			float* all = fftAll(array, size);
+			sink += all[size/2];
+			free(all);
+		}
+		double realTime = (benchNow() - t)/roundNumber;
+		printf("%u\t\t%.0f\t\t%.0f\t\t%.2f\n", size, doubledTime, realTime, doubledTime/realTime);
+	}
+	(void)sink;
+}
+
+/*
+ * Cost of compressing a bloc into its Low and High arrays : fftLow then fftHigh (two FFTs) against fftSplit (one FFT).
+ */
+static void benchSplitFft()
+{
+	unsigned int blocSizes[] = {16,64,256,1024,4096};
+	float array[4096];
+	float *low, *high;
+	for (unsigned int i = 0; i < 4096; i++)
+		array[i] = (float)(i%17) - 8.f;
+
+	printf("\nSPLIT FFT (ns per bloc)\n");
+	printf("BLOC_SIZE\tLOW+HIGH\tSPLIT\t\tSPEEDUP\n");
+	for (unsigned int b = 0; b < sizeof(blocSizes)/sizeof(*blocSizes); b++)
+	{
+		unsigned int size = blocSizes[b], roundNumber = 4000000/size;
+		double t = benchNow();
+		for (unsigned int r = 0; r < roundNumber; r++)
+		{
+			low = fftLow(array, size);
+			high = fftHigh(array, size);
+			free(low);
+			free(high);
+		}
+		double pairTime = (benchNow() - t)/roundNumber;
+		t = benchNow();
+		for (unsigned int r = 0; r < roundNumber; r++)
+		{
+			fftSplit(array, size, &low, &high);
+			free(low);
+			free(high);
+		}
+		double splitTime = (benchNow() - t)/roundNumber;
+		printf("%u\t\t%.0f\t\t%.0f\t\t%.2f\n", size, pairTime, splitTime, pairTime/splitTime);
+	}
+}
+
+/*
+ * Cost of fftSplit when the plan is computed for each bloc (cache emptied before each call) and with the plan cache.
+ */
+static void benchPlanCache()
+{
+	unsigned int blocSizes[] = {16,64,256,1024,4096};
+	float array[4096];
+	float *low, *high;
+	for (unsigned int i = 0; i < 4096; i++)
+		array[i] = (float)(i%17) - 8.f;
+
+	printf("\nPLAN CACHE (ns per bloc)\n");
+	printf("BLOC_SIZE\tNO_CACHE\tCACHE\t\tSPEEDUP\n");
+	for (unsigned int b = 0; b < sizeof(blocSizes)/sizeof(*blocSizes); b++)
+	{
+		unsigned int size = blocSizes[b], roundNumber = 4000000/size;
+		double t = benchNow();
+		for (unsigned int r = 0; r < roundNumber; r++)
+		{
+			fftPlanCleanup();
+			fftSplit(array, size, &low, &high);
+			free(low);
+			free(high);
+		}
+		double coldTime = (benchNow() - t)/roundNumber;
+		t = benchNow();
+		for (unsigned int r = 0; r < roundNumber; r++)
+		{
+			fftSplit(array, size, &low, &high);
+			free(low);
+			free(high);
+		}
+		double cachedTime = (benchNow() - t)/roundNumber;
+		printf("%u\t\t%.0f\t\t%.0f\t\t%.2f\n", size, coldTime, cachedTime, coldTime/cachedTime);
+	}
+	fftPlanCleanup();
+}
+
+/*
+ * Cost of compressing 64 contiguous blocs : one fftSplit per bloc against one fftSplitBatch.
+ */
+static void benchBatchFft()
+{
+	unsigned int blocSizes[] = {16,64,256,1024}, nbBlocs = 64;
+	float* array = malloc(1024*64*sizeof(*array));
+	float* low = malloc(1024*64*sizeof(*low));
+	float* high = malloc(1024*64*sizeof(*high));
+	float *blocLow, *blocHigh;
+	for (unsigned int i = 0; i < 1024*64; i++)
+		array[i] = (float)(i%17) - 8.f;
+
+	printf("\nBATCH FFT (ns per bloc, %u blocs per call)\n", nbBlocs);
+	printf("BLOC_SIZE\tSPLIT\t\tBATCH\t\tSPEEDUP\n");
+	for (unsigned int b = 0; b < sizeof(blocSizes)/sizeof(*blocSizes); b++)
+	{
+		unsigned int size = blocSizes[b], roundNumber = 4000000/(size*nbBlocs) + 1;
+		double t = benchNow();
+		for (unsigned int r = 0; r < roundNumber; r++)
+			for (unsigned int i = 0; i < nbBlocs; i++)
+			{
+				fftSplit(array + i*size, size, &blocLow, &blocHigh);
+				free(blocLow);
+				free(blocHigh);
+			}
+		double splitTime = (benchNow() - t)/(roundNumber*nbBlocs);
+		t = benchNow();
+		for (unsigned int r = 0; r < roundNumber; r++)
+			fftSplitBatch(array, size, nbBlocs, low, high);
+		double batchTime = (benchNow() - t)/(roundNumber*nbBlocs);
+		printf("%u\t\t%.0f\t\t%.0f\t\t%.2f\n", size, splitTime, batchTime, splitTime/batchTime);
+	}
+	free(array);
+	free(low);
+	free(high);
+	fftPlanCleanup();
+}
+
+/*
+ * Scaling of fftPushParallel : 8 channels of 256 blocs of 256 data, with 1 thread up to the number of cores.
+ */
+static void benchParallelPush()
+{
+	unsigned int channelNumber = REGISTERED, blocSize = 256, dataNumber = 256*256;
+	unsigned int coreNumber = (unsigned int)sysconf(_SC_NPROCESSORS_ONLN), threadNumber = 1;
+	Id_type ids[REGISTERED];
+	double serialTime = 0;
+
+	printf("\nPARALLEL FFT PUSH (%u cores, %u channels of %u blocs)\n", coreNumber, channelNumber, dataNumber/blocSize);
+	printf("THREADS\t\tms\t\tSPEEDUP\n");
+	for (;;)
+	{
+		IdStack* myIdStack = idInitialize();
+		FftStack* myFftStack = fftInitialize();
+		for (unsigned int c = 0; c < channelNumber; c++)
+		{
+			ids[c] = (Id_type)c;
+			idStackPush(myIdStack, ids[c], OTHER_TYPE, FLOAT, 0, 1);
+			initializeFftElement(myFftStack, ids[c], blocSize);
+			for (unsigned int i = 0; i < dataNumber; i++)
+			{
+				float value = (float)((i+c)%17) - 8.f;
+				dataIdStackPush(myIdStack, ids[c], &value);
+			}
+		}
+		double t = benchNow();
+		fftPushParallel(myFftStack, myIdStack, ids, channelNumber, ~0u, threadNumber);
+		double pushTime = benchNow() - t;
+		if (threadNumber == 1)
+			serialTime = pushTime;
+		printf("%u\t\t%.1f\t\t%.2f\n", threadNumber, pushTime/1e6, serialTime/pushTime);
+		fftDeinitialize(myFftStack);
+		idDeinitialize(myIdStack);
+		if (threadNumber >= coreNumber)
+			break;
+		threadNumber = (2*threadNumber < coreNumber) ? 2*threadNumber : coreNumber;
+	}
+	fftPlanCleanup();
+}
+
+static void benchPopInto()
+{
+	unsigned int blocSize = 64, dataNumber = 64*1024, frameBlocs = 4, repeat = 200;
+	IdStack* myIdStack = idInitialize();
+	FftStack* myFftStack = fftInitialize();
+	idStackPush(myIdStack, MCU_CURR, OTHER_TYPE, FLOAT, 0, 1);
+	initializeFftElement(myFftStack, MCU_CURR, blocSize);
+	for (unsigned int i = 0; i < dataNumber; i++)
+	{
+		float value = (float)(i%17) - 8.f;
+		dataIdStackPush(myIdStack, MCU_CURR, &value);
+	}
+	fftPush(myFftStack, myIdStack, MCU_CURR, ~0u);
+	unsigned int frameNumber = dataNumber/(blocSize*frameBlocs);
+	char frame[4096];
+	float checksum = 0;
+
+	printf("\nFFT POP (%u frames of %u blocs, KEEP ALL)\n", frameNumber, frameBlocs);
+	printf("API\t\tns/frame\n");
+	double t = benchNow();
+	for (unsigned int r = 0; r < repeat; r++)
+		for (unsigned int f = 0; f < frameNumber; f++)
+		{
+			unsigned int start = f*blocSize*frameBlocs;
+			float* array = fftPop(myFftStack, MCU_CURR, start, start + blocSize*frameBlocs - 1, KEEP, ALL);
+			checksum += array[FFT_POP_PARAM];
+			free(array);
+		}
+	printf("fftPop\t\t%.1f\n", (benchNow() - t)/((double)repeat*frameNumber));
+	t = benchNow();
+	for (unsigned int r = 0; r < repeat; r++)
+		for (unsigned int f = 0; f < frameNumber; f++)
+		{
+			unsigned int start = f*blocSize*frameBlocs;
+			fftPopInto(myFftStack, MCU_CURR, start, start + blocSize*frameBlocs - 1, KEEP, ALL, frame, sizeof(frame));
+			checksum += frame[FFT_POP_PARAM*sizeof(float)];
+		}
+	printf("fftPopInto\t%.1f\t(checksum %.0f)\n", (benchNow() - t)/((double)repeat*frameNumber), checksum);
+	fftDeinitialize(myFftStack);
+	idDeinitialize(myIdStack);
+	fftPlanCleanup();
+}
+
+static void benchDecode()
+{
+	unsigned int blocSize = 256, dataNumber = 256*1024;
+	IdStack* myIdStack = idInitialize();
+	FftStack* myFftStack = fftInitialize();
+	idStackPush(myIdStack, MCU_CURR, OTHER_TYPE, FLOAT, 0, 1);
+	initializeFftElement(myFftStack, MCU_CURR, blocSize);
+	for (unsigned int i = 0; i < dataNumber; i++)
+	{
+		float value = (float)(i%17) - 8.f;
+		dataIdStackPush(myIdStack, MCU_CURR, &value);
+	}
+	fftPush(myFftStack, myIdStack, MCU_CURR, ~0u);
+	float* array = fftPop(myFftStack, MCU_CURR, 0, dataNumber-1, KEEP, ALL);
+	unsigned int nbBlocs = dataNumber/blocSize, sizeCompressedL = (blocSize+2)/2+((blocSize+2)/2)%2;
+	unsigned int sizeCompressedH = blocSize/2+(blocSize/2)%2;
+	float* values = (float*)malloc(dataNumber*sizeof(float));
+	unsigned int* times = (unsigned int*)malloc(dataNumber*sizeof(unsigned int));
+
+	printf("\nFFT DECODE (%u blocs of %u data, ALL)\n", nbBlocs, blocSize);
+	printf("DECODER\t\t\tms\t\tMB/s\n");
+	/*Decoding of ifft : two inverse FFTs and three allocations per bloc*/
+	double t = benchNow();
+	float* array2 = array + FFT_POP_PARAM;
+	for (unsigned int i = 0; i < nbBlocs; i++)
+	{
+		float* dataLow = ifftLow(array2 + i*(sizeCompressedL+sizeCompressedH), blocSize);
+		float* dataHigh = ifftHigh(array2 + i*(sizeCompressedL+sizeCompressedH) + sizeCompressedL, blocSize);
+		for (unsigned int j = 0; j < blocSize; j++)
+			values[i*blocSize+j] = dataLow[j] + dataHigh[j];
+		free(dataLow);
+		free(dataHigh);
+	}
+	double decodeTime = benchNow() - t;
+	printf("ifftLow+ifftHigh\t%.1f\t\t%.0f\n", decodeTime/1e6, dataNumber*sizeof(float)*1e3/decodeTime);
+	t = benchNow();
+	ifftDecode(array, times, values, dataNumber);
+	decodeTime = benchNow() - t;
+	printf("ifftDecode\t\t%.1f\t\t%.0f\n", decodeTime/1e6, dataNumber*sizeof(float)*1e3/decodeTime);
+	free(values);
+	free(times);
+	free(array);
+	fftDeinitialize(myFftStack);
+	idDeinitialize(myIdStack);
+	fftPlanCleanup();
+}
+
+static void benchAdaptive()
+{
+	unsigned int blocSize = 256, dataNumber = 256*256, seed = 11;
+	float bounds[3] = {0.01f, 0.05f, 0.2f};
+	IdStack* myIdStack = idInitialize();
+	FftStack* myFftStack = fftInitialize();
+	idStackPush(myIdStack, MCU_CURR, OTHER_TYPE, FLOAT, 0, 1);
+	idStackPush(myIdStack, TEST1, OTHER_TYPE, FLOAT, 0, 1);
+	initializeFftElement(myFftStack, MCU_CURR, blocSize);
+	initializeFftElement(myFftStack, TEST1, blocSize);
+	/*A slow signal with a little noise and a white noise*/
+	for (unsigned int i = 0; i < dataNumber; i++)
+	{
+		seed = seed*1103515245u + 12345u;
+		float noise = (float)((seed >> 16)%1000)/1000.f;
+		float value = 10.f*(float)sin(i/700.) + 0.002f*noise;
+		dataIdStackPush(myIdStack, MCU_CURR, &value);
+		value = 10.f*noise;
+		dataIdStackPush(myIdStack, TEST1, &value);
+	}
+	fftPush(myFftStack, myIdStack, MCU_CURR, ~0u);
+	fftPush(myFftStack, myIdStack, TEST1, ~0u);
+	Id_type ids[2] = {MCU_CURR, TEST1};
+	const char* names[2] = {"smooth", "noisy"};
+
+	printf("\nADAPTIVE FFT (%u blocs of %u data, RMS error, ratio to ALL)\n", dataNumber/blocSize, blocSize);
+	printf("CHANNEL\tBOUND\t\tTOP_K\t\tBAND\t\tns/bloc\n");
+	for (int c = 0; c < 2; c++)
+		for (int b = 0; b < 3; b++)
+		{
+			long allSize = fftPopSize(myFftStack, ids[c], 0, dataNumber-1, KEEP, ALL);
+			fftSetErrorBound(myFftStack, ids[c], TOP_K, RMS_ERROR, bounds[b]);
+			double t = benchNow();
+			long topSize = fftPopSize(myFftStack, ids[c], 0, dataNumber-1, KEEP, ADAPTIVE);
+			double selectTime = benchNow() - t;
+			fftSetErrorBound(myFftStack, ids[c], BAND, RMS_ERROR, bounds[b]);
+			long bandSize = fftPopSize(myFftStack, ids[c], 0, dataNumber-1, KEEP, ADAPTIVE);
+			printf("%s\t%.2f\t\t%.1f\t\t%.1f\t\t%.0f\n", names[c], bounds[b], (double)allSize/topSize, (double)allSize/bandSize, selectTime*blocSize/dataNumber);
+		}
+	fftDeinitialize(myFftStack);
+	idDeinitialize(myIdStack);
+	fftPlanCleanup();
+}
+
+static void benchQuantize()
+{
+	unsigned int blocSize = 256, dataNumber = 256*256, seed = 5;
+	unsigned int bits[3] = {32, 16, 8};
+	Fft_type types[2] = {ALL, ADAPTIVE};
+	const char* names[2] = {"ALL", "ADAPTIVE"};
+	IdStack* myIdStack = idInitialize();
+	FftStack* myFftStack = fftInitialize();
+	idStackPush(myIdStack, MCU_CURR, OTHER_TYPE, FLOAT, 0, 1);
+	initializeFftElement(myFftStack, MCU_CURR, blocSize);
+	float* data = (float*)malloc(dataNumber*sizeof(float));
+	float* values = (float*)malloc(dataNumber*sizeof(float));
+	for (unsigned int i = 0; i < dataNumber; i++)
+	{
+		seed = seed*1103515245u + 12345u;
+		data[i] = 100.f*(float)sin(i/700.) + (float)((seed >> 16)%100)/100.f;
+		dataIdStackPush(myIdStack, MCU_CURR, &data[i]);
+	}
+	fftPush(myFftStack, myIdStack, MCU_CURR, ~0u);
+	fftSetErrorBound(myFftStack, MCU_CURR, TOP_K, RMS_ERROR, 0.5f);
+
+	printf("\nQUANTIZED FFT (%u blocs of %u data, raw int16 : 2 bytes/sample)\n", dataNumber/blocSize, blocSize);
+	printf("TYPE\t\tBITS\tbytes/sample\tRMS error\tns/sample (pop+decode)\n");
+	for (int t = 0; t < 2; t++)
+		for (int b = 0; b < 3; b++)
+		{
+			fftSetQuantization(myFftStack, MCU_CURR, bits[b]);
+			double time = benchNow();
+			float* array = fftPop(myFftStack, MCU_CURR, 0, dataNumber-1, KEEP, types[t]);
+			long size = fftPopSize(myFftStack, MCU_CURR, 0, dataNumber-1, KEEP, types[t]);
+			ifftDecode(array, NULL, values, dataNumber);
+			time = benchNow() - time;
+			double square = 0;
+			for (unsigned int i = 0; i < dataNumber; i++)
+				square += (values[i]-data[i])*(values[i]-data[i]);
+			printf("%s\t%s%u\t%.3f\t\t%.4f\t\t%.1f\n", names[t], (t == 0) ? "\t" : "", bits[b], (double)size/dataNumber, sqrt(square/dataNumber), time/dataNumber);
+			free(array);
+		}
+	free(data);
+	free(values);
+	fftDeinitialize(myFftStack);
+	idDeinitialize(myIdStack);
+	fftPlanCleanup();
+}
+
+static void benchDct()
+{
+	unsigned int blocSize = 256, dataNumber = 256*256, seed = 13;
+	float bounds[3] = {0.01f, 0.05f, 0.2f};
+	IdStack* myIdStack = idInitialize();
+	FftStack* myFftStack = fftInitialize();
+	idStackPush(myIdStack, MCU_CURR, OTHER_TYPE, FLOAT, 0, 1);
+	initializeFftElement(myFftStack, MCU_CURR, blocSize);
+	/*A slow drift with a little noise : the ends of a bloc don't meet*/
+	for (unsigned int i = 0; i < dataNumber; i++)
+	{
+		seed = seed*1103515245u + 12345u;
+		float value = 0.001f*i + 2.f*(float)sin(i/300.) + 0.002f*(float)((seed >> 16)%1000)/1000.f;
+		dataIdStackPush(myIdStack, MCU_CURR, &value);
+	}
+	fftPush(myFftStack, myIdStack, MCU_CURR, ~0u);
+
+	printf("\nDCT (%u blocs of %u data, RMS error, bytes/bloc)\n", dataNumber/blocSize, blocSize);
+	printf("BOUND\tADAPTIVE\tDCT\t\tns/bloc\n");
+	for (int b = 0; b < 3; b++)
+	{
+		fftSetErrorBound(myFftStack, MCU_CURR, TOP_K, RMS_ERROR, bounds[b]);
+		long adaptiveSize = fftPopSize(myFftStack, MCU_CURR, 0, dataNumber-1, KEEP, ADAPTIVE);
+		double t = benchNow();
+		long dctSize = fftPopSize(myFftStack, MCU_CURR, 0, dataNumber-1, KEEP, DCT);
+		t = benchNow() - t;
+		printf("%.2f\t%.1f\t\t%.1f\t\t%.0f\n", bounds[b], (double)adaptiveSize*blocSize/dataNumber, (double)dctSize*blocSize/dataNumber, t*blocSize/dataNumber);
+	}
+	fftDeinitialize(myFftStack);
+	idDeinitialize(myIdStack);
+	fftPlanCleanup();
+}
+
+/*
+ * Largest error of the Low array of a bloc against its frequencies computed in double, relative to the largest one.
+ */
+static double lowError(const double* data, unsigned int size, const float* low)
+{
+	unsigned int half = ((((size+2)/2)+((size+2)/2)%2))/2;
+	double* cosines = malloc(size*sizeof(*cosines));
+	double peak = 0, error = 0;
+	for (unsigned int i = 0; i < size; i++)
+		cosines[i] = cos(2*M_PI*i/size);
+	for (unsigned int k = 0; k < half && k <= size/2; k++)
+	{
+		double re = 0, im = 0;
+		for (unsigned int i = 0; i < size; i++)
+		{
+			re += data[i]*cosines[(size_t)i*k%size];
+			im -= data[i]*cosines[((size_t)i*k + size - size/4)%size];
+		}
+		peak = fmax(peak, fmax(fabs(re), fabs(im)));
+		error = fmax(error, fmax(fabs(low[k] - re), fabs(low[k+half] - im)));
+	}
+	free(cosines);
+	return error/peak;
+}
+
+/*
+ * Compression of 16 and 32 bits integer blocs by the default path (converted into floats, float FFT) and by the
+ * fixed point one (Q31), and the error of their frequencies against a transform in double for large blocs.
+ */
+static void benchFixedFft()
+{
+	unsigned int blocSizes[] = {64,256,1024,4096,16384}, number = 1 << 16;
+	int16_t* array16 = malloc(number*sizeof(*array16));
+	int32_t* array32 = malloc(number*sizeof(*array32));
+	float* array = malloc(number*sizeof(*array));
+	double* reference = malloc(16384*sizeof(*reference));
+	float* low = malloc(number*sizeof(*low));
+	float* high = malloc(number*sizeof(*high));
+	int32_t* fixedLow = malloc(number*sizeof(*fixedLow));
+	int32_t* fixedHigh = malloc(number*sizeof(*fixedHigh));
+	float* scales = malloc(number*sizeof(*scales));
+	for (unsigned int i = 0; i < number; i++)
+	{
+		array16[i] = (int16_t)(20000*sin(i/50.) + (i%17)*100);
+		array32[i] = array16[i]*1000;
+	}
+
+	printf("\nINTEGER FFT (ns per bloc, %u data per call, error of the frequencies relative to the largest one)\n", number);
+	printf("BLOC_SIZE\tFLOAT16\t\tFIXED16\t\tFIXED32\t\tERR_FLOAT16\tERR_FIXED16\tERR_FLOAT32\tERR_FIXED32\n");
+	for (unsigned int b = 0; b < sizeof(blocSizes)/sizeof(*blocSizes); b++)
+	{
+		unsigned int size = blocSizes[b], nbBlocs = number/size, roundNumber = 4000000/number + 1;
+		unsigned int sizeL = ((size+2)/2)+((size+2)/2)%2;
+		double times[3], errors[4];
+		double t = benchNow();
+		for (unsigned int r = 0; r < roundNumber; r++)
+		{
+			fftDataToFloat(array16, INT16_T, number, array);
+			fftSplitBatch(array, size, nbBlocs, low, high);
+		}
+		times[0] = (benchNow() - t)/(roundNumber*nbBlocs);
+		for (int bits = 16; bits <= 32; bits += 16)
+		{
+			const void* integers = (bits == 16) ? (const void*)array16 : (const void*)array32;
+			t = benchNow();
+			for (unsigned int r = 0; r < roundNumber; r++)
+				fftSplitBatchFixed(integers, bits, size, nbBlocs, fixedLow, fixedHigh, scales);
+			times[bits/16] = (benchNow() - t)/(roundNumber*nbBlocs);
+			for (unsigned int i = 0; i < size; i++)
+				reference[i] = (bits == 16) ? array16[i] : array32[i];
+			fftDataToFloat(integers, (bits == 16) ? INT16_T : INT32_T, size, array);
+			fftSplitBatch(array, size, 1, low, high);
+			errors[bits/8-2] = lowError(reference, size, low);
+			fftFixedToFloat(fixedLow, sizeL, scales[0], low);
+			errors[bits/8-1] = lowError(reference, size, low);
+		}
+		printf("%u\t\t%.0f\t\t%.0f\t\t%.0f\t\t%.1e\t\t%.1e\t\t%.1e\t\t%.1e\n", size, times[0], times[1], times[2], errors[0], errors[1], errors[2], errors[3]);
+	}
+	free(array16);
+	free(array32);
+	free(array);
+	free(reference);
+	free(low);
+	free(high);
+	free(fixedLow);
+	free(fixedHigh);
+	free(scales);
+	fftPlanCleanup();
+}
+
+/*
+ * Conversion of the data of each numeric Data_type into the floats of the transform, and back after a decoding.
+ */
+static void benchConvert()
+{
+	size_t number = 1 << 20;
+	Data_type types[10] = {UINT8_T, INT8_T, UINT16_T, INT16_T, UINT32_T, INT32_T, UINT64_T, INT64_T, DOUBLE, LDOUBLE};
+	const char* names[10] = {"UINT8_T", "INT8_T", "UINT16_T", "INT16_T", "UINT32_T", "INT32_T", "UINT64_T", "INT64_T", "DOUBLE", "LDOUBLE"};
+	float* values = malloc(number*sizeof(*values));
+	char* data = malloc(number*16);
+	for (size_t i = 0; i < number; i++)
+		values[i] = (float)(i%100);
+
+	printf("\nCONVERSION (ns per data)\n");
+	printf("TYPE\t\tTO_FLOAT\tFROM_FLOAT\n");
+	for (int t = 0; t < 10; t++)
+	{
+		double t0 = benchNow();
+		for (int r = 0; r < 10; r++)
+			fftFloatToData(values, number, types[t], data);
+		double fromTime = (benchNow() - t0)/(10.*number);
+		t0 = benchNow();
+		for (int r = 0; r < 10; r++)
+			fftDataToFloat(data, types[t], number, values);
+		double toTime = (benchNow() - t0)/(10.*number);
+		printf("%s\t%s%.2f\t\t%.2f\n", names[t], (strlen(names[t]) < 8) ? "\t" : "", toTime, fromTime);
+	}
+	free(values);
+	free(data);
+}
+
+/*
+ * Transform of blocs whose size has a large prime factor, directly (generic butterfly) or extended to fftFastSize.
+ */
+static void benchFastSize()
+{
+	unsigned int blocSizes[] = {97, 251, 509, 1021}, nbBlocs = 64;
+	float* array = malloc(1100*64*sizeof(*array));
+	float* low = malloc(1100*64*sizeof(*low));
+	float* high = malloc(1100*64*sizeof(*high));
+	for (unsigned int i = 0; i < 1100*64; i++)
+		array[i] = (float)(i%17) - 8.f;
+
+	printf("\nFAST SIZES (ns per bloc, %u blocs per call)\n", nbBlocs);
+	printf("BLOC_SIZE\tFFT_SIZE\tDIRECT\t\tEXTENDED\tSPEEDUP\n");
+	for (unsigned int b = 0; b < sizeof(blocSizes)/sizeof(*blocSizes); b++)
+	{
+		unsigned int size = blocSizes[b], fastSize = fftFastSize(size), roundNumber = 4000000/(size*nbBlocs) + 1;
+		double t = benchNow();
+		for (unsigned int r = 0; r < roundNumber; r++)
+			fftSplitBatch(array, size, nbBlocs, low, high);
+		double directTime = (benchNow() - t)/(roundNumber*nbBlocs);
+		t = benchNow();
+		for (unsigned int r = 0; r < roundNumber; r++)
+			fftSplitBatch(array, fastSize, nbBlocs, low, high);
+		double fastTime = (benchNow() - t)/(roundNumber*nbBlocs);
+		printf("%u\t\t%u\t\t%.0f\t\t%.0f\t\t%.1f\n", size, fastSize, directTime, fastTime, directTime/fastTime);
+	}
+	free(array);
+	free(low);
+	free(high);
+	fftPlanCleanup();
+}
+
+/*
+ * Peak memory of a channel and worst push latency when the blocs are compressed by fftStream as they fill, or by
+ * one fftPush after all the pushes.
+ */
+static void benchStream()
+{
+	unsigned int dataNumber = 1 << 20, blocSize = 256;
+	printf("\nSTREAMING (%u FLOAT data, blocs of %u)\n", dataNumber, blocSize);
+	printf("MODE\t\tPEAK_KB\t\tMAX_PUSH_US\tTOTAL_MS\n");
+	for (int stream = 0; stream < 2; stream++)
+	{
+		IdStack* idStack = idInitialize();
+		FftStack* fftStack = fftInitialize();
+		IdElement* idElement = idStackPush(idStack, MCU_CURR, OTHER_TYPE, FLOAT, 0, 1);
+		initializeFftElement(fftStack, MCU_CURR, blocSize);
+		if (stream)
+			fftStream(fftStack, idStack, MCU_CURR);
+		size_t peak = 0;
+		double maxPush = 0, start = benchNow(), t;
+		for (unsigned int i = 0; i < dataNumber; i++)
+		{
+			float value = (float)(i%251) - 125.f;
+			t = benchNow();
+			dataIdStackPush(idStack, MCU_CURR, &value);
+			t = benchNow() - t;
+			if (t > maxPush)
+				maxPush = t;
+			if ((i & 1023) == 0 && idElementMemory(idElement) > peak)
+				peak = idElementMemory(idElement);
+		}
+		if (idElementMemory(idElement) > peak)
+			peak = idElementMemory(idElement);
+		if (!stream)
+		{
+			t = benchNow();
+			fftPush(fftStack, idStack, MCU_CURR, dataNumber - 1);
+			t = benchNow() - t;
+			if (t > maxPush)
+				maxPush = t;
+		}
+		printf("%s\t%zu\t\t%.0f\t\t%.1f\n", stream ? "fftStream" : "fftPush  ", peak/1024, maxPush/1e3, (benchNow() - start)/1e6);
+		fftDeinitialize(fftStack);
+		idDeinitialize(idStack);
+	}
+	fftPlanCleanup();
+}
+
+/*
+ * Mean and RMS of a compressed channel from its stored frequencies (fftStats) or by popping and decoding its blocs.
+ */
+static void benchStats()
+{
+	unsigned int dataNumber = 1 << 18, blocSizes[] = {64, 256, 1024, 1001}, roundNumber = 20;
+	float* values = malloc(dataNumber*sizeof(*values));
+	printf("\nCOMPRESSED STATISTICS (%u FLOAT data, ms per query)\n", dataNumber);
+	printf("BLOC_SIZE\tDECODE\t\tFFTSTATS\tSPEEDUP\n");
+	for (unsigned int b = 0; b < sizeof(blocSizes)/sizeof(*blocSizes); b++)
+	{
+		IdStack* idStack = idInitialize();
+		FftStack* fftStack = fftInitialize();
+		idStackPush(idStack, MCU_CURR, OTHER_TYPE, FLOAT, 0, 1);
+		initializeFftElement(fftStack, MCU_CURR, blocSizes[b]);
+		for (unsigned int i = 0; i < dataNumber; i++)
+		{
+			float value = (float)(i%251) - 125.f;
+			dataIdStackPush(idStack, MCU_CURR, &value);
+		}
+		fftPush(fftStack, idStack, MCU_CURR, dataNumber - 1);
+		/*Only the whole blocs are compressed*/
+		unsigned int stopTime = dataNumber/blocSizes[b]*blocSizes[b] - 1;
+		float mean = 0, rms = 0;
+		double t = benchNow();
+		for (unsigned int r = 0; r < roundNumber; r++)
+		{
+			float* compressed = fftPop(fftStack, MCU_CURR, 0, stopTime, KEEP, ALL);
+			long number = ifftDecode(compressed, NULL, values, dataNumber);
+			double sum = 0, square = 0;
+			for (long i = 0; i < number; i++)
+			{
+				sum += values[i];
+				square += values[i]*values[i];
+			}
+			mean += (float)(sum/number);
+			rms += (float)sqrt(square/number);
+			free(compressed);
+		}
+		double decodeTime = (benchNow() - t)/roundNumber;
+		t = benchNow();
+		for (unsigned int r = 0; r < roundNumber; r++)
+		{
+			float blocMean, blocRms;
+			fftStats(fftStack, MCU_CURR, 0, stopTime, &blocMean, &blocRms, NULL);
+			mean -= blocMean;
+			rms -= blocRms;
+		}
+		double statsTime = (benchNow() - t)/roundNumber;
+		printf("%u\t\t%.2f\t\t%.2f\t\t%.1f\t(difference %.1e)\n", blocSizes[b], decodeTime/1e6, statsTime/1e6, decodeTime/statsTime, fabs(mean) + fabs(rms));
+		fftDeinitialize(fftStack);
+		idDeinitialize(idStack);
+	}
+	free(values);
+	fftPlanCleanup();
+}
+
+/*
+ * Overview of a compressed channel at 1/factor of its rate : full decoding then decimation, or fftDecimate.
+ */
+static void benchDecimate()
+{
+	unsigned int dataNumber = 1 << 18, blocSize = 256, factors[] = {4, 16, 64}, roundNumber = 20;
+	float* values = malloc(dataNumber*sizeof(*values));
+	unsigned int* times = malloc(dataNumber*sizeof(*times));
+	IdStack* idStack = idInitialize();
+	FftStack* fftStack = fftInitialize();
+	idStackPush(idStack, MCU_CURR, OTHER_TYPE, FLOAT, 0, 1);
+	initializeFftElement(fftStack, MCU_CURR, blocSize);
+	for (unsigned int i = 0; i < dataNumber; i++)
+	{
+		float value = (float)(i%251) - 125.f;
+		dataIdStackPush(idStack, MCU_CURR, &value);
+	}
+	fftPush(fftStack, idStack, MCU_CURR, dataNumber - 1);
+	printf("\nDECIMATED DECODING (%u FLOAT data, blocs of %u, ms per query)\n", dataNumber, blocSize);
+	printf("FACTOR\t\tDECODE\t\tFFTDECIMATE\tSPEEDUP\n");
+	for (unsigned int f = 0; f < sizeof(factors)/sizeof(*factors); f++)
+	{
+		unsigned int factor = factors[f];
+		double t = benchNow();
+		for (unsigned int r = 0; r < roundNumber; r++)
+		{
+			float* compressed = fftPop(fftStack, MCU_CURR, 0, dataNumber - 1, KEEP, ALL);
+			long number = ifftDecode(compressed, times, values, dataNumber);
+			for (long i = 0; i*factor < number; i++)
+			{
+				times[i] = times[i*factor];
+				values[i] = values[i*factor];
+			}
+			free(compressed);
+		}
+		double decodeTime = (benchNow() - t)/roundNumber;
+		t = benchNow();
+		for (unsigned int r = 0; r < roundNumber; r++)
+			fftDecimate(fftStack, MCU_CURR, 0, dataNumber - 1, factor, times, values, dataNumber);
+		double decimateTime = (benchNow() - t)/roundNumber;
+		printf("%u\t\t%.2f\t\t%.2f\t\t%.1f\n", factor, decodeTime/1e6, decimateTime/1e6, decodeTime/decimateTime);
+	}
+	fftDeinitialize(fftStack);
+	idDeinitialize(idStack);
+	free(values);
+	free(times);
+	fftPlanCleanup();
+}
+
+int main()
+{
+	benchFramePush();
+	benchBudget();
+	benchConcurrent();
+	benchSnapshot();
+	benchIrregular();
+	benchRealFft();
+	benchSplitFft();
+	benchPlanCache();
+	benchBatchFft();
+	benchParallelPush();
+	benchPopInto();
+	benchDecode();
+	benchAdaptive();
+	benchQuantize();
+	benchDct();
+	benchFixedFft();
+	benchConvert();
+	benchFastSize();
+	benchStream();
+	benchStats();
+	benchDecimate();
+	return 0;
+}
@@ -1,5 +1,10 @@
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <math.h>
+#include <pthread.h>
+#include <sched.h>
 #include "stack.h"
 #include "idStack.h"
 #include "minunit.h"
@@ -118,6 +123,1251 @@ MU_TEST(test_dataIdStackPop) {
 
 }
 
+MU_TEST(test_registerIdElements) {
+	char name[ID_NAME_SIZE];
+	IdElement* sunSensor = idStackRegister(myIdStack, "SUN_SENSOR",OTHER_TYPE,FLOAT,0,10);
+	mu_check(sunSensor != NULL);
+	mu_check(sunSensor->id == REGISTERED);
+	mu_check(idStackRegister(myIdStack, "SUN_SENSOR",OTHER_TYPE,FLOAT,0,10) == NULL);
+	mu_check(idStackRegister(myIdStack, "A_NAME_MUCH_TOO_LONG",OTHER_TYPE,FLOAT,0,10) == NULL);
+	mu_check(searchIdHandle(myIdStack, "SUN_SENSOR") == (int)sunSensor->handle);
+	mu_check(searchIdHandle(myIdStack, "MOON_SENSOR") == -1);
+	mu_check(handleIdElement(myIdStack, searchIdElement(myIdStack, MCU_CURR)->handle) == searchIdElement(myIdStack, MCU_CURR));
+	for(int i = 0; i<9; i++){
+		mu_check(dataHandlePush(myIdStack,sunSensor->handle,&aFloat[i]) == sunSensor);
+	}
+	floatP = dataHandlePop(myIdStack, sunSensor->handle, 80);
+	mu_check(floatP != NULL);
+	for(int i = 0; i<9; i++){
+		mu_check(floatP[i] == aFloat[i]);
+	}
+	free(floatP);
+	for(int i = 0; i<2000; i++){
+		sprintf(name, "CH%d", i);
+		mu_check(idStackRegister(myIdStack, name,OTHER_TYPE,INT32_T,0,1) != NULL);
+	}
+	int handle = searchIdHandle(myIdStack, "CH1234");
+	mu_check(dataHandlePush(myIdStack, handle, &aInt[3]) != NULL);
+	mu_check(*(int*)handleIdElement(myIdStack, handle)->dataStack->first->number == aInt[3]);
+	for(int i = 0; i<2000; i++){
+		sprintf(name, "CH%d", i);
+		mu_check(handleIdStackPop(myIdStack, searchIdHandle(myIdStack, name)) == 0);
+	}
+	mu_check(handleIdStackPop(myIdStack, sunSensor->handle) == 0);
+	mu_check(handleIdElement(myIdStack, handle) == NULL);
+	mu_check(dataHandlePush(myIdStack, handle, &aInt[3]) == NULL);
+}
+
+MU_TEST(test_framePush) {
+	unsigned int handles[3];
+	unsigned char frame[9];
+	handles[0] = idStackRegister(myIdStack, "FRAME_INT",OTHER_TYPE,INT32_T,0,10)->handle;
+	handles[1] = idStackRegister(myIdStack, "FRAME_FLOAT",VOLTAGE,FLOAT,0,10)->handle;
+	handles[2] = idStackRegister(myIdStack, "FRAME_CHAR",OTHER_TYPE,CHAR,0,10)->handle;
+	IdFrame* idFrame = idFrameInitialize(myIdStack, handles, 3);
+	mu_check(idFrame != NULL);
+	mu_check(idFrame->offsets[3] == 9);
+	for(int i = 0; i<6; i++){
+		memcpy(frame, &aInt[i], 4);
+		memcpy(frame+4, &aFloat[i], 4);
+		memcpy(frame+8, &aChar[i], 1);
+		mu_check(dataIdFramePush(idFrame, frame) == 3);
+	}
+	intP = dataHandlePop(myIdStack, handles[0], 50);
+	floatP = dataHandlePop(myIdStack, handles[1], 50);
+	charP = dataHandlePop(myIdStack, handles[2], 50);
+	for(int i = 0; i<6; i++){
+		mu_check(intP[i] == aInt[i]);
+		mu_check(floatP[i] == aFloat[i]);
+		mu_check(charP[i] == aChar[i]);
+	}
+	free(intP);free(floatP);free(charP);
+	mu_check(handleIdElement(myIdStack, handles[0])->dataStack->spareNumber == 6);
+	mu_check(dataIdFramePush(idFrame, frame) == 3);
+	mu_check(handleIdElement(myIdStack, handles[0])->dataStack->spareNumber == 5);
+	/*A channel made irregular after the frame was compiled stops the frame pushes*/
+	free(dataHandlePop(myIdStack, handles[2], 60));
+	mu_check(idElementIrregular(myIdStack, handleIdElement(myIdStack, handles[2])) == 0);
+	mu_check(dataIdFramePush(idFrame, frame) == -1);
+	mu_check(handleIdElement(myIdStack, handles[0])->dataNumber == 1);
+	mu_check(handleIdElement(myIdStack, handles[2])->dataNumber == 0);
+	mu_check(handleIdElement(myIdStack, handles[2])->timeStack->dataNumber == 0);
+	mu_check(handleIdStackPop(myIdStack, handles[2]) == 0);
+	mu_check(dataIdFramePush(idFrame, frame) == -1);
+	mu_check(handleIdElement(myIdStack, handles[0])->dataNumber == 1);
+	mu_check(handleIdElement(myIdStack, handles[1])->dataNumber == 1);
+	idFrameDeinitialize(idFrame);
+	mu_check(idFrameInitialize(myIdStack, handles, 3) == NULL);
+	for(int i = 0; i<2; i++){
+		mu_check(handleIdStackPop(myIdStack, handles[i]) == 0);
+	}
+}
+
+MU_TEST(test_memoryBudget) {
+	IdStack* budgetIdStack = idInitialize();
+	IdElement* lowPriority = idStackRegister(budgetIdStack, "LOW",OTHER_TYPE,FLOAT,0,10);
+	IdElement* highPriority = idStackRegister(budgetIdStack, "HIGH",OTHER_TYPE,FLOAT,0,10);
+	IdElement* limited = idStackRegister(budgetIdStack, "LIMITED",OTHER_TYPE,DOUBLE,0,10);
+	highPriority->priority = 1;
+	limited->priority = 2;
+	limited->quota = idElementMemory(limited) + 100*64;
+	size_t budget = budgetIdStack->memoryUsed + 1000*64;
+	idStackSetBudget(budgetIdStack, budget, NULL, NULL);
+	for(int i = 0; i<200; i++){
+		mu_check(dataHandlePush(budgetIdStack, highPriority->handle, &aFloat[i%9]) != NULL);
+	}
+	for(int i = 0; i<5000; i++){
+		mu_check(dataHandlePush(budgetIdStack, lowPriority->handle, &aFloat[i%9]) != NULL);
+		mu_check(dataHandlePush(budgetIdStack, limited->handle, &aDouble[i%6]) != NULL);
+		mu_check(budgetIdStack->memoryUsed <= budget);
+		mu_check(idElementMemory(limited) <= limited->quota);
+	}
+	mu_check(highPriority->dataNumber == 200);
+	mu_check(lowPriority->dataNumber > 0 && lowPriority->dataNumber < 1000);
+	mu_check(lowPriority->startTime == (5000-lowPriority->dataNumber)*10);
+	mu_check(limited->startTime == (5000-limited->dataNumber)*10);
+	unsigned int dataNumber = lowPriority->dataNumber;
+	floatP = dataHandlePop(budgetIdStack, lowPriority->handle, 49990);
+	mu_check(floatP[0] == aFloat[(5000-dataNumber)%9]);
+	mu_check(floatP[dataNumber-1] == aFloat[(5000-1)%9]);
+	free(floatP);
+	idDeinitialize(budgetIdStack);
+}
+
+int lyingEvict(IdStack *myIdStack, IdElement *idElement, unsigned int number, void *context) {
+	(void)myIdStack; (void)idElement; (void)context;
+	return (int)number;
+}
+
+MU_TEST(test_lyingEvict) {
+	IdStack* budgetIdStack = idInitialize();
+	IdElement* idElement = idStackRegister(budgetIdStack, "LYING",OTHER_TYPE,FLOAT,0,10);
+	size_t budget = budgetIdStack->memoryUsed + 100*64;
+	idStackSetBudget(budgetIdStack, budget, lyingEvict, NULL);
+	for(int i = 0; i<1000; i++){
+		mu_check(dataHandlePush(budgetIdStack, idElement->handle, &aFloat[i%9]) != NULL);
+		mu_check(budgetIdStack->memoryUsed <= budget);
+	}
+	mu_check(idElement->dataNumber > 0 && idElement->dataNumber < 100);
+	mu_check(idElement->startTime == (1000-idElement->dataNumber)*10);
+	idDeinitialize(budgetIdStack);
+}
+
+MU_TEST(test_fftEvict) {
+	IdStack* budgetIdStack = idInitialize();
+	FftStack* budgetFftStack = fftInitialize();
+	IdElement* idElementCurr = idStackPush(budgetIdStack, MCU_CURR,VOLTAGE,FLOAT,0,10);
+	initializeFftElement(budgetFftStack, MCU_CURR, 8);
+	size_t budget = budgetIdStack->memoryUsed + 100*64;
+	idStackSetBudget(budgetIdStack, budget, fftEvict, budgetFftStack);
+	for(int i = 0; i<1000; i++){
+		mu_check(dataIdStackPush(budgetIdStack, MCU_CURR, &aFloat[i%9]) != NULL);
+		mu_check(budgetIdStack->memoryUsed <= budget);
+	}
+	FftElement* fftElement = searchFftElement(budgetFftStack, MCU_CURR);
+	mu_check(fftElement->dataNumber > 0);
+	mu_check(fftElement->startTime == 0);
+	mu_check(idElementCurr->startTime == fftElement->dataNumber*8*10);
+	mu_check(idElementCurr->dataNumber == 1000 - fftElement->dataNumber*8);
+	fftDeinitialize(budgetFftStack);
+	idDeinitialize(budgetIdStack);
+}
+
+#define PRODUCED_NUMBER 50000
+IdStack* concurrentIdStack;
+atomic_uint churnHandle;
+atomic_int producing;
+
+void* producer(void* handle) {
+	for(int i = 0; i<PRODUCED_NUMBER; i++){
+		while (dataHandleProduce(concurrentIdStack, *(unsigned int*)handle, &i) != 0)
+			sched_yield();
+	}
+	return NULL;
+}
+
+void* churnProducer(void* unused) {
+	int value = 0;
+	(void)unused;
+	while (atomic_load(&producing))
+		dataHandleProduce(concurrentIdStack, atomic_load(&churnHandle), &value);
+	return NULL;
+}
+
+MU_TEST(test_concurrentIdStack) {
+	pthread_t threads[5];
+	unsigned int handles[4];
+	int expected[4] = {0,0,0,0};
+	char name[32];
+	concurrentIdStack = idInitialize();
+	for(int i = 0; i<4; i++){
+		sprintf(name, "P%d", i);
+		handles[i] = idStackRegister(concurrentIdStack, name,OTHER_TYPE,INT32_T,0,1)->handle;
+	}
+	size_t memoryUsed = concurrentIdStack->memoryUsed;
+	mu_check(idStackConcurrent(concurrentIdStack, 0) == -1);
+	mu_check(concurrentIdStack->concurrent == NULL && concurrentIdStack->memoryUsed == memoryUsed && handleIdElement(concurrentIdStack, handles[0])->ring == NULL);
+	mu_check(idStackConcurrent(concurrentIdStack, 256) == 0);
+	mu_check(idStackConcurrent(concurrentIdStack, 256) == -1);
+	atomic_store(&churnHandle, idStackRegister(concurrentIdStack, "CHURN",OTHER_TYPE,INT32_T,0,1)->handle);
+	atomic_store(&producing, 1);
+	for(int i = 0; i<4; i++){
+		pthread_create(&threads[i], NULL, producer, &handles[i]);
+	}
+	pthread_create(&threads[4], NULL, churnProducer, NULL);
+	int done = 0, round = 0;
+	while (!done) {
+		idStackDrain(concurrentIdStack);
+		done = 1;
+		for(int i = 0; i<4; i++){
+			IdElement* idElement = handleIdElement(concurrentIdStack, handles[i]);
+			if (idElement->dataNumber > 0) {
+				unsigned int dataNumber = idElement->dataNumber;
+				intP = dataHandlePop(concurrentIdStack, handles[i], idElement->startTime + dataNumber - 1);
+				for(unsigned int j = 0; j<dataNumber; j++){
+					mu_check(intP[j] == expected[i]++);
+				}
+				free(intP);
+			}
+			done = done && expected[i] == PRODUCED_NUMBER;
+		}
+		if (round++ % 8 == 0) {
+			unsigned int oldHandle = atomic_load(&churnHandle);
+			for(int i = 0; i<20; i++){
+				sprintf(name, "CHURN%d", i);
+				idStackRegister(concurrentIdStack, name,OTHER_TYPE,INT32_T,0,1);
+			}
+			sprintf(name, "CHURN%d", round%20);
+			atomic_store(&churnHandle, searchIdHandle(concurrentIdStack, name));
+			mu_check(handleIdStackPop(concurrentIdStack, oldHandle) == 0);
+			for(int i = 0; i<20; i++){
+				sprintf(name, "CHURN%d", i);
+				if (i != round%20)
+					handleIdStackPop(concurrentIdStack, searchIdHandle(concurrentIdStack, name));
+			}
+		}
+	}
+	atomic_store(&producing, 0);
+	for(int i = 0; i<5; i++){
+		pthread_join(threads[i], NULL);
+	}
+	mu_check(concurrentIdStack->memoryUsed > 0);
+	idDeinitialize(concurrentIdStack);
+}
+
+MU_TEST(test_snapshotRestore) {
+	const char* path = "/tmp/idStackSnapshot.bin";
+	IdStack* savedIdStack = idInitialize();
+	IdElement* idElementCurr = idStackPush(savedIdStack, MCU_CURR,VOLTAGE,FLOAT,100,10);
+	idStackRegister(savedIdStack, "GAP",OTHER_TYPE,INT32_T,0,1);
+	IdElement* registered = idStackRegister(savedIdStack, "PRESSURE",OTHER_TYPE,DOUBLE,0,1);
+	idElementCurr->priority = 3;
+	handleIdStackPop(savedIdStack, searchIdHandle(savedIdStack, "GAP"));
+	for(int i = 0; i<1000; i++){
+		dataIdStackPush(savedIdStack, MCU_CURR, &aFloat[i%9]);
+		dataHandlePush(savedIdStack, registered->handle, &aDouble[i%6]);
+	}
+	free(dataIdStackPop(savedIdStack, MCU_CURR, 100+99*10));
+	mu_check(idStackSnapshot(savedIdStack, path) == 0);
+	idDeinitialize(savedIdStack);
+
+	IdStack* restoredIdStack = idRestore(path);
+	mu_check(restoredIdStack != NULL);
+	idElementCurr = searchIdElement(restoredIdStack, MCU_CURR);
+	registered = handleIdElement(restoredIdStack, 2);
+	mu_check(idElementCurr != NULL && idElementCurr->handle == 0);
+	mu_check(handleIdElement(restoredIdStack, 1) == NULL);
+	mu_check(registered != NULL && strcmp(registered->name, "PRESSURE") == 0 && searchIdHandle(restoredIdStack, "PRESSURE") == 2);
+	mu_check(idElementCurr->dataNumber == 900 && idElementCurr->startTime == 1100 && idElementCurr->timeInterval == 10);
+	mu_check(idElementCurr->priority == 3 && idElementCurr->signalType == VOLTAGE && idElementCurr->dataType == FLOAT);
+	mu_check(registered->dataNumber == 1000);
+	mu_check(idElementMemory(registered) == idElementMemory(handleIdElement(restoredIdStack, 2)) && restoredIdStack->memoryUsed < 1024);
+
+	/*New data are pushed over the mapped ones, then popped across both*/
+	for(int i = 1000; i<1100; i++){
+		dataIdStackPush(restoredIdStack, MCU_CURR, &aFloat[i%9]);
+	}
+	floatP = dataIdStackPop(restoredIdStack, MCU_CURR, 100+499*10);
+	for(int i = 0; i<400; i++){
+		mu_check(floatP[i] == aFloat[(i+100)%9]);
+	}
+	free(floatP);
+	floatP = dataIdStackPop(restoredIdStack, MCU_CURR, 100+1099*10);
+	mu_check(idElementCurr->dataNumber == 0);
+	for(int i = 0; i<600; i++){
+		mu_check(floatP[i] == aFloat[(i+500)%9]);
+	}
+	free(floatP);
+	doubleP = dataHandlePop(restoredIdStack, registered->handle, 999);
+	for(int i = 0; i<1000; i++){
+		mu_check(doubleP[i] == aDouble[i%6]);
+	}
+	free(doubleP);
+
+	/*A restored IdStack can be saved again over its own file*/
+	for(int i = 0; i<10; i++){
+		dataHandlePush(restoredIdStack, registered->handle, &aDouble[i%6]);
+	}
+	mu_check(idStackSnapshot(restoredIdStack, path) == 0);
+	idDeinitialize(restoredIdStack);
+	restoredIdStack = idRestore(path);
+	mu_check(restoredIdStack != NULL && handleIdElement(restoredIdStack, 2)->dataNumber == 10);
+	/*The mapped data free no memory : a budget evicts them with the oldest pushed data*/
+	registered = handleIdElement(restoredIdStack, 2);
+	for(int i = 0; i<200; i++){
+		dataHandlePush(restoredIdStack, registered->handle, &aDouble[i%6]);
+	}
+	idStackSetBudget(restoredIdStack, restoredIdStack->memoryUsed*3/4, NULL, NULL);
+	mu_check(restoredIdStack->memoryUsed <= restoredIdStack->memoryBudget && registered->dataStack->baseNumber == 0);
+	mu_check(registered->dataNumber > 100 && registered->dataNumber < 200);
+	idDeinitialize(restoredIdStack);
+	remove(path);
+	mu_check(idRestore(path) == NULL);
+}
+
+MU_TEST(test_irregularIdStack) {
+	const char* path = "/tmp/idStackIrregular.bin";
+	IdStack* irregularIdStack = idInitialize();
+	IdElement* events = idStackRegister(irregularIdStack, "EVENTS",OTHER_TYPE,FLOAT,0,1);
+	unsigned int times[3000], number, *poppedTimes;
+	unsigned int time = 1000;
+	mu_check(idElementIrregular(irregularIdStack, events) == 0);
+	mu_check(dataHandlePush(irregularIdStack, events->handle, &aFloat[0]) == NULL);
+	for(int i = 0; i<3000; i++){
+		/*Jitter, bursts of equal times and some long gaps*/
+		time += (i%100 == 0) ? 100000 : (i%7 == 0) ? 0 : 10 + (i*13)%5;
+		times[i] = time;
+		mu_check(dataHandlePushTime(irregularIdStack, events->handle, time, &aFloat[i%9]) == events);
+	}
+	mu_check(dataHandlePushTime(irregularIdStack, events->handle, time-1, &aFloat[0]) == NULL);
+	mu_check(events->dataNumber == 3000 && events->startTime == times[0]);
+	mu_check(events->timeStack->memory < 3000*(sizeof(float)+2));
+
+	/*Any range can be read, its bounds don't need to be times of data*/
+	floatP = dataHandleReadTime(irregularIdStack, events->handle, times[500]-1, times[2200], &number, &poppedTimes);
+	unsigned int first = 500;
+	while (first > 0 && times[first-1] >= times[500]-1) first--;
+	unsigned int last = 2200;
+	while (last < 2999 && times[last+1] == times[2200]) last++;
+	mu_check(number == last-first+1);
+	for(unsigned int i = 0; i<number; i++){
+		mu_check(poppedTimes[i] == times[first+i] && floatP[i] == aFloat[(first+i)%9]);
+	}
+	free(floatP);
+	free(poppedTimes);
+	mu_check(dataHandleReadTime(irregularIdStack, events->handle, times[2999]+1, ~0u, &number, NULL) == NULL && number == 0);
+
+	/*Pops from the oldest data*/
+	floatP = dataHandlePopTime(irregularIdStack, events->handle, times[999], &number, &poppedTimes);
+	while (times[number-1] == times[999] && number < 1000) number++;
+	mu_check(poppedTimes[0] == times[0] && floatP[0] == aFloat[0]);
+	mu_check(events->dataNumber == 3000-number && events->startTime == times[number]);
+	free(floatP);
+	free(poppedTimes);
+	floatP = dataHandlePopTime(irregularIdStack, events->handle, times[999], &number, NULL);
+	mu_check(floatP == NULL && number == 0);
+
+	/*Snapshot and restore, the quota isn't applied while the data are copied*/
+	unsigned int dataNumber = events->dataNumber;
+	events->quota = 1000;
+	mu_check(idStackSnapshot(irregularIdStack, path) == 0);
+	idDeinitialize(irregularIdStack);
+	irregularIdStack = idRestore(path);
+	remove(path);
+	events = handleIdElement(irregularIdStack, 0);
+	mu_check(events != NULL && events->timeStack != NULL && events->dataNumber == dataNumber && events->quota == 1000);
+	events->quota = 0;
+	floatP = dataHandlePopTime(irregularIdStack, events->handle, ~0u, &number, &poppedTimes);
+	mu_check(number == dataNumber && poppedTimes[number-1] == times[2999] && floatP[number-1] == aFloat[2999%9]);
+	mu_check(events->dataNumber == 0);
+	free(floatP);
+	free(poppedTimes);
+
+	/*The budget evicts the oldest data of irregular channels too*/
+	size_t budget = irregularIdStack->memoryUsed + 4000;
+	idStackSetBudget(irregularIdStack, budget, NULL, NULL);
+	for(int i = 0; i<10000; i++){
+		mu_check(dataHandlePushTime(irregularIdStack, events->handle, 5000000+i, &aFloat[i%9]) != NULL);
+		mu_check(irregularIdStack->memoryUsed <= budget);
+	}
+	mu_check(events->dataNumber > 0 && events->dataNumber < 10000 && events->startTime == 5000000+10000-events->dataNumber);
+	idDeinitialize(irregularIdStack);
+
+	/*In concurrent mode, the irregular channels can't be produced*/
+	irregularIdStack = idInitialize();
+	events = idStackRegister(irregularIdStack, "EVENTS",OTHER_TYPE,FLOAT,0,1);
+	IdElement* samples = idStackRegister(irregularIdStack, "SAMPLES",OTHER_TYPE,FLOAT,0,1);
+	mu_check(idElementIrregular(irregularIdStack, events) == 0);
+	mu_check(idStackConcurrent(irregularIdStack, 16) == 0 && events->ring == NULL);
+	mu_check(dataHandleProduce(irregularIdStack, events->handle, &aFloat[0]) == -1);
+	mu_check(dataHandleProduce(irregularIdStack, samples->handle, &aFloat[0]) == 0);
+	idStackDrain(irregularIdStack);
+	float* popped = dataHandlePop(irregularIdStack, samples->handle, 0);
+	mu_check(popped != NULL && popped[0] == aFloat[0]);
+	free(popped);
+	mu_check(idElementIrregular(irregularIdStack, samples) == 0);
+	mu_check(dataHandleProduce(irregularIdStack, samples->handle, &aFloat[0]) == -1);
+	idDeinitialize(irregularIdStack);
+}
+
+MU_TEST(test_gapIdStack) {
+	const char* path = "/tmp/idStackGap.bin";
+	IdStack* gapIdStack = idInitialize();
+	IdElement* sensor = idStackRegister(gapIdStack, "SENSOR",OTHER_TYPE,FLOAT,100,10);
+	IdSegment segments[4];
+	unsigned int handle = sensor->handle;
+	/*Segments of 5, 3 and 4 data, the sensor missed 2 then 6 data*/
+	for(int i = 0; i<5; i++) dataHandlePush(gapIdStack, handle, &aFloat[i]);
+	mu_check(dataHandleSkip(gapIdStack, handle, 2) == sensor);
+	for(int i = 5; i<8; i++) dataHandlePush(gapIdStack, handle, &aFloat[i]);
+	mu_check(dataHandleSkip(gapIdStack, handle, 4) == sensor && dataHandleSkip(gapIdStack, handle, 2) == sensor);
+	for(int i = 0; i<4; i++) dataHandlePush(gapIdStack, handle, &aFloat[i]);
+	mu_check(sensor->dataNumber == 12 && sensor->segmentNumber == 3);
+	mu_check(idElementSegments(sensor, 0, ~0u, segments, 4) == 3);
+	mu_check(segments[1].startTime == 170 && segments[1].dataNumber == 3 && segments[2].startTime == 260 && segments[2].dataNumber == 4);
+	mu_check(idElementSegments(sensor, 125, 175, segments, 4) == 2);
+	mu_check(segments[0].startTime == 130 && segments[0].dataNumber == 2 && segments[1].startTime == 170 && segments[1].dataNumber == 1);
+	mu_check(idElementSegments(sensor, 150, 160, segments, 4) == 0);
+
+	/*Snapshot and restore keep the segments*/
+	mu_check(idStackSnapshot(gapIdStack, path) == 0);
+	idDeinitialize(gapIdStack);
+	gapIdStack = idRestore(path);
+	remove(path);
+	sensor = handleIdElement(gapIdStack, handle);
+	mu_check(sensor != NULL && sensor->dataNumber == 12 && sensor->segmentNumber == 3);
+
+	/*A pop inside a gap stops at the end of the previous segment*/
+	floatP = dataHandlePop(gapIdStack, handle, 180);
+	mu_check(floatP[4] == aFloat[4] && floatP[5] == aFloat[5] && floatP[6] == aFloat[6]);
+	mu_check(sensor->dataNumber == 5 && sensor->startTime == 190 && sensor->segmentNumber == 2);
+	free(floatP);
+	floatP = dataHandlePop(gapIdStack, handle, 250);
+	mu_check(floatP[0] == aFloat[7] && sensor->dataNumber == 4 && sensor->startTime == 260 && sensor->segmentNumber == 0);
+	free(floatP);
+	dataHandlePush(gapIdStack, handle, &aFloat[4]);
+	floatP = dataHandlePop(gapIdStack, handle, 300);
+	mu_check(floatP[4] == aFloat[4] && sensor->dataNumber == 0 && sensor->startTime == 310);
+	free(floatP);
+
+	/*fftPush doesn't compress the gaps : the short segment is padded in its own bloc*/
+	FftStack* gapFftStack = fftInitialize();
+	IdElement* current = idStackPush(gapIdStack, MCU_CURR,OTHER_TYPE,FLOAT,0,1);
+	initializeFftElement(gapFftStack, MCU_CURR, 8);
+	for(int i = 0; i<12; i++) dataIdStackPush(gapIdStack, MCU_CURR, &aFloat[i%9]);
+	dataIdStackSkip(gapIdStack, MCU_CURR, 100);
+	for(int i = 0; i<16; i++) dataIdStackPush(gapIdStack, MCU_CURR, &aFloat[i%9]);
+	FftElement* fftElement = fftPush(gapFftStack, gapIdStack, MCU_CURR, ~0u);
+	mu_check(fftElement != NULL && fftElement->dataNumber == 4 && current->dataNumber == 0);
+	mu_check(fftElement->blocs[fftElement->firstBloc+1].dataNumber == 4 && fftElement->blocs[fftElement->firstBloc+2].startTime == 112);
+	float* low = fftLow(aFloat,8);
+	mu_check(memcmp(fftElement->low + fftElement->firstBloc*fftElement->sizeCompressedL,low,fftElement->sizeCompressedL*sizeof(float)) == 0);
+	free(low);
+	mu_check(blocNumberCount(fftElement, 0, 127) == 4);
+	float* compressed = fftPop(gapFftStack, MCU_CURR, 0, 127, ERASE, ALL);
+	mu_check(compressed[1] == 2 && compressed[3] == 0 && compressed[5] == 4);
+	free(compressed);
+	mu_check(fftElement->startTime == 112 && fftElement->dataNumber == 2);
+	compressed = fftPop(gapFftStack, MCU_CURR, 0, 127, ERASE, LOW);
+	mu_check(compressed[1] == 2 && compressed[3] == 112 && compressed[5] == 8);
+	free(compressed);
+	fftDeinitialize(gapFftStack);
+	idDeinitialize(gapIdStack);
+}
+
+MU_TEST(test_realFft) {
+	float data[33];
+	for(unsigned int i = 0; i<33; i++) data[i] = aFloat[i%9] + (float)(i%4);
+	/*Even sizes use a real FFT, odd sizes a complex one : both give the frequencies 0 to size/2 of the DFT*/
+	for(unsigned int size = 1; size<=33; size++){
+		float* all = fftAll(data,size);
+		for(unsigned int m = 0; m<=size/2; m++){
+			double re = 0, im = 0;
+			for(unsigned int k = 0; k<size; k++){
+				re += data[k]*cos(2*M_PI*m*k/size);
+				im -= data[k]*sin(2*M_PI*m*k/size);
+			}
+			mu_check(fabs(all[m]-re) < 1e-4 && fabs(all[m+size/2+1]-im) < 1e-4);
+		}
+		float* low = fftLow(data,size);
+		float* high = fftHigh(data,size);
+		float *splitLow, *splitHigh;
+		mu_check(fftSplit(data,size,&splitLow,&splitHigh) == 0);
+		mu_check(memcmp(low,splitLow,(((size+2)/2)+((size+2)/2)%2)*sizeof(float)) == 0);
+		mu_check(memcmp(high,splitHigh,((size/2)+(size/2)%2)*sizeof(float)) == 0);
+		free(splitLow);free(splitHigh);
+		float* dataAll = ifftAll(all,size);
+		float* dataLow = ifftLow(low,size);
+		float* dataHigh = ifftHigh(high,size);
+		for(unsigned int i = 0; i<size; i++){
+			mu_check(fabs(dataAll[i]-data[i]) < 1e-4);
+			if (size > 1)
+				mu_check(fabs(dataLow[i]+dataHigh[i]-data[i]) < 1e-4);
+		}
+		free(all);free(low);free(high);free(dataAll);free(dataLow);free(dataHigh);
+	}
+	/*The batch gives the arrays of fftLow and fftHigh, bloc after bloc*/
+	float batchLow[3*6], batchHigh[3*6];
+	mu_check(fftSplitBatch(data,10,3,batchLow,batchHigh) == 0);
+	for(unsigned int j = 0; j<3; j++){
+		float* low = fftLow(data+10*j,10);
+		float* high = fftHigh(data+10*j,10);
+		mu_check(memcmp(low,batchLow+6*j,6*sizeof(float)) == 0 && memcmp(high,batchHigh+6*j,6*sizeof(float)) == 0);
+		free(low);free(high);
+	}
+}
+
+typedef struct PlanThread PlanThread;
+struct PlanThread
+{
+	unsigned int size;
+	int failures;
+};
+
+static void* planThread(void* parameter)
+{
+	PlanThread* planThread = parameter;
+	float data[64], *expected = NULL;
+	for(unsigned int i = 0; i<64; i++) data[i] = aFloat[i%9];
+	for(int r = 0; r<200; r++){
+		unsigned int size = planThread->size + r%3;
+		float* all = fftAll(data,size);
+		float* dataAll = ifftAll(all,size);
+		for(unsigned int i = 0; i<size; i++)
+			planThread->failures += fabs(dataAll[i]-data[i]) > 1e-4;
+		if (r%3 == 0 && expected != NULL)
+			planThread->failures += memcmp(all,expected,(2*(size/2)+2)*sizeof(float)) != 0;
+		if (r == 0) expected = all;
+		else free(all);
+		free(dataAll);
+	}
+	free(expected);
+	return NULL;
+}
+
+MU_TEST(test_planCache) {
+	pthread_t threads[8];
+	PlanThread planThreads[8];
+	/*Threads share the cache with sizes overlapping, the cache stays bounded*/
+	for(unsigned int i = 0; i<8; i++){
+		planThreads[i].size = 8 + 2*i;
+		planThreads[i].failures = 0;
+		pthread_create(&threads[i], NULL, planThread, &planThreads[i]);
+	}
+	for(unsigned int i = 0; i<8; i++){
+		pthread_join(threads[i], NULL);
+		mu_check(planThreads[i].failures == 0);
+	}
+	int planNumber = fftPlanCleanup();
+	mu_check(planNumber > 0 && planNumber <= FFT_PLAN_CACHE_SIZE);
+	mu_check(fftPlanCleanup() == 0);
+}
+
+MU_TEST(test_parallelFftPush) {
+	Id_type ids[4] = {MCU_CURR,TEST1,TEST2,TEST3};
+	IdStack* idStacks[2];
+	FftStack* fftStacks[2];
+	/*The same channels compressed by fftPush and by fftPushParallel with 4 threads*/
+	for(int k = 0; k<2; k++){
+		idStacks[k] = idInitialize();
+		fftStacks[k] = fftInitialize();
+		for(unsigned int c = 0; c<4; c++){
+			idStackPush(idStacks[k], ids[c],OTHER_TYPE,FLOAT,0,2);
+			initializeFftElement(fftStacks[k], ids[c], 8+c);
+			for(unsigned int i = 0; i<700+100*c; i++){
+				float value = aFloat[(i+c)%9]*(float)(i%13);
+				dataIdStackPush(idStacks[k], ids[c], &value);
+				if (i == 300) dataIdStackSkip(idStacks[k], ids[c], 5);
+			}
+		}
+	}
+	int nbBlocs = 0;
+	for(unsigned int c = 0; c<4; c++){
+		FftElement* fftElement = fftPush(fftStacks[0], idStacks[0], ids[c], 1500);
+		nbBlocs += fftElement->dataNumber;
+	}
+	mu_check(fftPushParallel(fftStacks[1], idStacks[1], ids, 4, 1500, 4) == nbBlocs);
+	for(unsigned int c = 0; c<4; c++){
+		FftElement* serial = searchFftElement(fftStacks[0], ids[c]);
+		FftElement* parallel = searchFftElement(fftStacks[1], ids[c]);
+		mu_check(serial->dataNumber == parallel->dataNumber && serial->startTime == parallel->startTime);
+		mu_check(searchIdElement(idStacks[0], ids[c])->dataNumber == searchIdElement(idStacks[1], ids[c])->dataNumber);
+		for(unsigned int k = 0; k<serial->dataNumber; k++){
+			FftBloc *serialBloc = &serial->blocs[serial->firstBloc+k], *parallelBloc = &parallel->blocs[parallel->firstBloc+k];
+			mu_check(serialBloc->startTime == parallelBloc->startTime && serialBloc->dataNumber == parallelBloc->dataNumber);
+		}
+		mu_check(memcmp(serial->low + serial->firstBloc*serial->sizeCompressedL,parallel->low + parallel->firstBloc*serial->sizeCompressedL,serial->dataNumber*serial->sizeCompressedL*sizeof(float)) == 0);
+		mu_check(memcmp(serial->high + serial->firstBloc*serial->sizeCompressedH,parallel->high + parallel->firstBloc*serial->sizeCompressedH,serial->dataNumber*serial->sizeCompressedH*sizeof(float)) == 0);
+	}
+	for(int k = 0; k<2; k++){
+		fftDeinitialize(fftStacks[k]);
+		idDeinitialize(idStacks[k]);
+	}
+}
+
+MU_TEST(test_fftPopInto) {
+	IdStack* popIdStack = idInitialize();
+	FftStack* popFftStack = fftInitialize();
+	idStackPush(popIdStack, MCU_CURR,OTHER_TYPE,FLOAT,0,1);
+	initializeFftElement(popFftStack, MCU_CURR, 8);
+	for(int i = 0; i<64; i++){
+		float value = aFloat[i%9]*(float)(i%5);
+		dataIdStackPush(popIdStack, MCU_CURR, &value);
+	}
+	FftElement* fftElement = fftPush(popFftStack, popIdStack, MCU_CURR, ~0u);
+	mu_check(fftElement != NULL && fftElement->dataNumber == 8);
+	/*The buffer of a frame doesn't need to be aligned*/
+	char frame[1024];
+	Fft_type types[5] = {ALL,LOW,HIGH,ADAPTIVE,DCT};
+	fftSetErrorBound(popFftStack, MCU_CURR, TOP_K, RMS_ERROR, 0.2f);
+	for(int t = 0; t<5; t++){
+		long size = fftPopSize(popFftStack, MCU_CURR, 16, 40, KEEP, types[t]);
+		mu_check(size > 0 && size + 1 <= (long)sizeof(frame));
+		float* compressed = fftPop(popFftStack, MCU_CURR, 16, 40, KEEP, types[t]);
+		mu_check(fftPopInto(popFftStack, MCU_CURR, 16, 40, KEEP, types[t], frame+1, size) == size);
+		mu_check(memcmp(frame+1, compressed, size) == 0);
+		free(compressed);
+	}
+	/*A too small buffer pops nothing, the ADAPTIVE and DCT blocs are checked while they are written*/
+	for(int t = 3; t<5; t++){
+		long size = fftPopSize(popFftStack, MCU_CURR, 0, 63, ERASE, types[t]);
+		mu_check(fftPopInto(popFftStack, MCU_CURR, 0, 63, ERASE, types[t], frame, size-1) == -1 && fftElement->dataNumber == 8);
+	}
+	long size = fftPopSize(popFftStack, MCU_CURR, 0, 63, ERASE, LOW);
+	mu_check(fftPopInto(popFftStack, MCU_CURR, 0, 63, ERASE, LOW, frame, size-1) == -1 && fftElement->dataNumber == 8);
+	mu_check(fftPopInto(popFftStack, MCU_CURR, 0, 31, ERASE, LOW, frame, sizeof(frame)) == (long)((FFT_POP_PARAM+4*fftElement->sizeCompressedL)*sizeof(float)));
+	mu_check(fftElement->dataNumber == 4 && fftElement->startTime == 32);
+	mu_check(fftPopSize(popFftStack, MCU_CURR, 0, 63, ERASE, LOW) == size - (long)(4*fftElement->sizeCompressedL*sizeof(float)));
+	fftDeinitialize(popFftStack);
+	idDeinitialize(popIdStack);
+}
+
+typedef struct DecodeSink DecodeSink;
+struct DecodeSink
+{
+	unsigned int blocs;
+	unsigned int number;
+	unsigned int lastTime;
+};
+
+static int decodeSink(unsigned int startTime, unsigned int timeInterval, float* values, unsigned int number, void* context)
+{
+	DecodeSink* decodeSink = (DecodeSink*)context;
+	(void)values;
+	decodeSink->blocs++;
+	decodeSink->number += number;
+	decodeSink->lastTime = startTime + (number-1)*timeInterval;
+	return decodeSink->blocs == 2;
+}
+
+MU_TEST(test_ifftDecode) {
+	IdStack* decodeIdStack = idInitialize();
+	FftStack* decodeFftStack = fftInitialize();
+	idStackPush(decodeIdStack, MCU_CURR,OTHER_TYPE,FLOAT,0,2);
+	initializeFftElement(decodeFftStack, MCU_CURR, 16);
+	float data[60];
+	for(int i = 0; i<60; i++){
+		data[i] = aFloat[i%9]*(float)(i%7);
+		dataIdStackPush(decodeIdStack, MCU_CURR, &data[i]);
+	}
+	/*A gap after 60 data : the last bloc is padded*/
+	dataIdStackSkip(decodeIdStack, MCU_CURR, 3);
+	fftPush(decodeFftStack, decodeIdStack, MCU_CURR, ~0u);
+	float* all = fftPop(decodeFftStack, MCU_CURR, 0, 118, KEEP, ALL);
+	float* low = fftPop(decodeFftStack, MCU_CURR, 0, 118, KEEP, LOW);
+	float* high = fftPop(decodeFftStack, MCU_CURR, 0, 118, KEEP, HIGH);
+	mu_check(ifftSize(all) == 60 && ifftSize(low) == 60);
+	unsigned int times[60];
+	float values[60], valuesLow[60], valuesHigh[60];
+	mu_check(ifftDecode(all, times, values, 59) == -1);
+	mu_check(ifftDecode(all, times, values, 60) == 60);
+	mu_check(ifftDecode(low, NULL, valuesLow, 60) == 60 && ifftDecode(high, NULL, valuesHigh, 60) == 60);
+	for(int i = 0; i<60; i++){
+		mu_check(times[i] == 2*(unsigned int)i);
+		mu_check(fabs(values[i]-data[i]) < 1e-3);
+		mu_check(fabs(valuesLow[i]+valuesHigh[i]-data[i]) < 1e-3);
+	}
+	/*The sink stops the decoding after the second bloc*/
+	DecodeSink sink = {0,0,0};
+	mu_check(ifftStream(all, decodeSink, &sink) == 2 && sink.number == 32 && sink.lastTime == 62);
+	sink.blocs = 2;
+	sink.number = 0;
+	mu_check(ifftStream(all, decodeSink, &sink) == 4 && sink.number == 60 && sink.lastTime == 118);
+	free(low);
+	free(high);
+	ifft(all);
+	fftDeinitialize(decodeFftStack);
+	idDeinitialize(decodeIdStack);
+}
+
+typedef struct LargeBloc LargeBloc;
+struct LargeBloc
+{
+	unsigned int size;
+	int failures;
+};
+
+static void* largeBlocThread(void* parameter)
+{
+	LargeBloc* largeBloc = (LargeBloc*)parameter;
+	unsigned int size = largeBloc->size;
+	float* data = (float*)malloc(size*sizeof(float));
+	float *low, *high;
+	for(unsigned int i = 0; i<size; i++) data[i] = aFloat[i%9]*(float)(i%11);
+	if (fftSplit(data, size, &low, &high) != 0)
+	{
+		largeBloc->failures++;
+		free(data);
+		return NULL;
+	}
+	float* dataLow = ifftLow(low, size);
+	float* dataHigh = ifftHigh(high, size);
+	for(unsigned int i = 0; i<size; i++)
+		largeBloc->failures += fabs(dataLow[i]+dataHigh[i]-data[i]) > 1e-2;
+	free(data);
+	free(low);
+	free(high);
+	free(dataLow);
+	free(dataHigh);
+	return NULL;
+}
+
+MU_TEST(test_fftWorkspace) {
+	/*A workspace given back is reused by the next transform of its size*/
+	fftPlanCleanup();
+	FftWorkspace* workspace = fftWorkspaceAcquire(64, 1);
+	mu_check(workspace != NULL && fftWorkspaceAcquire(0, 1) == NULL);
+	fftWorkspaceRelease(workspace);
+	mu_check(fftWorkspaceAcquire(64, 1) == workspace);
+	float low[34] = {0}, dataOut[64];
+	low[0] = 64;
+	mu_check(ifftBloc(workspace, low, NULL, dataOut) == 0 && fabs(dataOut[0]-1) < 1e-6 && fabs(dataOut[63]-1) < 1e-6);
+	fftWorkspaceRelease(workspace);
+	FftWorkspace* forward = fftWorkspaceAcquire(64, 0);
+	mu_check(forward != workspace && ifftBloc(forward, low, NULL, dataOut) == -1);
+	fftWorkspaceRelease(forward);
+	mu_check(fftPlanCleanup() == 2);
+
+	/*Blocs of 128k data (even and odd sizes) in a thread with a 256 KB stack*/
+	pthread_attr_t attr;
+	pthread_attr_init(&attr);
+	pthread_attr_setstacksize(&attr, 256*1024);
+	LargeBloc largeBlocs[2] = {{1u<<17,0},{177147,0}};
+	for(int k = 0; k<2; k++){
+		pthread_t thread;
+		mu_check(pthread_create(&thread, &attr, largeBlocThread, &largeBlocs[k]) == 0);
+		pthread_join(thread, NULL);
+		mu_check(largeBlocs[k].failures == 0);
+	}
+	pthread_attr_destroy(&attr);
+	fftPlanCleanup();
+}
+
+MU_TEST(test_adaptiveFft) {
+	IdStack* adaptiveIdStack = idInitialize();
+	FftStack* adaptiveFftStack = fftInitialize();
+	float smooth[1024], noisy[1024];
+	unsigned int seed = 7;
+	idStackPush(adaptiveIdStack, MCU_CURR,OTHER_TYPE,FLOAT,0,1);
+	idStackPush(adaptiveIdStack, TEST1,OTHER_TYPE,FLOAT,0,1);
+	initializeFftElement(adaptiveFftStack, MCU_CURR, 256);
+	initializeFftElement(adaptiveFftStack, TEST1, 256);
+	for(int i = 0; i<1024; i++){
+		seed = seed*1103515245u + 12345u;
+		smooth[i] = (float)(sin(2*M_PI*i/64) + 0.5*sin(2*M_PI*i/32));
+		noisy[i] = (float)((seed >> 16)%1000)/100.f;
+		dataIdStackPush(adaptiveIdStack, MCU_CURR, &smooth[i]);
+		dataIdStackPush(adaptiveIdStack, TEST1, &noisy[i]);
+	}
+	fftPush(adaptiveFftStack, adaptiveIdStack, MCU_CURR, ~0u);
+	fftPush(adaptiveFftStack, adaptiveIdStack, TEST1, ~0u);
+	mu_check(fftSetErrorBound(adaptiveFftStack, MCU_CURR, TOP_K, RMS_ERROR, -1.f) == -1);
+	Id_type ids[2] = {MCU_CURR,TEST1};
+	float* signals[2] = {smooth,noisy};
+	Select_mode selections[2] = {TOP_K,BAND};
+	Error_type errorTypes[2] = {RMS_ERROR,MAX_ERROR};
+	float values[1024];
+	for(int c = 0; c<2; c++){
+		long allSize = fftPopSize(adaptiveFftStack, ids[c], 0, 1023, KEEP, ALL);
+		for(int m = 0; m<2; m++){
+			float bound = 0.05f;
+			mu_check(fftSetErrorBound(adaptiveFftStack, ids[c], selections[m], errorTypes[m], bound) == 0);
+			long size = fftPopSize(adaptiveFftStack, ids[c], 0, 1023, KEEP, ADAPTIVE);
+			float* compressed = fftPop(adaptiveFftStack, ids[c], 0, 1023, KEEP, ADAPTIVE);
+			mu_check(size > 0 && compressed != NULL && compressed[0] == ADAPTIVE);
+			/*The sines of the smooth channel are kept with their 2 frequencies*/
+			if (c == 0)
+				mu_check(allSize > 10*size);
+			mu_check(ifftDecode(compressed, NULL, values, 1024) == 1024);
+			for(int b = 0; b<4; b++){
+				double square = 0, max = 0;
+				for(int i = 256*b; i<256*(b+1); i++){
+					double error = fabs(values[i]-signals[c][i]);
+					square += error*error;
+					max = (error > max) ? error : max;
+				}
+				mu_check(((errorTypes[m] == RMS_ERROR) ? sqrt(square/256) : max) <= bound + 1e-4);
+			}
+			free(compressed);
+		}
+	}
+	/*A bound of 0 keeps every frequency of the noisy channel*/
+	mu_check(fftSetErrorBound(adaptiveFftStack, TEST1, TOP_K, RMS_ERROR, 0.f) == 0);
+	float* compressed = fftPop(adaptiveFftStack, TEST1, 0, 1023, ERASE, ADAPTIVE);
+	mu_check(ifftDecode(compressed, NULL, values, 1024) == 1024);
+	for(int i = 0; i<1024; i++) mu_check(fabs(values[i]-noisy[i]) < 1e-3);
+	free(compressed);
+	fftDeinitialize(adaptiveFftStack);
+	idDeinitialize(adaptiveIdStack);
+}
+
+MU_TEST(test_quantizedFft) {
+	/*Quantization of values over several chunks into an unaligned buffer*/
+	unsigned int number = 2*FFT_QUANTIZE_CHUNK+17, seed = 3;
+	float* in = (float*)malloc(number*sizeof(float));
+	float* out = (float*)malloc(number*sizeof(float));
+	char* buffer = (char*)malloc(number*sizeof(float)+16);
+	for(unsigned int i = 0; i<number; i++){
+		seed = seed*1103515245u + 12345u;
+		in[i] = (float)((seed >> 16)%2000)/10.f - 100.f;
+	}
+	unsigned int bits[2] = {8,16};
+	for(int b = 0; b<2; b++){
+		int words = fftQuantize(in, number, bits[b], buffer+1);
+		mu_check(words == (int)fftQuantizeWords(number, bits[b]) && words == 2+(int)(number*bits[b]/8+3)/4);
+		mu_check(fftDequantize(buffer+1, number, bits[b], out) == words);
+		float scale = 200.f/((bits[b] == 8) ? 255.f : 65535.f);
+		for(unsigned int i = 0; i<number; i++) mu_check(fabs(out[i]-in[i]) <= 0.51f*scale + 1e-4f);
+	}
+	mu_check(fftQuantize(in, number, 12, buffer) == -1);
+	free(in);
+	free(out);
+	free(buffer);
+
+	/*The popped arrays of a channel with 32, 16 and 8 bits coefficients*/
+	IdStack* quantizedIdStack = idInitialize();
+	FftStack* quantizedFftStack = fftInitialize();
+	idStackPush(quantizedIdStack, MCU_CURR,OTHER_TYPE,FLOAT,0,1);
+	initializeFftElement(quantizedFftStack, MCU_CURR, 64);
+	float data[500];
+	for(int i = 0; i<500; i++){
+		data[i] = (float)(10*sin(i/20.) + aFloat[i%9]);
+		dataIdStackPush(quantizedIdStack, MCU_CURR, &data[i]);
+	}
+	/*A gap : the last bloc is padded*/
+	dataIdStackSkip(quantizedIdStack, MCU_CURR, 5);
+	fftPush(quantizedFftStack, quantizedIdStack, MCU_CURR, ~0u);
+	mu_check(fftSetQuantization(quantizedFftStack, MCU_CURR, 4) == -1);
+	unsigned int allBits[3] = {32,16,8};
+	Fft_type types[3] = {ALL,ADAPTIVE,DCT};
+	float values[500];
+	for(int t = 0; t<3; t++){
+		long sizes[3];
+		for(int b = 0; b<3; b++){
+			mu_check(fftSetQuantization(quantizedFftStack, MCU_CURR, allBits[b]) == 0);
+			sizes[b] = fftPopSize(quantizedFftStack, MCU_CURR, 0, 499, KEEP, types[t]);
+			float* compressed = fftPop(quantizedFftStack, MCU_CURR, 0, 499, KEEP, types[t]);
+			mu_check(compressed != NULL && compressed[6] == allBits[b]);
+			mu_check(ifftDecode(compressed, NULL, values, 500) == 500);
+			double maxError = 0;
+			for(int i = 0; i<500; i++) maxError = fmax(maxError, fabs(values[i]-data[i]));
+			mu_check(maxError < ((allBits[b] == 32) ? 1e-3 : (allBits[b] == 16) ? 1e-2 : 0.5));
+			DecodeSink sink = {0,0,0};
+			mu_check(ifftStream(compressed, decodeSink, &sink) == 2);
+			free(compressed);
+		}
+		mu_check(sizes[1] < sizes[0]*6/10 && sizes[2] < sizes[1]*6/10);
+	}
+	/*The error bound of the ADAPTIVE and DCT pops includes the error of the 8 bits coefficients*/
+	Error_type errorTypes[2] = {RMS_ERROR,MAX_ERROR};
+	float bounds[2] = {0.3f,1.f};
+	for(int t = 1; t<3; t++){
+		for(int m = 0; m<2; m++){
+			mu_check(fftSetErrorBound(quantizedFftStack, MCU_CURR, TOP_K, errorTypes[m], bounds[m]) == 0);
+			float* compressed = fftPop(quantizedFftStack, MCU_CURR, 0, 499, KEEP, types[t]);
+			mu_check(compressed != NULL && ifftDecode(compressed, NULL, values, 500) == 500);
+			for(int b = 0; b<7; b++){
+				double square = 0, max = 0;
+				for(int i = 64*b; i<64*(b+1); i++){
+					double error = fabs(values[i]-data[i]);
+					square += error*error;
+					max = (error > max) ? error : max;
+				}
+				mu_check(((errorTypes[m] == RMS_ERROR) ? sqrt(square/64) : max) <= bounds[m]);
+			}
+			free(compressed);
+		}
+	}
+	fftDeinitialize(quantizedFftStack);
+	idDeinitialize(quantizedIdStack);
+}
+
+MU_TEST(test_dctFft) {
+	/*The DCT-II of an even and an odd bloc against its definition, and back*/
+	unsigned int sizes[2] = {16,15};
+	float data[16], coefficients[16], values[16];
+	for(int s = 0; s<2; s++){
+		unsigned int n = sizes[s];
+		FftWorkspace* forward = fftWorkspaceAcquire(n, 0);
+		FftWorkspace* inverse = fftWorkspaceAcquire(n, 1);
+		for(unsigned int i = 0; i<n; i++) data[i] = (float)(i*i%7) - 0.3f*i;
+		mu_check(dctBloc(forward, data, coefficients) == 0);
+		for(unsigned int k = 0; k<n; k++){
+			double sum = 0;
+			for(unsigned int i = 0; i<n; i++) sum += data[i]*cos(M_PI*(2*i+1)*k/(2*n));
+			mu_check(fabs(coefficients[k] - sqrt((k == 0) ? 1./n : 2./n)*sum) < 1e-4);
+		}
+		mu_check(idctBloc(inverse, coefficients, values) == 0);
+		for(unsigned int i = 0; i<n; i++) mu_check(fabs(values[i]-data[i]) < 1e-4);
+		fftWorkspaceRelease(forward);
+		fftWorkspaceRelease(inverse);
+	}
+	/*A ramp : its ends don't meet, so the DCT needs less coefficients than the FFT*/
+	IdStack* dctIdStack = idInitialize();
+	FftStack* dctFftStack = fftInitialize();
+	idStackPush(dctIdStack, MCU_CURR,OTHER_TYPE,FLOAT,0,1);
+	initializeFftElement(dctFftStack, MCU_CURR, 128);
+	float ramp[512], decoded[512];
+	for(int i = 0; i<512; i++){
+		ramp[i] = (float)(0.02*i + 0.3*sin(i/40.));
+		dataIdStackPush(dctIdStack, MCU_CURR, &ramp[i]);
+	}
+	fftPush(dctFftStack, dctIdStack, MCU_CURR, ~0u);
+	Error_type errorTypes[2] = {RMS_ERROR,MAX_ERROR};
+	for(int m = 0; m<2; m++){
+		float bound = 0.02f;
+		mu_check(fftSetErrorBound(dctFftStack, MCU_CURR, TOP_K, errorTypes[m], bound) == 0);
+		long adaptiveSize = fftPopSize(dctFftStack, MCU_CURR, 0, 511, KEEP, ADAPTIVE);
+		long size = fftPopSize(dctFftStack, MCU_CURR, 0, 511, KEEP, DCT);
+		float* compressed = fftPop(dctFftStack, MCU_CURR, 0, 511, KEEP, DCT);
+		mu_check(compressed != NULL && compressed[0] == DCT && size < adaptiveSize);
+		mu_check(ifftDecode(compressed, NULL, decoded, 512) == 512);
+		for(int b = 0; b<4; b++){
+			double square = 0, max = 0;
+			for(int i = 128*b; i<128*(b+1); i++){
+				double error = fabs(decoded[i]-ramp[i]);
+				square += error*error;
+				max = (error > max) ? error : max;
+			}
+			mu_check(((errorTypes[m] == RMS_ERROR) ? sqrt(square/128) : max) <= bound + 1e-4);
+		}
+		free(compressed);
+	}
+	fftDeinitialize(dctFftStack);
+	idDeinitialize(dctIdStack);
+}
+
+MU_TEST(test_fixedFft) {
+	/*16 bits integer channels (odd blocs, a gap) in float and in fixed point against a float channel of the same values*/
+	IdStack* fixedIdStack = idInitialize();
+	FftStack* fixedFftStack = fftInitialize();
+	idStackPush(fixedIdStack, MCU_CURR,OTHER_TYPE,FLOAT,0,1);
+	idStackPush(fixedIdStack, TEST1,OTHER_TYPE,INT16_T,0,1);
+	idStackPush(fixedIdStack, TEST2,OTHER_TYPE,INT16_T,0,1);
+	idStackPush(fixedIdStack, TEST3,OTHER_TYPE,INT32_T,0,1);
+	idStackPush(fixedIdStack, TEST4,OTHER_TYPE,FLOAT,0,1);
+	Id_type ids[5] = {MCU_CURR,TEST1,TEST2,TEST3,TEST4};
+	for(int c = 0; c<5; c++) initializeFftElement(fixedFftStack, ids[c], 63);
+	mu_check(fftSetFixedPoint(fixedFftStack, TEST2, 1) == 0 && fftSetFixedPoint(fixedFftStack, TEST3, 1) == 0);
+	mu_check(fftSetFixedPoint(fixedFftStack, TEST4, 1) == 0);
+	float data[300];
+	for(int i = 0; i<300; i++){
+		int16_t value16 = (int16_t)(30000*sin(i/11.) + (i%7)*10);
+		int32_t value32 = (i%2 == 0) ? INT32_MAX - i : INT32_MIN + i;
+		data[i] = value16;
+		dataIdStackPush(fixedIdStack, MCU_CURR, &data[i]);
+		dataIdStackPush(fixedIdStack, TEST1, &value16);
+		dataIdStackPush(fixedIdStack, TEST2, &value16);
+		dataIdStackPush(fixedIdStack, TEST3, &value32);
+		dataIdStackPush(fixedIdStack, TEST4, &data[i]);
+	}
+	for(int c = 0; c<4; c++){
+		dataIdStackSkip(fixedIdStack, ids[c], 4);
+		mu_check(fftPush(fixedFftStack, fixedIdStack, ids[c], ~0u) != NULL);
+	}
+	/*Only the integer channels can be transformed in fixed point, and not once blocs are stored*/
+	mu_check(fftPush(fixedFftStack, fixedIdStack, TEST4, ~0u) == NULL);
+	mu_check(fftSetFixedPoint(fixedFftStack, TEST2, 0) == -1 && fftSetFixedPoint(fixedFftStack, MCU_CURR, 1) == -1);
+	/*By default the integers are transformed as floats (the data extending a bloc are rounded into integers)*/
+	float* floatArray = fftPop(fixedFftStack, MCU_CURR, 0, 299, KEEP, ALL);
+	float* intArray = fftPop(fixedFftStack, TEST1, 0, 299, KEEP, ALL);
+	long size = fftPopSize(fixedFftStack, MCU_CURR, 0, 299, KEEP, ALL);
+	mu_check(floatArray != NULL && intArray != NULL && fftPopSize(fixedFftStack, TEST1, 0, 299, KEEP, ALL) == size);
+	for(long i = FFT_POP_PARAM; i<size/(long)sizeof(float); i++) mu_check(fabs(intArray[i]-floatArray[i]) <= 1.f);
+	/*The fixed point frequencies are popped in Q31 with the scale of their bloc*/
+	long fixedSize = fftPopSize(fixedFftStack, TEST2, 0, 299, KEEP, ALL);
+	float* fixedArray = fftPop(fixedFftStack, TEST2, 0, 299, KEEP, ALL);
+	mu_check(fixedArray != NULL && fixedArray[6] == FFT_FIXED_BITS && fixedSize == size + 2*(long)floatArray[1]*(long)sizeof(float));
+	float values[300];
+	mu_check(ifftDecode(fixedArray, NULL, values, 300) == 300);
+	for(int i = 0; i<300; i++) mu_check(fabs(values[i]-data[i]) < 0.05);
+	float floatMean, fixedMean, floatRms, fixedRms;
+	mu_check(fftStats(fixedFftStack, MCU_CURR, 0, 299, &floatMean, &floatRms, NULL) == fftStats(fixedFftStack, TEST2, 0, 299, &fixedMean, &fixedRms, NULL));
+	mu_check(fabs(fixedMean-floatMean) < 1e-2 && fabs(fixedRms-floatRms) < 1e-2);
+	mu_check(fftSetErrorBound(fixedFftStack, TEST2, TOP_K, MAX_ERROR, 10.f) == 0);
+	free(fixedArray);
+	fixedArray = fftPop(fixedFftStack, TEST2, 0, 299, KEEP, ADAPTIVE);
+	mu_check(fixedArray != NULL && fixedArray[6] == 32 && ifftDecode(fixedArray, NULL, values, 300) == 300);
+	for(int i = 0; i<300; i++) mu_check(fabs(values[i]-data[i]) <= 10.f);
+	free(floatArray);
+	free(intArray);
+	free(fixedArray);
+	/*Full scale 32 bits integers don't overflow*/
+	fixedArray = fftPop(fixedFftStack, TEST3, 0, 299, KEEP, ALL);
+	mu_check(ifftDecode(fixedArray, NULL, values, 300) == 300);
+	for(int i = 0; i<300; i++) mu_check(fabs(values[i]-((i%2 == 0) ? (double)INT32_MAX - i : (double)INT32_MIN + i)) < 1e-6*INT32_MAX);
+	free(fixedArray);
+	int32_t low[32], high[32];
+	float scale;
+	mu_check(fftSplitBatchFixed(data, 8, 63, 1, low, high, &scale) == -1);
+	fftDeinitialize(fixedFftStack);
+	idDeinitialize(fixedIdStack);
+}
+
+MU_TEST(test_convertFft) {
+	/*Rounding and saturation of the reverse conversion*/
+	float in[5] = {-1.6f, 2.5f, 300.f, -300.f, NAN};
+	uint8_t out8[5];
+	int8_t outS8[5];
+	mu_check(fftFloatToData(in, 5, UINT8_T, out8) == 0 && fftFloatToData(in, 5, INT8_T, outS8) == 0);
+	mu_check(out8[0] == 0 && out8[1] == 3 && out8[2] == 255 && out8[3] == 0 && out8[4] == 0);
+	mu_check(outS8[0] == -2 && outS8[1] == 3 && outS8[2] == 127 && outS8[3] == -128 && outS8[4] == 0);
+	mu_check(fftFloatToData(in, 5, CHAR, out8) == -1);
+	/*Channels of several types compressed and decoded back into their type*/
+	IdStack* convertIdStack = idInitialize();
+	FftStack* convertFftStack = fftInitialize();
+	Id_type ids[5] = {MCU_CURR,TEST1,TEST2,TEST3,TEST4};
+	Data_type types[5] = {UINT16_T,INT8_T,UINT64_T,DOUBLE,LDOUBLE};
+	for(int c = 0; c<5; c++){
+		idStackPush(convertIdStack, ids[c],OTHER_TYPE,types[c],0,1);
+		initializeFftElement(convertFftStack, ids[c], 32);
+	}
+	idStackPush(convertIdStack, MCU_TEMP,OTHER_TYPE,CHAR,0,1);
+	initializeFftElement(convertFftStack, MCU_TEMP, 32);
+	double expected[100];
+	for(int i = 0; i<100; i++){
+		expected[i] = 100 + (int)(90*sin(i/7.));
+		uint16_t valueU16 = (uint16_t)expected[i];
+		int8_t value8 = (int8_t)(expected[i]-100);
+		uint64_t valueU64 = (uint64_t)expected[i];
+		double valueDouble = expected[i];
+		long double valueLDouble = expected[i];
+		char valueChar = 'a';
+		dataIdStackPush(convertIdStack, MCU_CURR, &valueU16);
+		dataIdStackPush(convertIdStack, TEST1, &value8);
+		dataIdStackPush(convertIdStack, TEST2, &valueU64);
+		dataIdStackPush(convertIdStack, TEST3, &valueDouble);
+		dataIdStackPush(convertIdStack, TEST4, &valueLDouble);
+		dataIdStackPush(convertIdStack, MCU_TEMP, &valueChar);
+	}
+	mu_check(fftPush(convertFftStack, convertIdStack, MCU_TEMP, ~0u) == NULL);
+	char decoded[100*16];
+	unsigned int times[100];
+	for(int c = 0; c<5; c++){
+		mu_check(fftPush(convertFftStack, convertIdStack, ids[c], ~0u) != NULL);
+		float* compressed = fftPop(convertFftStack, ids[c], 0, 95, KEEP, ALL);
+		mu_check(ifftDataType(compressed) == (int)types[c]);
+		mu_check(ifftDecodeData(compressed, times, decoded, 95) == -1);
+		mu_check(ifftDecodeData(compressed, times, decoded, 96) == 96);
+		float values[96];
+		mu_check(fftDataToFloat(decoded, types[c], 96, values) == 0);
+		for(int i = 0; i<96; i++){
+			double value = expected[i] - ((types[c] == INT8_T) ? 100 : 0);
+			/*The integers are rounded back to the exact values*/
+			mu_check((types[c] == DOUBLE || types[c] == LDOUBLE) ? fabs(values[i]-value) < 1e-3 : values[i] == value);
+			mu_check(times[i] == (unsigned int)i);
+		}
+		free(compressed);
+	}
+	fftDeinitialize(convertFftStack);
+	idDeinitialize(convertIdStack);
+}
+
+MU_TEST(test_fastSizeFft) {
+	mu_check(fftFastSize(1) == 2 && fftFastSize(15) == 16 && fftFastSize(97) == 100 && fftFastSize(101) == 108 && fftFastSize(128) == 128);
+	mu_check(fftFastSize(0) == 0);
+	/*A prime bloc size with a gap : the blocs are extended to 100 data and decoded back to 97*/
+	IdStack* fastIdStack = idInitialize();
+	FftStack* fastFftStack = fftInitialize();
+	idStackPush(fastIdStack, MCU_CURR,OTHER_TYPE,FLOAT,0,1);
+	FftElement* fftElement = initializeFftElement(fastFftStack, MCU_CURR, 97);
+	mu_check(fftElement->fftSize == 100 && fftElement->sizeCompressedL == 52 && fftElement->sizeCompressedH == 50);
+	float data[350], values[350];
+	for(int i = 0; i<350; i++){
+		data[i] = (float)(0.05*i + sin(i/6.));
+		dataIdStackPush(fastIdStack, MCU_CURR, &data[i]);
+	}
+	dataIdStackSkip(fastIdStack, MCU_CURR, 3);
+	fftPush(fastFftStack, fastIdStack, MCU_CURR, ~0u);
+	mu_check(fftPopSize(fastFftStack, MCU_CURR, 0, 349, KEEP, ALL) == (long)((FFT_POP_PARAM+4*102)*sizeof(float)));
+	float* compressed = fftPop(fastFftStack, MCU_CURR, 0, 349, KEEP, ALL);
+	mu_check(ifftSize(compressed) == 350 && ifftDecode(compressed, NULL, values, 350) == 350);
+	for(int i = 0; i<350; i++) mu_check(fabs(values[i]-data[i]) < 1e-4);
+	DecodeSink sink = {0,0,0};
+	mu_check(ifftStream(compressed, decodeSink, &sink) == 2 && sink.number == 194 && sink.lastTime == 193);
+	free(compressed);
+	/*The RMS bound holds on the data of each bloc, not on its extension*/
+	float bound = 0.05f;
+	mu_check(fftSetErrorBound(fastFftStack, MCU_CURR, TOP_K, RMS_ERROR, bound) == 0);
+	Fft_type types[2] = {ADAPTIVE,DCT};
+	for(int t = 0; t<2; t++){
+		compressed = fftPop(fastFftStack, MCU_CURR, 0, 349, KEEP, types[t]);
+		mu_check(ifftDecode(compressed, NULL, values, 350) == 350);
+		for(int b = 0; b<4; b++){
+			int number = (b == 3) ? 59 : 97;
+			double square = 0;
+			for(int i = 97*b; i<97*b+number; i++) square += (values[i]-data[i])*(values[i]-data[i]);
+			mu_check(sqrt(square/number) <= bound + 1e-4);
+		}
+		free(compressed);
+	}
+	fftDeinitialize(fastFftStack);
+	idDeinitialize(fastIdStack);
+}
+
+MU_TEST(test_streamFft) {
+	IdStack* streamIdStack = idInitialize();
+	FftStack* streamFftStack = fftInitialize();
+	IdElement* idElement = idStackPush(streamIdStack, MCU_CURR,OTHER_TYPE,FLOAT,0,1);
+	initializeFftElement(streamFftStack, MCU_CURR, 64);
+	float data[1000], values[1000];
+	for(int i = 0; i<10; i++){
+		data[i] = (float)sin(i/5.);
+		dataIdStackPush(streamIdStack, MCU_CURR, &data[i]);
+	}
+	mu_check(fftStream(streamFftStack, streamIdStack, MCU_CURR) == 0);
+	/*Each bloc is compressed by the push which fills it*/
+	int maxNumber = 0;
+	for(int i = 10; i<1000; i++){
+		data[i] = (float)(sin(i/5.) + 0.01*i);
+		dataIdStackPush(streamIdStack, MCU_CURR, &data[i]);
+		if ((int)idElement->dataNumber > maxNumber) maxNumber = idElement->dataNumber;
+	}
+	mu_check(maxNumber == 63 && idElement->dataNumber == 1000%64 && idElement->startTime == 960);
+	float* compressed = fftPop(streamFftStack, MCU_CURR, 0, 959, KEEP, ALL);
+	mu_check(ifftDecode(compressed, NULL, values, 1000) == 960);
+	for(int i = 0; i<960; i++) mu_check(fabs(values[i]-data[i]) < 1e-4);
+	free(compressed);
+	/*Stopped, the data stay raw*/
+	mu_check(idElementSetPush(streamIdStack, idElement, 0, NULL, NULL) == 0);
+	for(int i = 0; i<100; i++) dataIdStackPush(streamIdStack, MCU_CURR, &data[i]);
+	mu_check(idElement->dataNumber == 140);
+	/*A compression which fails stops the streaming : a float channel can't be compressed in fixed point*/
+	IdElement* failing = idStackPush(streamIdStack, MCU_TEMP,OTHER_TYPE,FLOAT,0,1);
+	initializeFftElement(streamFftStack, MCU_TEMP, 64);
+	mu_check(fftSetFixedPoint(streamFftStack, MCU_TEMP, 1) == 0);
+	for(int i = 0; i<10; i++) dataIdStackPush(streamIdStack, MCU_TEMP, &data[i]);
+	mu_check(fftStream(streamFftStack, streamIdStack, MCU_TEMP) == 0 && failing->push != NULL);
+	for(int i = 10; i<100; i++) dataIdStackPush(streamIdStack, MCU_TEMP, &data[i]);
+	mu_check(failing->push == NULL && failing->dataNumber == 100);
+	mu_check(fftStream(streamFftStack, streamIdStack, MCU_TEMP) == -1 && failing->push == NULL);
+	fftDeinitialize(streamFftStack);
+	idDeinitialize(streamIdStack);
+}
+
+MU_TEST(test_statsFft) {
+	IdStack* statsIdStack = idInitialize();
+	FftStack* statsFftStack = fftInitialize();
+	idStackPush(statsIdStack, MCU_CURR,OTHER_TYPE,FLOAT,0,1);
+	idStackPush(statsIdStack, MCU_TEMP,OTHER_TYPE,FLOAT,0,1);
+	initializeFftElement(statsFftStack, MCU_CURR, 100);
+	initializeFftElement(statsFftStack, MCU_TEMP, 97);
+	float data[500];
+	for(int i = 0; i<500; i++){
+		data[i] = (float)(2. + 3.*sin(2*M_PI*0.1*i) + 0.5*cos(2*M_PI*0.3*i) + 0.002*i);
+		dataIdStackPush(statsIdStack, MCU_CURR, &data[i]);
+		dataIdStackPush(statsIdStack, MCU_TEMP, &data[i]);
+	}
+	/*MCU_TEMP : blocs extended to 100 data and a padded bloc before a gap*/
+	dataIdStackSkip(statsIdStack, MCU_TEMP, 5);
+	fftPush(statsFftStack, statsIdStack, MCU_CURR, 499);
+	fftPush(statsFftStack, statsIdStack, MCU_TEMP, 499);
+	Id_type ids[2] = {MCU_CURR,MCU_TEMP};
+	for(int c = 0; c<2; c++){
+		float mean, rms, variance;
+		int start = (c == 0) ? 100 : 97, number = (c == 0) ? 300 : 403;
+		double sum = 0, square = 0;
+		for(int i = start; i<start+number; i++){
+			sum += data[i];
+			square += (double)data[i]*data[i];
+		}
+		mu_check(fftStats(statsFftStack, ids[c], start, start+number-1, &mean, &rms, &variance) == number);
+		mu_check(fabs(mean - sum/number) < 1e-3 && fabs(rms - sqrt(square/number)) < 1e-3);
+		mu_check(fabs(variance - (square/number - (sum/number)*(sum/number))) < 1e-2);
+	}
+	/*The sine of amplitude 3 at 0.1 cycle per data gives a power of 4.5 (plus the leak of the trend), the bands add up to the mean square*/
+	float edges[4] = {0, 0.05f, 0.2f, 0.5f}, powers[3], rms;
+	mu_check(fftBandPower(statsFftStack, MCU_CURR, 0, 499, edges, 3, powers) == 500);
+	mu_check(fabs(powers[1] - 4.5) < 0.05 && fabs(powers[2] - 0.125) < 0.01);
+	fftStats(statsFftStack, MCU_CURR, 0, 499, NULL, &rms, NULL);
+	mu_check(fabs(powers[0] + powers[1] + powers[2] - rms*rms) < 1e-3);
+	/*The bands of extended and padded blocs add up to the mean square of their own data too*/
+	float mean;
+	mu_check(fftBandPower(statsFftStack, MCU_TEMP, 0, 499, edges, 3, powers) == 500);
+	fftStats(statsFftStack, MCU_TEMP, 0, 499, &mean, &rms, NULL);
+	mu_check(fabs(powers[0] + powers[1] + powers[2] - rms*rms) < 1e-3 && powers[0] >= mean*mean);
+	mu_check(fabs(powers[1] - 4.5) < 0.2 && fabs(powers[2] - 0.125) < 0.05);
+	mu_check(fftStats(statsFftStack, MCU_CURR, 0, 600, NULL, NULL, NULL) == -1);
+	/*A large bloc padded before a gap after a few data*/
+	idStackPush(statsIdStack, TEST1,OTHER_TYPE,FLOAT,0,1);
+	initializeFftElement(statsFftStack, TEST1, 4096);
+	for(int i = 0; i<7; i++) dataIdStackPush(statsIdStack, TEST1, &data[i]);
+	dataIdStackSkip(statsIdStack, TEST1, 3);
+	mu_check(fftPush(statsFftStack, statsIdStack, TEST1, ~0u) != NULL);
+	double sum = 0, square = 0;
+	for(int i = 0; i<7; i++){
+		sum += data[i];
+		square += (double)data[i]*data[i];
+	}
+	mu_check(fftStats(statsFftStack, TEST1, 0, 6, &mean, &rms, NULL) == 7);
+	mu_check(fabs(mean - sum/7) < 1e-3 && fabs(rms - sqrt(square/7)) < 1e-3);
+	/*An integer channel extended from 1001 to 1024 data : its ramp was rounded to integers*/
+	idStackPush(statsIdStack, TEST2,OTHER_TYPE,INT16_T,0,1);
+	initializeFftElement(statsFftStack, TEST2, 1001);
+	sum = 0;
+	square = 0;
+	for(int i = 0; i<1001; i++){
+		int16_t value = (int16_t)(100*sin(0.01*i*i) - 7);
+		dataIdStackPush(statsIdStack, TEST2, &value);
+		sum += value;
+		square += (double)value*value;
+	}
+	mu_check(searchFftElement(statsFftStack, TEST2)->fftSize == 1024);
+	mu_check(fftPush(statsFftStack, statsIdStack, TEST2, 1000) != NULL);
+	mu_check(fftStats(statsFftStack, TEST2, 0, 1000, &mean, &rms, NULL) == 1001);
+	mu_check(fabs(mean - sum/1001) < 1e-4 && fabs(rms - sqrt(square/1001)) < 1e-4);
+	fftDeinitialize(statsFftStack);
+	idDeinitialize(statsIdStack);
+}
+
+MU_TEST(test_decimateFft) {
+	IdStack* decimateIdStack = idInitialize();
+	FftStack* decimateFftStack = fftInitialize();
+	idStackPush(decimateIdStack, MCU_CURR,OTHER_TYPE,FLOAT,0,2);
+	initializeFftElement(decimateFftStack, MCU_CURR, 256);
+	float data[1000], values[1000];
+	unsigned int times[1000];
+	for(int i = 0; i<1000; i++){
+		data[i] = (float)(1. + 2.*sin(2*M_PI*i/64.) + cos(2*M_PI*i/128.));
+		dataIdStackPush(decimateIdStack, MCU_CURR, &data[i]);
+		if (i == 599) dataIdStackSkip(decimateIdStack, MCU_CURR, 10);
+	}
+	fftPush(decimateFftStack, decimateIdStack, MCU_CURR, ~0u);
+	/*Blocs of 256, 256, 88 before the gap then 256 : the frequencies are under the new Nyquist frequency*/
+	mu_check(fftDecimate(decimateFftStack, MCU_CURR, 0, 1718, 4, NULL, NULL, 0) == 64+64+22+64);
+	mu_check(fftDecimate(decimateFftStack, MCU_CURR, 0, 1718, 4, times, values, 213) == -1);
+	mu_check(fftDecimate(decimateFftStack, MCU_CURR, 0, 1718, 4, times, values, 1000) == 214);
+	for(int j = 0; j<128; j++) mu_check(fabs(values[j]-data[4*j]) < 1e-4 && times[j] == 8u*j);
+	mu_check(times[150] == 1220 && fabs(values[150]-data[600]) < 1e-4);
+	mu_check(fftDecimate(decimateFftStack, MCU_CURR, 0, 1020, 16, times, values, 1000) == 16+16);
+	for(int j = 0; j<32; j++) mu_check(fabs(values[j]-data[16*j]) < 1e-4);
+	/*One data per bloc : its mean*/
+	mu_check(fftDecimate(decimateFftStack, MCU_CURR, 0, 510, 256, times, values, 1000) == 1 && fabs(values[0]-1) < 1e-4);
+	mu_check(fftDecimate(decimateFftStack, MCU_CURR, 0, 510, 3, times, values, 1000) == -1);
+	fftDeinitialize(decimateFftStack);
+	idDeinitialize(decimateIdStack);
+}
+
 MU_TEST(test_fft) {
 	FftStack* myFftStack = fftInitialize();
 	initializeFftElement(myFftStack, MCU_CURR, 4);
@@ -157,9 +1407,33 @@ MU_TEST_SUITE(test_suite) {
 	//printIdStack(myIdStack);
 
 	MU_RUN_TEST(test_dataIdStackPop);
+	MU_RUN_TEST(test_registerIdElements);
+	MU_RUN_TEST(test_framePush);
+	MU_RUN_TEST(test_memoryBudget);
+	MU_RUN_TEST(test_lyingEvict);
+	MU_RUN_TEST(test_fftEvict);
+	MU_RUN_TEST(test_concurrentIdStack);
+	MU_RUN_TEST(test_snapshotRestore);
+	MU_RUN_TEST(test_irregularIdStack);
+	MU_RUN_TEST(test_gapIdStack);
 
 	//printIdStack(myIdStack);
 
+	MU_RUN_TEST(test_realFft);
+	MU_RUN_TEST(test_planCache);
+	MU_RUN_TEST(test_parallelFftPush);
+	MU_RUN_TEST(test_fftPopInto);
+	MU_RUN_TEST(test_ifftDecode);
+	MU_RUN_TEST(test_fftWorkspace);
+	MU_RUN_TEST(test_adaptiveFft);
+	MU_RUN_TEST(test_quantizedFft);
+	MU_RUN_TEST(test_dctFft);
+	MU_RUN_TEST(test_fixedFft);
+	MU_RUN_TEST(test_convertFft);
+	MU_RUN_TEST(test_fastSizeFft);
+	MU_RUN_TEST(test_streamFft);
+	MU_RUN_TEST(test_statsFft);
+	MU_RUN_TEST(test_decimateFft);
 	MU_RUN_TEST(test_fft);
 
 
@@ -11,10 +11,61 @@
 #ifndef FFT_FREQ_H
 #define FFT_FREQ_H
 
+#include <stdint.h>
+
 #ifdef __cplusplus
 extern "C" {
 #endif
 
+/*Number of FFT workspaces (size and direction) kept between two transforms*/
+#define FFT_PLAN_CACHE_SIZE 16
+
+/*Number of values converted together by fftQuantize and fftDequantize*/
+#define FFT_QUANTIZE_CHUNK 256
+
+/*Bits given to fftDequantize for Q31 coefficients : the int32_t values are preceded by their scale (a float)*/
+#define FFT_FIXED_BITS 31
+
+/*
+ * Frequencies dropped first by fftSelect : the smallest ones (TOP_K) or the highest ones (BAND).
+ */
+enum Select_mode
+{
+	TOP_K,BAND
+};
+typedef enum Select_mode Select_mode;
+
+/*
+ * Error bounded by fftSelect : RMS error or max error of the data of a bloc.
+ */
+enum Error_type
+{
+	RMS_ERROR,MAX_ERROR
+};
+typedef enum Error_type Error_type;
+
+/*
+ * Plan and heap buffers of the transforms of one size and one direction. A workspace is used by one thread at a time.
+ */
+typedef struct FftWorkspace FftWorkspace;
+
+/*
+ * Take a workspace of size (inverse 0 to compress, 1 to decompress) out of the shared cache, or allocate one.
+ * Return NULL if it failed. It is given back with fftWorkspaceRelease.
+ */
+FftWorkspace* fftWorkspaceAcquire(unsigned int size,int inverse);
+
+/*
+ * Give a workspace back to the cache, so that the next transforms of its size reuse it.
+ */
+void fftWorkspaceRelease(FftWorkspace* workspace);
+
+/*
+ * Return the smallest even size, not lower than size, whose transform only uses the radix 2, 3, 4 and 5 butterflies
+ * of kiss. Return 0 if it failed.
+ */
+unsigned int fftFastSize(unsigned int size);
+
 /*
  * Return Low frequencies of FFT of array. Size is the number of elements of array.
  */
@@ -25,6 +76,24 @@ float* fftLow(float* array,unsigned int size);
  */
 float* fftHigh(float* array,unsigned int size);
 
+/*
+ * Fill low and high with the arrays of fftLow and fftHigh, with one FFT. Return 0, -1 if it failed.
+ */
+int fftSplit(float* array,unsigned int size,float** low,float** high);
+
+/*
+ * Compress nbBlocs contiguous blocs of size elements with one plan : their fftLow arrays are written one after the
+ * other into low, their fftHigh arrays into high. Return 0, -1 if it failed.
+ */
+int fftSplitBatch(float* array,unsigned int size,unsigned int nbBlocs,float* low,float* high);
+
+/*
+ * Same as fftSplitBatch with blocs of int16_t (bits 16) or int32_t (bits 32) integers, transformed in fixed point :
+ * low and high receive Q31 integers, the frequencies of the bloc i being these integers times scales[i] (each bloc is
+ * scaled to its largest value). Return 0, -1 if it failed.
+ */
+int fftSplitBatchFixed(const void* array,unsigned int bits,unsigned int size,unsigned int nbBlocs,int32_t* low,int32_t* high,float* scales);
+
 /*
  * Return FFT of array. Size is the number of elements of array.
  */
@@ -45,6 +114,102 @@ float* ifftHigh(float* array,unsigned int size);
  */
 float* ifftAll(float* array,unsigned int size);
 
+/*
+ * Write into dataOut the data of a bloc from its fftLow array and/or its fftHigh array (NULL if not kept), with one
+ * inverse FFT and no allocation. workspace is an inverse workspace of the size of the bloc. Return 0, -1 if it failed.
+ */
+int ifftBloc(FftWorkspace* workspace,float* low,float* high,float* dataOut);
+
+/*
+ * Write into dataOut the data 0, factor, 2*factor... of a bloc of size data from its fftLow array, with one inverse FFT
+ * of size/factor over its frequencies under the new Nyquist frequency (low-pass filtered, no aliasing). workspace is
+ * an inverse workspace of size/factor, factor being at least 2 and dividing size. Return 0, -1 if it failed.
+ */
+int ifftBlocDecimated(FftWorkspace* workspace,float* low,unsigned int size,float* dataOut);
+
+/*
+ * Return the number of 4 bytes words written by fftQuantize for number values of bits bits.
+ */
+unsigned int fftQuantizeWords(unsigned int number,unsigned int bits);
+
+/*
+ * Write number floats of in into out (unaligned) as integers of 8 or 16 bits with the offset and the scale of the
+ * values, or as floats (32 bits). Return the number of 4 bytes words written, -1 if it failed.
+ */
+int fftQuantize(float* in,unsigned int number,unsigned int bits,void* out);
+
+/*
+ * Write into out the number values written by fftQuantize with bits bits, or the number Q31 integers preceded by
+ * their scale with FFT_FIXED_BITS. Return the number of 4 bytes words read, -1 if it failed.
+ */
+int fftDequantize(void* in,unsigned int number,unsigned int bits,float* out);
+
+/*
+ * Write into out the number Q31 integers of in (unaligned) times scale.
+ */
+void fftFixedToFloat(const void* in,unsigned int number,float scale,float* out);
+
+/*
+ * Write into out (unaligned) the mask and the values of the fewest frequencies of a bloc (from its fftLow and fftHigh
+ * arrays) for which the RMS or max error (errorType) of its data stays under bound, the values quantized on bits bits
+ * (see fftQuantize). Return the number of 4 bytes words of out (only computed if out is NULL), -1 if it failed.
+ * workspace is a workspace of the size of the bloc.
+ */
+int fftSelect(FftWorkspace* workspace,float* low,float* high,Select_mode selection,Error_type errorType,float bound,unsigned int bits,void* out);
+
+/*
+ * Write into dataOut the data of a bloc from the buffer written by fftSelect, with the inverse workspace of its size.
+ * Return the number of 4 bytes words read, -1 if it failed.
+ */
+int ifftSelect(FftWorkspace* workspace,void* in,unsigned int bits,float* dataOut);
+
+/*
+ * Write into coefficients the orthonormal DCT-II of the size data of a bloc, with a forward workspace of its size.
+ * Return 0, -1 if it failed.
+ */
+int dctBloc(FftWorkspace* workspace,float* data,float* coefficients);
+
+/*
+ * Write into dataOut the size data of a bloc from its coefficients written by dctBloc (DCT-III), with an inverse
+ * workspace of its size. Return 0, -1 if it failed.
+ */
+int idctBloc(FftWorkspace* workspace,float* coefficients,float* dataOut);
+
+/*
+ * Same as fftSelect with the DCT-II coefficients of the size data of a bloc : write into out the mask and the values
+ * of the fewest coefficients for which the error stays under bound. workspace is a forward workspace of the size of
+ * the bloc. Return the number of 4 bytes words of out (only computed if out is NULL), -1 if it failed.
+ */
+int dctSelect(FftWorkspace* workspace,float* data,Select_mode selection,Error_type errorType,float bound,unsigned int bits,void* out);
+
+/*
+ * Write into dataOut the data of a bloc from the buffer written by dctSelect, with the inverse workspace of its size.
+ * Return the number of 4 bytes words read, -1 if it failed.
+ */
+int idctSelect(FftWorkspace* workspace,void* in,unsigned int bits,float* dataOut);
+
+/*
+ * Return the data t of a bloc of size data from its fftLow and fftHigh arrays, in O(size) without inverse transform.
+ */
+double fftBlocData(float* low,float* high,unsigned int size,unsigned int t);
+
+/*
+ * Add to sum and square the sum and the sum of squares of the size data of a bloc, from its fftLow and fftHigh arrays
+ * without inverse transform (frequency 0 and Parseval) : O(size). Return 0, -1 if it failed.
+ */
+int fftBlocMoments(float* low,float* high,unsigned int size,double* sum,double* square);
+
+/*
+ * Add to powers[b] the mean of the squares of the size data of a bloc due to its frequencies in [edges[b], edges[b+1])
+ * (cycles per data, the last band includes its upper edge), from its fftLow and fftHigh arrays. Return 0, -1 if it failed.
+ */
+int fftBlocBands(float* low,float* high,unsigned int size,const float* edges,unsigned int bandNumber,double* powers);
+
+/*
+ * Free the cached FFT workspaces and return their number. The plans are shared by all the threads.
+ */
+int fftPlanCleanup();
+
 #ifdef __cplusplus
 }
 #endif
@@ -1,4 +1,5 @@
 #include "idStack.h"
+#include "fftFreq.h"
 
 #ifndef H_FFTSTACK
 #define H_FFTSTACK
@@ -19,13 +20,48 @@
 1 - Initialize FftStack with fftInitialize() Function.
 2 - Initialize FftElement with initializeFftElement(...) Function.
 2 - Compress data in an IdStack and store the compressed data with the fftPush(...) Function.
-3 - Pop data from the FftStack into a float array which could be send, with the fftPop(...) Function.
+3 - Pop data from the FftStack into a float array which could be send, with the fftPop(...) Function (or into an
+existing buffer, with the fftPopSize(...) and fftPopInto(...) Functions).
 4 - Possible to compress with other methods and send (Like Zlib)
-5 - Decompress the float array with the ifft(...) Function
+5 - Decompress the float array with the ifftDecode(...) Function into buffers (sized with ifftSize(...)), with the
+ifftStream(...) Function bloc after bloc, or print it with the ifft(...) Function
 6 - You can delete an FftElement with deinitializeFftElement(...) Funtion (not a requirement).
 7 - Deinitialize FftStack with fftDeinitialize(...) Function.
+
+An ADAPTIVE pop keeps, for each bloc, only the frequencies needed to stay under the error set by fftSetErrorBound,
+with a mask of the kept frequencies (see fftSelect in fftFreq.h). A DCT pop does the same with the DCT-II of each
+bloc (see dctSelect). The popped coefficients can be quantized on 8 or 16 bits with fftSetQuantization, the
+error of the quantization being counted in the bound.
+
+The channels of every type but CHAR are converted into floats with fftDataToFloat and compressed with float FFTs.
+The frequencies are stored, popped and decompressed as floats : ifftDecodeData converts them back into the type of
+the channel (fftFloatToData). fftSetFixedPoint makes an INT16_T or INT32_T channel use fixed point FFTs instead (see
+fftSplitBatchFixed in fftFreq.h) for nodes without FPU : its frequencies are then stored and popped (ALL, LOW and
+HIGH) as Q31 integers with a scale per bloc, and only converted into floats by the decoding.
+
+fftPushParallel compresses several channels at once with a pool of threads (the IdStack is only used by the
+calling thread).
+
+fftEvict can be given to idStackSetBudget (with the FftStack as context) : the oldest data of a channel over the
+budget is then compressed by whole blocs into its FftElement instead of being dropped.
+
+fftStats and fftBandPower compute the mean, RMS, variance and band powers of a time range straight from the stored
+frequencies (frequency 0 and Parseval), without popping the blocs. The data added to a bloc (padding before a gap,
+extension to fftSize) only depend on its first and last data : they are removed from the mean and the RMS, and the
+band powers of a bloc are rescaled to the mean and the variance of its own data. fftDecimate decodes one data out of factor for overviews, with inverse FFTs factor times shorter over the lowest
+frequencies of the blocs.
+
+fftStream compresses a channel while its data arrive : each bloc is compressed by the push which fills it, so only
+the last, incomplete bloc is kept raw in the IdStack and the compression cost is spread over the pushes.
 */
 
+/*Maximum number of blocs popped and transformed together by fftPush*/
+#define FFT_BATCH_BLOCS 64
+/*Number of floats before the data in the array sent by fftPop*/
+#define FFT_POP_PARAM 9
+/*Alignment in bytes of the coefficient columns of a FftElement*/
+#define FFT_ALIGN 32
+
 /**
  * \enum Erase_mode
  * \brief Possible modes when compress data is popped.
@@ -40,20 +76,27 @@
 
 /**
  * \enum Fft_type
- * \brief Existing Fft types. (ALL,LOW,HIGH)
+ * \brief Existing Fft types. (ALL,LOW,HIGH,ADAPTIVE,DCT)
  *
- * Used to compress and decompress according to the right method.
+ * Used to compress and decompress according to the right method. ADAPTIVE keeps, for each bloc, the fewest
+ * frequencies for which the error of its data stays under the bound set by fftSetErrorBound. DCT does the same with
+ * the DCT-II coefficients of the bloc, which don't suffer from the jump between the two ends of a bloc.
  */
 	enum Fft_type
 	{
-		ALL,LOW,HIGH
+		ALL,LOW,HIGH,ADAPTIVE,DCT
 	};
 
 	typedef enum Fft_type Fft_type;
 
 	typedef struct FftStack FftStack;
 	typedef struct FftElement FftElement;
-	typedef struct FftDataStack FftDataStack;
+	typedef struct FftBloc FftBloc;
+/*
+ * Function called by ifftStream with the number data of a bloc, the time of values[i] is startTime + i*timeInterval.
+ * It returns 0 to go on with the next bloc, another value to stop.
+ */
+	typedef int (*Decode_function)(unsigned int startTime, unsigned int timeInterval, float* values, unsigned int number, void* context);
 
 /**
  * \struct FftStack
@@ -68,8 +111,12 @@
 
 /**
  * \struct FftElement
- * \brief Part of FftStack. Contain FftDataStack.
+ * \brief Part of FftStack. Contain the frequency compressed data by blocs.
  *
+ * The coefficients are stored in two contiguous columns : the Low arrays of the blocs one after the other in low,
+ * their High arrays in high. The bloc k (from the oldest one) starts at low + (firstBloc+k)*sizeCompressedL and
+ * high + (firstBloc+k)*sizeCompressedH. With fixedPoint, the columns hold int32_t Q31 coefficients (copied with
+ * memcpy) instead of floats, a coefficient of a bloc being its integer times the scale of the bloc.
  */
 
 	struct FftElement
@@ -77,38 +124,67 @@
 		Id_type id;
 		unsigned int startTime; //4
 		unsigned int blocSize; //4 Very important parameter ...
+		unsigned int fftSize; //4   size of the transform of a bloc (fftFastSize(blocSize)), the blocs are extended to it.
 		unsigned int sizeCompressedH; //4
 		unsigned int sizeCompressedL; //4
 		unsigned int timeInterval; //4
-		unsigned int dataNumber;  //4    number of data in the FftElement.
-		FftDataStack *fftDataStack; //8   pointer to the compressed dataStack.
+		unsigned int dataNumber;  //4    number of blocs in the FftElement.
+		unsigned int firstBloc;  //4    index of the oldest bloc in the columns (the blocs before were popped).
+		unsigned int blocCapacity;  //4    number of blocs allocated in the columns.
+		float *low; //8   column of the Low arrays (aligned on FFT_ALIGN).
+		float *high; //8   column of the High arrays (aligned on FFT_ALIGN).
+		FftBloc *blocs; //8   times of the blocs, indexed as the columns.
+		Select_mode selection; //4   coefficients dropped first by an ADAPTIVE or DCT pop.
+		Error_type errorType; //4   error bounded by an ADAPTIVE or DCT pop.
+		float errorBound; //4   error allowed on the data of a bloc by an ADAPTIVE or DCT pop.
+		unsigned int coefficientBits; //4   bits of a coefficient in the popped arrays (8, 16 or 32 for floats).
+		Data_type dataType; //4   type of the data of the channel, written in the popped arrays.
+		int fixedPoint; //4   1 when the INT16_T or INT32_T data are transformed and stored in Q31 (see fftSetFixedPoint).
 		FftElement *next; //8   pointer to the next FftElement.
 	};
 
 /**
- * \struct FftDataStack
- * \brief Part of FftElement. Contain the frequency compressed data by blocs.
+ * \struct FftBloc
+ * \brief Part of FftElement. Times of a compressed bloc.
  *
  */
 
-	struct FftDataStack
+	struct FftBloc
 	{
-		float *pointerHigh;   //pointer to the first float data of the high frequency compressed array
-		float *pointerLow;     //pointer to the first float data of the low frequency compressed array
-		FftDataStack *next;
+		unsigned int startTime;  //time of the first data of the bloc
+		unsigned int dataNumber;  //number of data in the bloc, lower than blocSize when the bloc was padded before a gap
+		float scale;  //value of a unit of the Q31 coefficients of the bloc (fixed point FftElement only)
 	};
 
 	FftStack* fftInitialize();
 	void fftDeinitialize(FftStack* myFftStack);
 	FftElement* fftPush(FftStack* myFftStack, IdStack* myIdStack, Id_type id,unsigned int stopTime);
+	int fftPushParallel(FftStack* myFftStack, IdStack* myIdStack, Id_type* ids, unsigned int channelNumber, unsigned int stopTime, unsigned int threadNumber);
 	FftElement* initializeFftElement(FftStack *myFftStack, Id_type id, unsigned int blocSize);
 	FftElement* searchFftElement(FftStack *myFftStack, Id_type id);
 	int deinitializeFftElement(FftStack *myFftStack, Id_type id);
 	int deinitializeFirstFftElement(FftStack *myFftStack);
 	void printFftStack(FftStack *fftStack);
 	void printFftDataStack(FftElement *fftElement);
+	int fftSetErrorBound(FftStack* myFftStack, Id_type id, Select_mode selection, Error_type errorType, float bound);
+	int fftSetQuantization(FftStack* myFftStack, Id_type id, unsigned int bits);
+	int fftSetFixedPoint(FftStack* myFftStack, Id_type id, int fixedPoint);
 	int blocNumberCount(FftElement* myfftElement,unsigned int startTime,unsigned int stopTime);
 	float* fftPop(FftStack* myFftStack, Id_type id,unsigned int startTime,unsigned int stopTime, Erase_mode erase, Fft_type fft_type);
+	long fftPopSize(FftStack* myFftStack, Id_type id,unsigned int startTime,unsigned int stopTime, Erase_mode erase, Fft_type fft_type);
+	long fftPopInto(FftStack* myFftStack, Id_type id,unsigned int startTime,unsigned int stopTime, Erase_mode erase, Fft_type fft_type, void* buffer, size_t bufferSize);
 	float* ifft(float* array);
+	long ifftSize(float* array);
+	long ifftDecode(float* array, unsigned int* times, float* values, size_t capacity);
+	int ifftStream(float* array, Decode_function sink, void* context);
+	long ifftDecodeData(float* array, unsigned int* times, void* data, size_t capacity);
+	int ifftDataType(float* array);
+	int fftDataToFloat(const void* data, Data_type dataType, size_t number, float* values);
+	int fftFloatToData(const float* values, size_t number, Data_type dataType, void* data);
+	int fftEvict(IdStack* myIdStack, IdElement* idElement, unsigned int number, void* myFftStack);
+	int fftStream(FftStack* myFftStack, IdStack* myIdStack, Id_type id);
+	long fftStats(FftStack* myFftStack, Id_type id, unsigned int startTime, unsigned int stopTime, float* mean, float* rms, float* variance);
+	long fftBandPower(FftStack* myFftStack, Id_type id, unsigned int startTime, unsigned int stopTime, const float* edges, unsigned int bandNumber, float* powers);
+	long fftDecimate(FftStack* myFftStack, Id_type id, unsigned int startTime, unsigned int stopTime, unsigned int factor, unsigned int* times, float* values, size_t capacity);
 
 #endif
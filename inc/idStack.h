@@ -1,4 +1,7 @@
+#include <stddef.h>
 #include "stack.h"
+#include "ringBuffer.h"
+#include "timeStack.h"
 
 #ifndef H_IDSTACK
 #define H_IDSTACK
@@ -24,12 +27,80 @@
 4 - Pop Data from an IdElement with dataIdStackPop Function.
 5 - You can delete an IdElement with idStackPop Funtion.
 6 - Deinitialize IdStack with idDeinitialize Function.
+
+Channels which are not part of the Id_type enum can be registered at runtime by name with idStackRegister.
+Every IdElement receives a compact handle (IdElement->handle) which can be given to the handle functions
+(dataHandlePush, dataHandlePop, handleIdElement, handleIdStackPop) : they reach the IdElement directly,
+without searching the list or comparing names.
+
+Channels sampled at the same instant can be pushed together : compile their handles once into an IdFrame with
+idFrameInitialize, then push a packed struct of their values with dataIdFramePush. A frame push fails without
+pushing anything once one of its channels has been popped or made irregular.
+
+The memory of an IdStack can be bounded with idStackSetBudget. When a push goes over the budget, the oldest data of
+the channel with the lowest IdElement->priority is evicted until the IdStack uses less than 7/8 of the budget.
+A channel can also be limited on its own with IdElement->quota. The eviction can be replaced by an Evict_function,
+for instance fftEvict (fftStack.h) which compresses the oldest blocs before they are dropped.
+
+Instead of waiting for a pop, the data of an IdElement can be consumed as they arrive : idElementSetPush gives it a
+Push_function called after each push (or idStackDrain) leaving at least pushThreshold data in the IdElement. fftStream
+(fftStack.h) uses it to compress each bloc as soon as it is full. A Push_function which fails is detached, the data
+then stay in the IdElement. The Push_function isn't saved by idStackSnapshot.
+
+CONCURRENT MODE
+
+After idStackConcurrent, each IdElement owns a lock-free RingBuffer : one producer thread per channel can call
+dataHandleProduce while one consumer thread registers and pops channels, pops data, calls fftPush... The consumer
+moves the produced data into the dataStacks with idStackDrain (the pops also drain the IdElement they use).
+Producers find the IdElements in a handle table which is replaced, never modified in place, when it grows; popped
+IdElements and old tables are freed by idStackDrain once no producer can still use them, so producers never wait.
+
+GAPS
+
+When a periodic sensor misses readings, call dataIdStackSkip or dataHandleSkip with the number of missed readings
+instead of pushing dummy values : the IdElement is then split into IdSegments separated by gaps, and the next data
+gets the right time. The pops return the data of the segments one after the other, without the gaps : call
+idElementSegments to know their times. fftPush only compresses whole segments and never processes the gaps.
+
+IRREGULAR CHANNELS
+
+The data of an IdElement are timed with startTime + i*timeInterval. A channel sampled at irregular times (events,
+jittery sensors) is switched with idElementIrregular while it is empty : its data are then stored with their own
+times in a TimeStack (timeStack.h). They are pushed with dataIdStackPushTime or dataHandlePushTime, popped from the
+oldest one with dataIdStackPopTime or dataHandlePopTime, and any time range can be read with dataHandleReadTime.
+A time is found with a binary search, so pops and reads cost O(log n + k). Irregular channels can't be part of an
+IdFrame, produced by another thread or compressed by fftPush.
+
+SNAPSHOT
+
+idStackSnapshot writes every IdElement (header and data in chronological order) into one file. After a restart,
+idRestore maps this file and gives it to the dataStacks of the periodic channels as their oldest data : they aren't
+copied, so their restore time doesn't depend on their number of data. The data of the irregular channels are copied
+into their TimeStacks, one by one. The file must not be modified while the restored IdStack uses it
+(a new snapshot of the same path is written beside it, then renamed). The file is only readable on the same kind of machine.
 */
 
+/*Maximum size of a channel name (including the final '\0')*/
+#define ID_NAME_SIZE 16
+
 
 
 	typedef struct IdElement IdElement;
 	typedef struct IdStack IdStack;
+	typedef struct IdFrame IdFrame;
+	typedef struct IdConcurrent IdConcurrent;
+	typedef struct IdSegment IdSegment;
+/*
+ * Function called to remove at least number data from the oldest data of idElement when the IdStack goes over its budget.
+ * It returns the number of removed data; if it is lower than 1 or if idElement->dataNumber didn't go down, the oldest
+ * data are simply dropped.
+ */
+	typedef int (*Evict_function)(IdStack *myIdStack, IdElement *idElement, unsigned int number, void *context);
+/*
+ * Function called after a push when idElement holds at least IdElement->pushThreshold data, to consume them as they arrive.
+ * It returns the number of consumed data, -1 if it FAILED (it is then detached from idElement).
+ */
+	typedef int (*Push_function)(IdStack *myIdStack, IdElement *idElement, void *context);
 /**
  * \enum Data_type
  * \brief Existing data types.
@@ -59,9 +130,20 @@
  */
 	enum Id_type
 	{
-		MCU_CURR,MCU_TEMP,RTC,RAM,TEST1,TEST2,TEST3,TEST4
+		MCU_CURR,MCU_TEMP,RTC,RAM,TEST1,TEST2,TEST3,TEST4,
+		REGISTERED  //Id of the channels registered at runtime with idStackRegister. Use their handle to reach them.
 	};
 	typedef enum Id_type Id_type;
+/**
+ * \struct IdSegment
+ * \brief Run of data without gap of a periodic IdElement. The time of the data i of the segment is startTime + i*timeInterval.
+ *
+ */
+	struct IdSegment
+	{
+		unsigned int startTime;  //time of the first data of the segment
+		unsigned int dataNumber;  //number of data in the segment
+	};
 /**
  * \struct IdElement
  * \brief Part of IdStack. Contain Stack
@@ -77,6 +159,18 @@
 		unsigned int dataNumber;  //4    number of data in the IdElement.
 		Stack *dataStack; //8   pointer to the dataStack.
 		IdElement *next; //8   pointer to the next IdElement.
+		unsigned int handle; //4   index of the IdElement in IdStack->handles.
+		char name[ID_NAME_SIZE]; //16  name given at the registration ("" for Id_type channels).
+		unsigned int priority; //4   the channels with the lowest priority are evicted first (0 by default).
+		size_t quota; //8   maximum memory of the IdElement in bytes (0 by default : no quota).
+		RingBuffer *ring; //8   data produced by another thread and not yet drained (concurrent mode only, NULL otherwise).
+		TimeStack *timeStack; //8   data and times of an irregular channel (NULL for a periodic channel, timeInterval is then 0).
+		IdSegment *segments; //8   segments separated by gaps, from the oldest one (NULL while the channel has no gap).
+		unsigned int segmentNumber; //4   number of segments (0 while the channel has no gap).
+		unsigned int segmentCapacity; //4   number of allocated segments.
+		Push_function push; //8   function called when the IdElement holds pushThreshold data (NULL by default).
+		void *pushContext; //8   last parameter given to push.
+		unsigned int pushThreshold; //4   number of data from which push is called.
 	};
 /**
  * \struct IdStack
@@ -86,6 +180,30 @@
 	struct IdStack
 	{
 		IdElement *first;   //pointer to the first IdElement
+		IdElement **handles;   //IdElements indexed by their handle (NULL if the handle is free)
+		unsigned int handleNumber;   //number of used slots in handles
+		unsigned int handleSize;   //number of allocated slots in handles
+		size_t memoryUsed;   //memory used by the IdElements and their data in bytes
+		size_t memoryBudget;   //maximum memory of the IdStack in bytes (0 : no budget)
+		Evict_function evict;   //function used to evict data (NULL : the oldest data are dropped)
+		void *evictContext;   //last parameter given to evict
+		IdConcurrent *concurrent;   //state shared with the producer threads (NULL if the IdStack isn't concurrent)
+		void *snapshot;   //mapping of the snapshot file given by idRestore (NULL otherwise)
+		size_t snapshotSize;   //size of the mapping in bytes
+	};
+/**
+ * \struct IdFrame
+ * \brief Precompiled set of IdElements pushed together from one packed frame of values.
+ *
+ * Values are packed in the order of the handles, without padding : value i is at offsets[i] and takes offsets[i+1]-offsets[i] bytes.
+ */
+	struct IdFrame
+	{
+		IdElement **channels;   //IdElements of the frame, in the order of the values
+		unsigned int *handles;   //handles of the IdElements, checked by each push against IdStack->handles
+		unsigned int *offsets;   //channelNumber+1 offsets of the values in the packed frame
+		unsigned int channelNumber;   //number of IdElements in the frame
+		IdStack *idStack;   //IdStack owning the IdElements
 	};
 
 	IdStack* idInitialize();
@@ -100,4 +218,32 @@
 	int getTimeInterval(IdStack*);
 	IdElement* dataIdStackPush(IdStack*, Id_type, void*);
 	void* dataIdStackPop(IdStack*, Id_type,unsigned int);
+	IdElement* idStackRegister(IdStack*,const char*,Signal_type,Data_type,unsigned int,unsigned int);
+	int searchIdHandle(IdStack*, const char*);
+	IdElement* handleIdElement(IdStack*, unsigned int);
+	int handleIdStackPop(IdStack*, unsigned int);
+	IdElement* dataHandlePush(IdStack*, unsigned int, void*);
+	void* dataHandlePop(IdStack*, unsigned int,unsigned int);
+	IdFrame* idFrameInitialize(IdStack*, unsigned int*, unsigned int);
+	void idFrameDeinitialize(IdFrame*);
+	int dataIdFramePush(IdFrame*, void*);
+	size_t idElementMemory(IdElement*);
+	void idStackSetBudget(IdStack*, size_t, Evict_function, void*);
+	int idStackEvict(IdStack*);
+	int idElementSetPush(IdStack*, IdElement*, unsigned int, Push_function, void*);
+	int idStackConcurrent(IdStack*, unsigned int);
+	int dataHandleProduce(IdStack*, unsigned int, void*);
+	int idElementDrain(IdStack*, IdElement*);
+	int idStackDrain(IdStack*);
+	IdElement* dataIdStackSkip(IdStack*, Id_type, unsigned int);
+	IdElement* dataHandleSkip(IdStack*, unsigned int, unsigned int);
+	unsigned int idElementSegments(IdElement*, unsigned int, unsigned int, IdSegment*, unsigned int);
+	int idElementIrregular(IdStack*, IdElement*);
+	IdElement* dataIdStackPushTime(IdStack*, Id_type, unsigned int, void*);
+	IdElement* dataHandlePushTime(IdStack*, unsigned int, unsigned int, void*);
+	void* dataIdStackPopTime(IdStack*, Id_type, unsigned int, unsigned int*, unsigned int**);
+	void* dataHandlePopTime(IdStack*, unsigned int, unsigned int, unsigned int*, unsigned int**);
+	void* dataHandleReadTime(IdStack*, unsigned int, unsigned int, unsigned int, unsigned int*, unsigned int**);
+	int idStackSnapshot(IdStack*, const char*);
+	IdStack* idRestore(const char*);
 #endif
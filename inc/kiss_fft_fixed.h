@@ -0,0 +1,37 @@
+#ifndef KISS_FFT_FIXED_H
+#define KISS_FFT_FIXED_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+ * kiss_fft and kiss_fftr built with FIXED_POINT == 32 (see kiss_fft_fixed.c), beside the float build.
+ *
+ * The scalars are Q31 : each stage of the transform divides its result by its radix to avoid overflows, so a
+ * forward transform of nfft data gives the frequencies divided by nfft.
+ */
+
+typedef struct {
+    int32_t r;
+    int32_t i;
+}kiss_fft_fixed_cpx;
+
+typedef struct kiss_fft_fixed_state* kiss_fft_fixed_cfg;
+typedef struct kiss_fftr_fixed_state* kiss_fftr_fixed_cfg;
+
+kiss_fft_fixed_cfg kiss_fft_fixed_alloc(int nfft,int inverse_fft,void * mem,size_t * lenmem);
+void kiss_fft_fixed(kiss_fft_fixed_cfg cfg,const kiss_fft_fixed_cpx *fin,kiss_fft_fixed_cpx *fout);
+
+/* nfft must be even */
+kiss_fftr_fixed_cfg kiss_fftr_fixed_alloc(int nfft,int inverse_fft,void * mem,size_t * lenmem);
+void kiss_fftr_fixed(kiss_fftr_fixed_cfg cfg,const int32_t *timedata,kiss_fft_fixed_cpx *freqdata);
+void kiss_fftri_fixed(kiss_fftr_fixed_cfg cfg,const kiss_fft_fixed_cpx *freqdata,int32_t *timedata);
+
+#ifdef __cplusplus
+}
+#endif
+#endif
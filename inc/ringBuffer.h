@@ -0,0 +1,35 @@
+#ifndef H_RINGBUFFER
+#define H_RINGBUFFER
+
+/**
+ * \file ringBuffer.h
+ * \brief RingBuffer Functions declarations
+ *
+ * Lock-free single-producer/single-consumer buffer of fixed size data, used by idStack.c in concurrent mode.
+ * One thread only may call ringPush, and one other thread only may call ringAvailable, ringPeek and ringRelease.
+ *
+ */
+
+#include <stdatomic.h>
+
+	typedef struct RingBuffer RingBuffer;
+/**
+ * \struct RingBuffer
+ * \brief Contiguous circular array of data. head and tail are on their own cache line so the two threads don't share it.
+ *
+ */
+	struct RingBuffer
+	{
+		_Alignas(64) atomic_uint head;  //index of the next data read by the consumer
+		_Alignas(64) atomic_uint tail;  //index of the next data written by the producer
+		_Alignas(64) unsigned int mask;  //size of the buffer (power of 2) - 1
+		unsigned int numberSize;  //size of a data
+		char *buffer;  //pointer to the first data
+	};
+	RingBuffer* ringInitialize(unsigned int, unsigned int);
+	void ringDeinitialize(RingBuffer*);
+	int ringPush(RingBuffer*, void*);
+	unsigned int ringAvailable(RingBuffer*);
+	void* ringPeek(RingBuffer*, unsigned int);
+	void ringRelease(RingBuffer*, unsigned int);
+#endif
@@ -11,6 +11,9 @@
  * Functions only used by idStack.c to manipulate Stacks
  *
  */
+/*Maximum number of popped Elements kept by a Stack to be reused by the next pushes*/
+#define STACK_SPARE_MAX 1024
+
 	typedef struct Element Element;
 	typedef struct Stack Stack;
 /**
@@ -31,6 +34,11 @@
 	struct Stack
 	{
 		Element *first;  //pointer to the first Element
+		Element *spare;  //popped Elements (with their data buffer) kept for the next pushes
+		unsigned int spareNumber;  //number of Elements in spare (lower than STACK_SPARE_MAX)
+		char *base;  //oldest data, older than the Elements, read in place in a mapped snapshot (not owned by the Stack)
+		unsigned int baseNumber;  //number of data left in base, from the oldest one
+		int baseSize;  //size of a data of base
 	};
 	Stack* initialize();
 	void deinitialize(Stack*);
@@ -39,4 +47,7 @@
 	int stackNumberCount(Stack*, unsigned int,unsigned int,unsigned int,unsigned int);
 	void* stackPop(Stack*,int,unsigned int,unsigned int,unsigned int,int);
 	void printStack(Stack*);
+	void stackTrim(Stack*);
+	void stackDrop(Stack*, unsigned int);
+	void stackMap(Stack*, void*, unsigned int, int);
 #endif
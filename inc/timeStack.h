@@ -0,0 +1,62 @@
+#ifndef H_TIMESTACK
+#define H_TIMESTACK
+
+/**
+ * \file timeStack.h
+ * \brief TimeStack Functions declarations
+ *
+ * Functions only used by idStack.c to store the data of the irregular channels with their times.
+ * The times are stored as delta-of-delta varints in blocks of TIME_BLOCK_SIZE data. The blocks are kept in
+ * an array sorted by time, so a time is found with a binary search over the blocks then a decoding of one block.
+ *
+ */
+
+#include <stddef.h>
+
+/*Number of data in a TimeBlock*/
+#define TIME_BLOCK_SIZE 256
+
+	typedef struct TimeBlock TimeBlock;
+	typedef struct TimeStack TimeStack;
+/**
+ * \struct TimeBlock
+ * \brief Part of TimeStack. Contain up to TIME_BLOCK_SIZE data and their times.
+ *
+ */
+	struct TimeBlock
+	{
+		unsigned int firstTime;  //time of the first data
+		unsigned int lastTime;  //time of the last data
+		unsigned int lastDelta;  //lastTime - time of the data before (0 if there is one data)
+		unsigned int dataNumber;  //number of data in the block
+		unsigned int timeSize;  //number of bytes used in times
+		unsigned int timeCapacity;  //number of bytes allocated in times
+		unsigned char *times;  //delta-of-delta of the times after the first one (zigzag varints)
+		char *data;  //contiguous data, from the oldest one
+	};
+/**
+ * \struct TimeStack
+ * \brief Part of IdElement. Contain the TimeBlocks of an irregular channel.
+ *
+ */
+	struct TimeStack
+	{
+		TimeBlock *blocks;  //array of TimeBlocks, the live ones are between firstBlock and blockNumber
+		unsigned int firstBlock;  //index of the oldest TimeBlock
+		unsigned int blockNumber;  //index after the newest TimeBlock
+		unsigned int blockCapacity;  //number of allocated TimeBlocks
+		unsigned int skipNumber;  //number of data already popped from the oldest TimeBlock
+		unsigned int dataNumber;  //number of data in the TimeStack
+		int numberSize;  //size of a data
+		size_t memory;  //number of bytes allocated for the TimeBlocks
+	};
+	TimeStack* timeInitialize(int);
+	void timeDeinitialize(TimeStack*);
+	int timeStackPush(TimeStack*, unsigned int, void*);
+	unsigned int timeStackStartTime(TimeStack*);
+	unsigned int timeStackCount(TimeStack*, unsigned int, unsigned int);
+	void* timeStackRead(TimeStack*, unsigned int, unsigned int, unsigned int*, unsigned int**);
+	void* timeStackPop(TimeStack*, unsigned int, unsigned int*, unsigned int**);
+	void timeStackDrop(TimeStack*, unsigned int);
+	size_t timeStackMemory(TimeStack*);
+#endif
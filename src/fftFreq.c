@@ -8,186 +8,1485 @@
  *
  */
 
+#include <string.h>
+#include <stdint.h>
+#include <math.h>
+#include <float.h>
+#include <pthread.h>
 #include "fftFreq.h"
 #include "kiss_fft.h"
 #include "kiss_fftr.h"
+#include "kiss_fft_fixed.h"
+
+/*
+ * The N floats of a bloc are transformed directly : a real FFT of size N when N is even, a complex FFT of size N
+ * when N is odd (kiss_fftr only handles even sizes). Only the frequencies 0 to N/2 are kept, the others are their
+ * conjugates. The compressed arrays are the same as with a complex input of size 2N (float rounding apart).
+ *
+ * A FftWorkspace holds the kiss configuration (plan) of a size and a direction and the heap buffers of the
+ * transform, so no kernel puts a bloc on the stack. The workspaces are kept in a cache of FFT_PLAN_CACHE_SIZE
+ * workspaces. A workspace is taken out of the cache while it is used : two threads never share one, a thread which
+ * finds no free workspace of its size allocates one. The least recently used workspace is freed when the cache is
+ * full.
+ *
+ * The integer blocs of fftSplitBatchFixed are transformed with the Q31 build of kiss (kiss_fft_fixed.h) in fixed
+ * point workspaces, cached with the float ones. Each bloc is shifted so that its largest value uses 30 bits (block
+ * floating point) : the Q31 frequencies are then scaled by size/2^shift into the same float arrays as fftSplitBatch.
+ */
+
+typedef struct FftCost FftCost;
+struct FftCost
+{
+    double cost;   //error added when the frequency is dropped
+    unsigned int index;   //index of the frequency
+};
+
+struct FftWorkspace
+{
+    unsigned int size;   //size of the transform
+    int inverse;   //1 for an inverse transform
+    void* cfg;   //kiss_fftr_cfg for an even size, kiss_fft_cfg for an odd size
+    kiss_fft_cpx* bins;   //frequencies 0 to size/2
+    kiss_fft_cpx* in_cpx;   //complex input of size "size" for an odd size, NULL for an even size
+    kiss_fft_cpx* out_cpx;   //complex output of size "size" for an odd size, NULL for an even size
+    FftCost* costs;   //costs of the coefficients used by fftSelect and dctSelect, allocated by their first call
+    kiss_fft_cpx* twiddles;   //exp(-i*pi*k/(2*size)) used by the DCT, allocated with costs
+    float* dct;   //DCT coefficients of a bloc, allocated with costs
+    uint32_t* mask;   //mask of the kept coefficients, allocated with costs
+    int fixedPoint;   //1 for a Q31 transform (cfg is then a kiss_fftr_fixed_cfg or a kiss_fft_fixed_cfg)
+    kiss_fft_fixed_cpx* fixedBins;   //Q31 frequencies 0 to size/2, then for an odd size the complex input and output
+    int32_t* fixedData;   //Q31 data of a bloc, allocated with fixedBins
+    unsigned long lastUse;   //value of planClock when the workspace was given back
+};
+
+static FftWorkspace* planCache[FFT_PLAN_CACHE_SIZE];
+static unsigned int planNumber = 0;
+static unsigned long planClock = 0;
+static pthread_mutex_t planMutex = PTHREAD_MUTEX_INITIALIZER;
+
+/**
+ * \fn static void freeWorkspace(FftWorkspace* workspace)
+ * \brief Free a workspace and its plan.
+ */
+
+static void freeWorkspace(FftWorkspace* workspace)
+{
+    free(workspace->cfg);
+    free(workspace->bins);
+    free(workspace->fixedBins);
+    free(workspace->costs);
+    free(workspace);
+}
+
+/**
+ * \fn static FftWorkspace* acquireWorkspace(unsigned int size,int inverse,int fixedPoint)
+ * \brief Take a workspace of this size, direction and arithmetic out of the cache, or allocate one.
+ *
+ * \return the workspace, to give back with fftWorkspaceRelease. NULL if it FAILED.
+ */
+
+static FftWorkspace* acquireWorkspace(unsigned int size,int inverse,int fixedPoint)
+{
+    FftWorkspace* workspace = NULL;
+    if (size < 1)
+    {
+        perror("Error : Size of the fft should be higher than 0\n");
+        return NULL;
+    }
+    pthread_mutex_lock(&planMutex);
+    for(unsigned int i=0;i<planNumber;i++)
+    {
+        if (planCache[i]->size == size && planCache[i]->inverse == inverse && planCache[i]->fixedPoint == fixedPoint)
+        {
+            workspace = planCache[i];
+            planCache[i] = planCache[--planNumber];
+            break;
+        }
+    }
+    pthread_mutex_unlock(&planMutex);
+    if (workspace != NULL)
+        return workspace;
+    workspace = (FftWorkspace*)malloc(sizeof(*workspace));
+    if (workspace == NULL)
+    {
+        perror("Error : Memory allocation impossible for the fft\n");
+        return NULL;
+    }
+    workspace->size = size;
+    workspace->inverse = inverse;
+    workspace->fixedPoint = fixedPoint;
+    workspace->costs = NULL;
+    workspace->twiddles = NULL;
+    workspace->dct = NULL;
+    workspace->mask = NULL;
+    workspace->fixedBins = NULL;
+    workspace->fixedData = NULL;
+    /*One allocation for the bins and, for an odd size, the complex input and output*/
+    size_t number = size/2+1 + ((size%2 == 0) ? 0 : 2*(size_t)size);
+    if (fixedPoint)
+    {
+        workspace->cfg = (size%2 == 0) ? (void*)kiss_fftr_fixed_alloc(size ,inverse ,0,0) : (void*)kiss_fft_fixed_alloc(size ,inverse ,0,0);
+        workspace->bins = (kiss_fft_cpx*)malloc((size/2+1)*sizeof(kiss_fft_cpx));
+        workspace->fixedBins = (kiss_fft_fixed_cpx*)malloc(number*sizeof(kiss_fft_fixed_cpx) + size*sizeof(int32_t));
+    }
+    else
+    {
+        workspace->cfg = (size%2 == 0) ? (void*)kiss_fftr_alloc(size ,inverse ,0,0) : (void*)kiss_fft_alloc(size ,inverse ,0,0);
+        workspace->bins = (kiss_fft_cpx*)malloc(number*sizeof(kiss_fft_cpx));
+    }
+    if (workspace->cfg == NULL || workspace->bins == NULL || (fixedPoint && workspace->fixedBins == NULL))
+    {
+        perror("Error : Memory allocation impossible for the fft\n");
+        freeWorkspace(workspace);
+        return NULL;
+    }
+    workspace->in_cpx = (size%2 == 0 || fixedPoint) ? NULL : workspace->bins + size/2+1;
+    workspace->out_cpx = (size%2 == 0 || fixedPoint) ? NULL : workspace->in_cpx + size;
+    if (fixedPoint)
+        workspace->fixedData = (int32_t*)(workspace->fixedBins + number);
+    return workspace;
+}
+
+/**
+ * \fn FftWorkspace* fftWorkspaceAcquire(unsigned int size,int inverse)
+ * \brief Take a workspace of this size and direction out of the cache, or allocate one.
+ *
+ * \param size Size of the array uncompressed.
+ * \param inverse 0 for the compression, 1 for the decompression.
+ * \return the workspace, to give back with fftWorkspaceRelease. NULL if it FAILED.
+ */
+
+FftWorkspace* fftWorkspaceAcquire(unsigned int size,int inverse)
+{
+    return acquireWorkspace(size,inverse,0);
+}
+
+/**
+ * \fn void fftWorkspaceRelease(FftWorkspace* workspace)
+ * \brief Give a workspace back to the cache, the least recently used workspace is freed if the cache is full.
+ *
+ * \param workspace Workspace returned by fftWorkspaceAcquire (nothing is done if NULL).
+ */
+
+void fftWorkspaceRelease(FftWorkspace* workspace)
+{
+    unsigned int slot = 0;
+    if (workspace == NULL)
+        return;
+    pthread_mutex_lock(&planMutex);
+    if (planNumber < FFT_PLAN_CACHE_SIZE)
+        slot = planNumber++;
+    else
+    {
+        for(unsigned int i=1;i<planNumber;i++)
+        {
+            if (planCache[i]->lastUse < planCache[slot]->lastUse)
+                slot = i;
+        }
+        freeWorkspace(planCache[slot]);
+    }
+    workspace->lastUse = ++planClock;
+    planCache[slot] = workspace;
+    pthread_mutex_unlock(&planMutex);
+}
+
+/**
+ * \fn int fftPlanCleanup()
+ * \brief Free the cached workspaces and their plans. The next transforms allocate them again.
+ *
+ * \return the number of freed workspaces.
+ */
+
+int fftPlanCleanup()
+{
+    int number;
+    pthread_mutex_lock(&planMutex);
+    number = planNumber;
+    for(unsigned int i=0;i<planNumber;i++)
+    {
+        freeWorkspace(planCache[i]);
+    }
+    planNumber = 0;
+    pthread_mutex_unlock(&planMutex);
+    return number;
+}
+
+/**
+ * \fn unsigned int fftFastSize(unsigned int size)
+ * \brief Return the smallest even size, not lower than size, whose factors are 2, 3 and 5.
+ *
+ * The transforms of such a size only use the radix 2, 3, 4 and 5 butterflies of kiss, never the generic one which
+ * is O(N^2) for a large prime factor.
+ *
+ * \param size Number of data of a bloc.
+ * \return the size of the transform, 0 if it FAILED.
+ */
+
+unsigned int fftFastSize(unsigned int size)
+{
+    if (size < 1 || size > (unsigned int)INT32_MAX/2)
+    {
+        perror("Error : Size of the fft should be between 1 and 2^30\n");
+        return 0;
+    }
+    unsigned int fastSize = (unsigned int)kiss_fft_next_fast_size((int)size);
+    while (fastSize%2 != 0)
+        fastSize = (unsigned int)kiss_fft_next_fast_size((int)fastSize+1);
+    return fastSize;
+}
+
+/**
+ * \fn static void transformBins(FftWorkspace* workspace,float* array)
+ * \brief Fill the bins of a forward workspace with the frequencies 0 to size/2 of the float array.
+ */
+
+static void transformBins(FftWorkspace* workspace,float* array)
+{
+    unsigned int size = workspace->size;
+    if (size%2 == 0)
+    {
+        kiss_fftr((kiss_fftr_cfg)workspace->cfg,(kiss_fft_scalar*)array, workspace->bins);
+        return;
+    }
+    for(unsigned int i=0;i<size;i++)
+    {
+        workspace->in_cpx[i].r = array[i];
+        workspace->in_cpx[i].i = 0.;
+    }
+    kiss_fft((kiss_fft_cfg)workspace->cfg,workspace->in_cpx,workspace->out_cpx);
+    memcpy(workspace->bins,workspace->out_cpx,(size/2+1)*sizeof(kiss_fft_cpx));
+}
+
+/**
+ * \fn static FftWorkspace* forwardBins(float* array,unsigned int size)
+ * \brief Return a forward workspace whose bins are the frequencies 0 to size/2 of the float array.
+ *
+ * \return the workspace, to give back with fftWorkspaceRelease. NULL if it FAILED.
+ */
+
+static FftWorkspace* forwardBins(float* array,unsigned int size)
+{
+    FftWorkspace* workspace = fftWorkspaceAcquire(size,0);
+    if (workspace != NULL)
+        transformBins(workspace,array);
+    return workspace;
+}
+
+/**
+ * \fn static void inverseBins(FftWorkspace* workspace,float* dataOut)
+ * \brief Fill dataOut with the size data of the frequencies 0 to size/2 in the bins of an inverse workspace.
+ */
+
+static void inverseBins(FftWorkspace* workspace,float* dataOut)
+{
+    unsigned int size = workspace->size;
+    kiss_fft_cpx* bins = workspace->bins;
+    if (size%2 == 0)
+        kiss_fftri((kiss_fftr_cfg)workspace->cfg,bins,(kiss_fft_scalar*)dataOut);
+    else
+    {
+        kiss_fft_cpx* in_cpx = workspace->in_cpx;
+        in_cpx[0] = bins[0];
+        for(unsigned int i=1;i<=size/2;i++)
+        {
+            in_cpx[i] = bins[i];
+            in_cpx[size-i].r = bins[i].r;
+            in_cpx[size-i].i = -bins[i].i;
+        }
+        kiss_fft((kiss_fft_cfg)workspace->cfg,in_cpx,workspace->out_cpx);
+        for(unsigned int i=0;i<size;i++)
+        {
+            dataOut[i] = workspace->out_cpx[i].r;
+        }
+    }
+    for(unsigned int i=0;i<size;i++)
+    {
+        dataOut[i] /= size;
+    }
+}
+
+/**
+ * \fn static void packLow(kiss_fft_cpx* out_cpx,unsigned int size,float* newArray)
+ * \brief Write the Low frequencies (real parts then imaginary parts) of the frequencies of a bloc into newArray.
+ */
+
+static void packLow(kiss_fft_cpx* out_cpx,unsigned int size,float* newArray) {
+    int newSize = ((size+2)/2)+((size+2)/2)%2;
+    for(int i=0;i<newSize/2;i++)
+    {
+        newArray[i] = out_cpx[i].r;
+    }
+    int g = 0;
+    for(int i=newSize/2;i<newSize;i++)
+    {
+        newArray[i] = out_cpx[g].i;
+        g++;
+    }
+}
+
+/**
+ * \fn static void packHigh(kiss_fft_cpx* out_cpx,unsigned int size,float* newArray)
+ * \brief Write the High frequencies (real parts then imaginary parts) of the frequencies of a bloc into newArray.
+ */
+
+static void packHigh(kiss_fft_cpx* out_cpx,unsigned int size,float* newArray) {
+    int newSize = ((size)/2)+((size)/2)%2;
+    int stop = (size-1)/2+(size-1)%2+1;
+    int g =0;
+    for(int i=stop-newSize/2;i<stop;i++)
+    {
+        newArray[g] = out_cpx[i].r;
+        g++;
+    }
+    for(int i=stop-newSize/2;i<stop;i++)
+    {
+        newArray[g] = out_cpx[i].i;
+        g++;
+    }
+}
+
+/**
+ * \fn static float* lowArray(kiss_fft_cpx* out_cpx,unsigned int size)
+ * \brief Return the array of Low frequencies of the frequencies of a bloc.
+ */
+
+static float* lowArray(kiss_fft_cpx* out_cpx,unsigned int size) {
+    float* newArray;
+    newArray = (float*)malloc((((size+2)/2)+((size+2)/2)%2)*sizeof(float));
+	if (newArray == NULL)
+	{
+		perror("Error : Memory allocation impossible for newArray\n");
+		return NULL;
+	}
+    packLow(out_cpx,size,newArray);
+    return newArray;
+}
+
+/**
+ * \fn static float* highArray(kiss_fft_cpx* out_cpx,unsigned int size)
+ * \brief Return the array of High frequencies of the frequencies of a bloc.
+ */
+
+static float* highArray(kiss_fft_cpx* out_cpx,unsigned int size) {
+    float *newArray;
+    newArray = (float*)malloc((((size)/2)+((size)/2)%2)*sizeof(float));
+	if (newArray == NULL)
+	{
+		perror("Error : Memory allocation impossible for newArray\n");
+		return NULL;
+	}
+    packHigh(out_cpx,size,newArray);
+    return newArray;
+}
+
+/**
+ * \fn float* fftLow(float* array,unsigned int size)
+ * \brief Compress the float array into frequency data and return an array with only Low frequencies.
+ *
+ * \param array Float Array to compress.
+ * \param size Size of the array uncompressed.
+ * \return An float array with only Low frequencies.
+ */
+
+float* fftLow(float* array,unsigned int size) {
+    //FFT LOW FREQ
+    FftWorkspace* workspace = forwardBins(array,size);
+    if (workspace == NULL)
+        return NULL;
+    float* newArray = lowArray(workspace->bins,size);
+    fftWorkspaceRelease(workspace);
+    return newArray;
+}
+
+/**
+ * \fn float* fftHigh(float* array,unsigned int size)
+ * \brief Compress the float array into frequency data and return an array with only High frequencies.
+ *
+ * \param array Float Array to compress.
+ * \param size Size of the array uncompressed.
+ * \return An float array with only High frequencies.
+ */
+
+float* fftHigh(float* array,unsigned int size) {
+    //FFT HIGH FREQ
+    FftWorkspace* workspace = forwardBins(array,size);
+    if (workspace == NULL)
+        return NULL;
+    float* newArray = highArray(workspace->bins,size);
+    fftWorkspaceRelease(workspace);
+    return newArray;
+}
+
+/**
+ * \fn int fftSplit(float* array,unsigned int size,float** low,float** high)
+ * \brief Compress the float array with one FFT into the arrays returned by fftLow and fftHigh.
+ *
+ * \param array Float Array to compress.
+ * \param size Size of the array uncompressed.
+ * \param low Receive the array of Low frequencies (to free).
+ * \param high Receive the array of High frequencies (to free).
+ * \return 0 if it SUCCESSED, -1 if it FAILED.
+ */
+
+int fftSplit(float* array,unsigned int size,float** low,float** high) {
+    FftWorkspace* workspace = forwardBins(array,size);
+    if (workspace == NULL)
+        return -1;
+    *low = lowArray(workspace->bins,size);
+    *high = highArray(workspace->bins,size);
+    fftWorkspaceRelease(workspace);
+    if (*low == NULL || *high == NULL)
+    {
+        free(*low);
+        free(*high);
+        return -1;
+    }
+    return 0;
+}
+
+/**
+ * \fn int fftSplitBatch(float* array,unsigned int size,unsigned int nbBlocs,float* low,float* high)
+ * \brief Compress nbBlocs contiguous blocs of size floats with one workspace.
+ *
+ * The Low arrays of the blocs are written one after the other into low, and the High arrays into high. They are
+ * the arrays returned by fftLow and fftHigh.
+ *
+ * \param array Float Array of nbBlocs*size data to compress.
+ * \param size Size of a bloc uncompressed.
+ * \param nbBlocs Number of blocs.
+ * \param low Array of nbBlocs*(((size+2)/2)+((size+2)/2)%2) floats receiving the Low frequencies.
+ * \param high Array of nbBlocs*((size/2)+(size/2)%2) floats receiving the High frequencies.
+ * \return 0 if it SUCCESSED, -1 if it FAILED.
+ */
+
+int fftSplitBatch(float* array,unsigned int size,unsigned int nbBlocs,float* low,float* high) {
+    unsigned int sizeCompressedL = ((size+2)/2)+((size+2)/2)%2;
+    unsigned int sizeCompressedH = ((size)/2)+((size)/2)%2;
+    FftWorkspace* workspace = fftWorkspaceAcquire(size,0);
+    if (workspace == NULL)
+        return -1;
+    for(unsigned int i=0;i<nbBlocs;i++)
+    {
+        transformBins(workspace,array + (size_t)i*size);
+        packLow(workspace->bins,size,low + (size_t)i*sizeCompressedL);
+        packHigh(workspace->bins,size,high + (size_t)i*sizeCompressedH);
+    }
+    fftWorkspaceRelease(workspace);
+    return 0;
+}
+
+/**
+ * \fn static const kiss_fft_fixed_cpx* transformFixedBins(FftWorkspace* workspace,const void* array,unsigned int bits,float* scale)
+ * \brief Transform the integers of array in Q31 with a fixed point workspace.
+ *
+ * The integers are shifted so that the largest one uses 30 bits, then transformed in Q31 : a frequency is its Q31
+ * integer times scale.
+ *
+ * \return the Q31 frequencies 0 to size/2 (in the fixed bins of the workspace).
+ */
+
+static const kiss_fft_fixed_cpx* transformFixedBins(FftWorkspace* workspace,const void* array,unsigned int bits,float* scale)
+{
+    unsigned int size = workspace->size;
+    int32_t* data = workspace->fixedData;
+    kiss_fft_fixed_cpx* bins = workspace->fixedBins;
+    uint32_t peak = 0;
+    int shift = 0;
+    for(unsigned int i=0;i<size;i++)
+    {
+        data[i] = (bits == 16) ? ((const int16_t*)array)[i] : ((const int32_t*)array)[i];
+        uint32_t magnitude = (data[i] < 0) ? 0u - (uint32_t)data[i] : (uint32_t)data[i];
+        peak = (magnitude > peak) ? magnitude : peak;
+    }
+    while (shift > -2 && (peak >> -shift) >= (1u << 30))
+        shift--;
+    while (peak != 0 && shift >= 0 && shift < 30 && (peak << shift) < (1u << 29))
+        shift++;
+    for(unsigned int i=0;i<size;i++)
+    {
+        data[i] = (shift >= 0) ? (int32_t)(data[i]*(int64_t)(1u << shift)) : data[i]/(1 << -shift);
+    }
+    if (size%2 == 0)
+        kiss_fftr_fixed((kiss_fftr_fixed_cfg)workspace->cfg,data,bins);
+    else
+    {
+        kiss_fft_fixed_cpx* in_cpx = bins + size/2+1;
+        kiss_fft_fixed_cpx* out_cpx = in_cpx + size;
+        for(unsigned int i=0;i<size;i++)
+        {
+            in_cpx[i].r = data[i];
+            in_cpx[i].i = 0;
+        }
+        kiss_fft_fixed((kiss_fft_fixed_cfg)workspace->cfg,in_cpx,out_cpx);
+        bins = out_cpx;
+    }
+    /*kiss divides the Q31 frequencies by size*/
+    *scale = ldexpf((float)size,-shift);
+    return bins;
+}
+
+/**
+ * \fn static void packFixed(const kiss_fft_fixed_cpx* bins,unsigned int size,int32_t* low,int32_t* high)
+ * \brief Write the Q31 frequencies of a bloc into its Low and High arrays, laid out as the ones of packLow and packHigh.
+ */
+
+static void packFixed(const kiss_fft_fixed_cpx* bins,unsigned int size,int32_t* low,int32_t* high)
+{
+    unsigned int sizeL = ((size+2)/2)+((size+2)/2)%2, sizeH = (size/2)+(size/2)%2;
+    unsigned int start = (size-1)/2+(size-1)%2+1-sizeH/2;
+    for(unsigned int i=0;i<sizeL/2;i++)
+    {
+        low[i] = bins[i].r;
+        low[i+sizeL/2] = bins[i].i;
+    }
+    for(unsigned int i=0;i<sizeH/2;i++)
+    {
+        high[i] = bins[start+i].r;
+        high[i+sizeH/2] = bins[start+i].i;
+    }
+}
+
+/**
+ * \fn int fftSplitBatchFixed(const void* array,unsigned int bits,unsigned int size,unsigned int nbBlocs,int32_t* low,int32_t* high,float* scales)
+ * \brief Compress nbBlocs contiguous blocs of size integers with one fixed point workspace.
+ *
+ * The Low and High arrays written are the ones of fftSplitBatch with the integers as floats, in Q31 : the frequencies
+ * of the bloc i are its Q31 integers times scales[i] (fixed point rounding apart).
+ *
+ * \param array Array of nbBlocs*size int16_t (bits 16) or int32_t (bits 32) data to compress.
+ * \param bits Size of an integer in bits (16 or 32).
+ * \param size Size of a bloc uncompressed.
+ * \param nbBlocs Number of blocs.
+ * \param low Array of nbBlocs*(((size+2)/2)+((size+2)/2)%2) integers receiving the Low frequencies.
+ * \param high Array of nbBlocs*((size/2)+(size/2)%2) integers receiving the High frequencies.
+ * \param scales Array of nbBlocs floats receiving the scales of the blocs.
+ * \return 0 if it SUCCESSED, -1 if it FAILED.
+ */
+
+int fftSplitBatchFixed(const void* array,unsigned int bits,unsigned int size,unsigned int nbBlocs,int32_t* low,int32_t* high,float* scales) {
+    unsigned int sizeCompressedL = ((size+2)/2)+((size+2)/2)%2;
+    unsigned int sizeCompressedH = ((size)/2)+((size)/2)%2;
+    if (bits != 16 && bits != 32)
+    {
+        perror("Error : Only 16 and 32 bits integers can be transformed in fixed point\n");
+        return -1;
+    }
+    FftWorkspace* workspace = acquireWorkspace(size,0,1);
+    if (workspace == NULL)
+        return -1;
+    for(unsigned int i=0;i<nbBlocs;i++)
+    {
+        const kiss_fft_fixed_cpx* bins = transformFixedBins(workspace,(const char*)array + (size_t)i*size*(bits/8),bits,&scales[i]);
+        packFixed(bins,size,low + (size_t)i*sizeCompressedL,high + (size_t)i*sizeCompressedH);
+    }
+    fftWorkspaceRelease(workspace);
+    return 0;
+}
+
+/**
+ * \fn float* fftAll(float* array,unsigned int size)
+ * \brief Transform the float array into frequency data and return an array with all frequencies.
+ *
+ * \param array Float Array to compress.
+ * \param size Size of the array uncompressed.
+ * \return An float array with all frequencies.
+ */
+
+float* fftAll(float* array,unsigned int size) {
+    //FFT ALL
+    float* newArray;
+    newArray = (float*)malloc((2*(size/2)+2)*sizeof(float));
+	if (newArray == NULL)
+	{
+		perror("Error : Memory allocation impossible for newArray\n");
+		return NULL;
+	}
+    FftWorkspace* workspace = forwardBins(array,size);
+    if (workspace == NULL)
+    {
+        free(newArray);
+        return NULL;
+    }
+    kiss_fft_cpx* out_cpx = workspace->bins;
+    for(unsigned int i=0;i<size/2+1;i++)
+    {
+        newArray[i] = out_cpx[i].r;
+    }
+    int g = 0;
+    for(unsigned int i=size/2+1;i<2*(size/2)+2;i++)
+    {
+        newArray[i] = out_cpx[g].i;
+        g++;
+    }
+    fftWorkspaceRelease(workspace);
+    return newArray;
+}
+
+/**
+ * \fn static void unpackBins(kiss_fft_cpx* bins,float* low,float* high,unsigned int size)
+ * \brief Fill the frequencies 0 to size/2 with the fftLow and/or fftHigh arrays of a bloc (NULL if not kept), the others are 0.
+ */
+
+static void unpackBins(kiss_fft_cpx* bins,float* low,float* high,unsigned int size)
+{
+    memset(bins,0,(size/2+1)*sizeof(*bins));
+    if (low != NULL)
+    {
+        unsigned int newSize = ((size+2)/2)+((size+2)/2)%2;
+        for(unsigned int i=0;i<newSize/2;i++)
+        {
+            bins[i].r = low[i];
+            bins[i].i = low[i+newSize/2];
+        }
+    }
+    /*The inverse FFT is linear : the High frequencies are added to the same bins*/
+    if (high != NULL)
+    {
+        unsigned int newSize = ((size)/2)+((size)/2)%2;
+        unsigned int stop = (size-1)/2+(size-1)%2;
+        for(unsigned int i=0;i<newSize/2;i++)
+        {
+            bins[stop-newSize/2+i+1].r += high[i];
+            bins[stop-newSize/2+i+1].i += high[i+newSize/2];
+        }
+    }
+}
+
+/**
+ * \fn int ifftBloc(FftWorkspace* workspace,float* low,float* high,float* dataOut)
+ * \brief Transform the arrays of a bloc compressed by fftLow and/or fftHigh into its data, with one inverse FFT.
+ *
+ * \param workspace Inverse workspace (fftWorkspaceAcquire(size,1)) of the size of the array UNcompressed.
+ * \param low Float Array compressed by fftLow function, NULL if only the High frequencies were kept.
+ * \param high Float Array compressed by fftHigh function, NULL if only the Low frequencies were kept.
+ * \param dataOut Float array of size "size" in which the data is written (no allocation).
+ * \return 0 if it SUCCESSED, -1 if it FAILED.
+ */
+
+int ifftBloc(FftWorkspace* workspace,float* low,float* high,float* dataOut)
+{
+    if (workspace == NULL || workspace->inverse != 1)
+    {
+        perror("Error : An inverse workspace is needed\n");
+        return -1;
+    }
+    unpackBins(workspace->bins,low,high,workspace->size);
+    inverseBins(workspace,dataOut);
+    return 0;
+}
+
+/**
+ * \fn int ifftBlocDecimated(FftWorkspace* workspace,float* low,unsigned int size,float* dataOut)
+ * \brief Write the data 0, factor, 2*factor... of a bloc into dataOut from its fftLow array, with one short inverse FFT.
+ *
+ * factor is size divided by the size of the workspace. The frequencies under the Nyquist frequency of the decimated
+ * data (all in the fftLow array) are kept, the others are dropped : the data are low-pass filtered, without aliasing.
+ *
+ * \param workspace Inverse workspace (fftWorkspaceAcquire(size/factor,1)) of the size of the decimated bloc.
+ * \param low Float Array compressed by fftLow function.
+ * \param size Size of the array uncompressed, a multiple of the size of the workspace (at least twice it).
+ * \param dataOut Float array of size/factor floats in which the data is written (no allocation).
+ * \return 0 if it SUCCESSED, -1 if it FAILED.
+ */
+
+int ifftBlocDecimated(FftWorkspace* workspace,float* low,unsigned int size,float* dataOut)
+{
+    if (workspace == NULL || workspace->inverse != 1 || low == NULL || size < 2*workspace->size || size%workspace->size != 0)
+    {
+        perror("Error : An inverse workspace of size/factor (factor at least 2) is needed\n");
+        return -1;
+    }
+    unsigned int newSize = workspace->size, sizeL = ((size+2)/2)+((size+2)/2)%2;
+    /*kiss divides by newSize instead of size*/
+    float scale = (float)newSize/(float)size;
+    memset(workspace->bins,0,(newSize/2+1)*sizeof(*workspace->bins));
+    for(unsigned int k=0;2*k<newSize;k++)
+    {
+        workspace->bins[k].r = low[k]*scale;
+        workspace->bins[k].i = low[k+sizeL/2]*scale;
+    }
+    workspace->bins[0].i = 0;
+    inverseBins(workspace,dataOut);
+    return 0;
+}
+
+/**
+ * \fn unsigned int fftQuantizeWords(unsigned int number,unsigned int bits)
+ * \brief Return the number of 4 bytes words written by fftQuantize for number values of bits bits.
+ */
+
+unsigned int fftQuantizeWords(unsigned int number,unsigned int bits)
+{
+    if (bits == 32)
+        return number;
+    if (bits == FFT_FIXED_BITS)
+        return 1 + number;
+    return 2 + (number*(bits/8)+3)/4;
+}
+
+/**
+ * \fn int fftQuantize(float* in,unsigned int number,unsigned int bits,void* out)
+ * \brief Write number floats into out as unsigned integers of bits bits (8 or 16), or as floats (32).
+ *
+ * The integers are preceded by the offset (the smallest value) and the scale (a step) of the values as two floats :
+ * a value is offset + q*scale. The integers are padded to a 4 bytes word. The values are converted by chunks of
+ * FFT_QUANTIZE_CHUNK in a buffer of the stack : the loops have no branch and are vectorized by the compiler (from
+ * -O2), and the chunk is copied to out which does not need to be aligned.
+ *
+ * \param in Float array of number values.
+ * \param number Number of values.
+ * \param bits Bits of a value in out (8, 16 or 32).
+ * \param out Buffer of fftQuantizeWords(number,bits) words.
+ * \return number of 4 bytes words written, -1 if it FAILED.
+ */
+
+int fftQuantize(float* in,unsigned int number,unsigned int bits,void* out)
+{
+    char* cursor = (char*)out;
+    if (bits == 32)
+    {
+        memcpy(cursor,in,number*sizeof(float));
+        return (int)number;
+    }
+    if (bits != 8 && bits != 16)
+    {
+        perror("Error : A coefficient must be quantized on 8, 16 or 32 bits\n");
+        return -1;
+    }
+    float minimum = (number > 0) ? in[0] : 0.f, maximum = minimum;
+    for(unsigned int i=1;i<number;i++)
+    {
+        minimum = (in[i] < minimum) ? in[i] : minimum;
+        maximum = (in[i] > maximum) ? in[i] : maximum;
+    }
+    float levels = (bits == 8) ? 255.f : 65535.f;
+    float scale = (maximum - minimum)/levels;
+    float inverse = (scale > 0.f) ? 1.f/scale : 0.f;
+    float parameters[2] = {minimum,scale};
+    memcpy(cursor,parameters,sizeof(parameters));
+    cursor += sizeof(parameters);
+    for(unsigned int i=0;i<number;i+=FFT_QUANTIZE_CHUNK)
+    {
+        unsigned int chunk = (number-i < FFT_QUANTIZE_CHUNK) ? number-i : FFT_QUANTIZE_CHUNK;
+        if (bits == 16)
+        {
+            uint16_t values[FFT_QUANTIZE_CHUNK];
+            for(unsigned int j=0;j<chunk;j++)
+            {
+                float q = (in[i+j] - minimum)*inverse + 0.5f;
+                values[j] = (uint16_t)(q < levels ? q : levels);
+            }
+            memcpy(cursor,values,chunk*sizeof(uint16_t));
+            cursor += chunk*sizeof(uint16_t);
+        }
+        else
+        {
+            uint8_t values[FFT_QUANTIZE_CHUNK];
+            for(unsigned int j=0;j<chunk;j++)
+            {
+                float q = (in[i+j] - minimum)*inverse + 0.5f;
+                values[j] = (uint8_t)(q < levels ? q : levels);
+            }
+            memcpy(cursor,values,chunk*sizeof(uint8_t));
+            cursor += chunk*sizeof(uint8_t);
+        }
+    }
+    unsigned int words = fftQuantizeWords(number,bits);
+    memset(cursor,0,(char*)out + words*4 - cursor);
+    return (int)words;
+}
+
+/**
+ * \fn void fftFixedToFloat(const void* in,unsigned int number,float scale,float* out)
+ * \brief Write into out the number Q31 integers of in times scale.
+ *
+ * \param in Array of number int32_t (it does not need to be aligned).
+ * \param number Number of values.
+ * \param scale Value of a unit of the integers.
+ * \param out Float array of number values.
+ */
+
+void fftFixedToFloat(const void* in,unsigned int number,float scale,float* out)
+{
+    const char* cursor = (const char*)in;
+    for(unsigned int i=0;i<number;i+=FFT_QUANTIZE_CHUNK)
+    {
+        unsigned int chunk = (number-i < FFT_QUANTIZE_CHUNK) ? number-i : FFT_QUANTIZE_CHUNK;
+        int32_t values[FFT_QUANTIZE_CHUNK];
+        memcpy(values,cursor,chunk*sizeof(int32_t));
+        cursor += chunk*sizeof(int32_t);
+        for(unsigned int j=0;j<chunk;j++)
+        {
+            out[i+j] = (float)values[j]*scale;
+        }
+    }
+}
+
+/**
+ * \fn int fftDequantize(void* in,unsigned int number,unsigned int bits,float* out)
+ * \brief Write into out the number values written by fftQuantize with bits bits.
+ *
+ * \param in Buffer written by fftQuantize (it does not need to be aligned).
+ * \param number Number of values.
+ * \param bits Bits of a value in in (8, 16 or 32), or FFT_FIXED_BITS for Q31 integers preceded by their scale.
+ * \param out Float array of number values.
+ * \return number of 4 bytes words read, -1 if it FAILED.
+ */
+
+int fftDequantize(void* in,unsigned int number,unsigned int bits,float* out)
+{
+    const char* cursor = (const char*)in;
+    if (bits == 32)
+    {
+        memcpy(out,cursor,number*sizeof(float));
+        return (int)number;
+    }
+    if (bits == FFT_FIXED_BITS)
+    {
+        float scale;
+        memcpy(&scale,cursor,sizeof(scale));
+        fftFixedToFloat(cursor + sizeof(scale),number,scale,out);
+        return (int)fftQuantizeWords(number,bits);
+    }
+    if (bits != 8 && bits != 16)
+    {
+        perror("Error : A coefficient must be quantized on 8, 16 or 32 bits\n");
+        return -1;
+    }
+    float parameters[2];
+    memcpy(parameters,cursor,sizeof(parameters));
+    cursor += sizeof(parameters);
+    float minimum = parameters[0], scale = parameters[1];
+    for(unsigned int i=0;i<number;i+=FFT_QUANTIZE_CHUNK)
+    {
+        unsigned int chunk = (number-i < FFT_QUANTIZE_CHUNK) ? number-i : FFT_QUANTIZE_CHUNK;
+        if (bits == 16)
+        {
+            uint16_t values[FFT_QUANTIZE_CHUNK];
+            memcpy(values,cursor,chunk*sizeof(uint16_t));
+            cursor += chunk*sizeof(uint16_t);
+            for(unsigned int j=0;j<chunk;j++)
+            {
+                out[i+j] = minimum + (float)values[j]*scale;
+            }
+        }
+        else
+        {
+            uint8_t values[FFT_QUANTIZE_CHUNK];
+            memcpy(values,cursor,chunk*sizeof(uint8_t));
+            cursor += chunk*sizeof(uint8_t);
+            for(unsigned int j=0;j<chunk;j++)
+            {
+                out[i+j] = minimum + (float)values[j]*scale;
+            }
+        }
+    }
+    return (int)fftQuantizeWords(number,bits);
+}
+
+/**
+ * \fn static int compareCosts(const void* a,const void* b)
+ * \brief Order the costs of the frequencies by increasing cost, then by decreasing index.
+ */
+
+static int compareCosts(const void* a,const void* b)
+{
+    const FftCost* costA = (const FftCost*)a;
+    const FftCost* costB = (const FftCost*)b;
+    if (costA->cost != costB->cost)
+        return (costA->cost < costB->cost) ? -1 : 1;
+    return (costA->index < costB->index) ? 1 : -1;
+}
 
 /**
- * \fn float* fftLow(float* array,unsigned int size)
- * \brief Compress the float array into frequency data and return an array with only Low frequencies.
+ * \fn static int selectBuffers(FftWorkspace* workspace)
+ * \brief Allocate the buffers of fftSelect and dctSelect in a workspace, if it was not done before.
  *
- * \param array Float Array to compress.
- * \param size Size of the array uncompressed.
- * \return An float array with only Low frequencies.
+ * \return 0 if it SUCCESSED, -1 if it FAILED.
  */
 
-float* fftLow(float* array,unsigned int size) {
-    //FFT LOW FREQ
-    kiss_fft_cpx out_cpx[size],*cpx_buf;
-    kiss_fftr_cfg fft = kiss_fftr_alloc(size*2 ,0 ,0,0);
-    cpx_buf = copycpx(array,size);
-    kiss_fftr(fft,(kiss_fft_scalar*)cpx_buf, out_cpx);
+static int selectBuffers(FftWorkspace* workspace)
+{
+    if (workspace->costs != NULL)
+        return 0;
+    unsigned int size = workspace->size, maskWords = (size+31)/32;
+    /*One allocation for the costs, the DCT twiddles, the DCT coefficients and the mask*/
+    workspace->costs = (FftCost*)malloc(size*sizeof(FftCost) + size*sizeof(kiss_fft_cpx) + size*sizeof(float) + maskWords*sizeof(uint32_t));
+    if (workspace->costs == NULL)
+    {
+        perror("Error : Memory allocation impossible for the costs\n");
+        return -1;
+    }
+    workspace->twiddles = (kiss_fft_cpx*)(workspace->costs + size);
+    workspace->dct = (float*)(workspace->twiddles + size);
+    workspace->mask = (uint32_t*)(workspace->dct + size);
+    for(unsigned int k=0;k<size;k++)
+    {
+        workspace->twiddles[k].r = (float)cos(M_PI*k/(2.*size));
+        workspace->twiddles[k].i = (float)-sin(M_PI*k/(2.*size));
+    }
+    return 0;
+}
 
-    int newSize = ((size+2)/2)+((size+2)/2)%2;
-    float* newArray;
-    newArray = (float*)malloc(newSize*sizeof(float));
-	if (newArray == NULL)
-	{
-		perror("Error : Memory allocation impossible for newArray\n");
-		return NULL;
-	}
-    for(int i=0;i<newSize/2;i++)
+/**
+ * \fn static double quantizationError(const float* values,unsigned int number,unsigned int bits)
+ * \brief Bound of the error of fftQuantize on any subset of number values quantized with bits bits.
+ *
+ * The scale of the kept values is lower than the one of all the values : the error is half of the scale of all
+ * the values, plus the rounding of the dequantized floats.
+ *
+ * \return the largest error of a quantized value, 0 with 32 bits.
+ */
+
+static double quantizationError(const float* values,unsigned int number,unsigned int bits)
+{
+    if (bits == 32 || number == 0)
+        return 0.;
+    float minimum = values[0], maximum = values[0];
+    for(unsigned int i=1;i<number;i++)
     {
-        newArray[i] = out_cpx[i].r;
+        minimum = (values[i] < minimum) ? values[i] : minimum;
+        maximum = (values[i] > maximum) ? values[i] : maximum;
     }
-    int g = 0;
-    for(int i=newSize/2;i<newSize;i++)
+    double levels = (bits == 8) ? 255. : 65535.;
+    double largest = (fabs(minimum) > fabs(maximum)) ? fabs(minimum) : fabs(maximum);
+    return ((double)maximum - minimum)/(2.*levels) + 2.*largest*FLT_EPSILON;
+}
+
+/**
+ * \fn static unsigned int selectMask(FftWorkspace* workspace,unsigned int number,Select_mode selection,double budget,double keptCost)
+ * \brief Drop the coefficients of the costs of the workspace while the sum of their costs stays under budget.
+ *
+ * The number costs (cost and index of each coefficient, by increasing index) are sorted, and the mask of the
+ * workspace receives a bit set for each kept coefficient. A kept coefficient costs keptCost (its quantization error) :
+ * a coefficient cheaper than keptCost is always dropped, even when the budget can not be met.
+ *
+ * \return the number of kept coefficients.
+ */
+
+static unsigned int selectMask(FftWorkspace* workspace,unsigned int number,Select_mode selection,double budget,double keptCost)
+{
+    FftCost* costs = workspace->costs;
+    unsigned int maskWords = (number+31)/32;
+    /*With BAND, the coefficients are dropped from the highest one; with TOP_K, from the smallest one*/
+    if (selection == TOP_K)
+        qsort(costs,number,sizeof(FftCost),compareCosts);
+    else
     {
-        newArray[i] = out_cpx[g].i;
-        g++;
+        for(unsigned int k=0;k<number/2;k++)
+        {
+            FftCost cost = costs[k];
+            costs[k] = costs[number-1-k];
+            costs[number-1-k] = cost;
+        }
+    }
+    unsigned int dropped = 0;
+    double error = number*keptCost;
+    while (dropped < number && (costs[dropped].cost <= keptCost || error - keptCost + costs[dropped].cost <= budget))
+    {
+        error += costs[dropped].cost - keptCost;
+        dropped++;
+    }
+    uint32_t* mask = workspace->mask;
+    memset(mask,0xff,maskWords*sizeof(uint32_t));
+    for(unsigned int k=0;k<dropped;k++)
+    {
+        mask[costs[k].index/32] &= ~((uint32_t)1 << (costs[k].index%32));
     }
+    mask[maskWords-1] &= (number%32 == 0) ? ~(uint32_t)0 : (((uint32_t)1 << (number%32)) - 1);
+    return number-dropped;
+}
 
-    free(fft);
-    free(cpx_buf);
-    return newArray;
+/**
+ * \fn int fftSelect(FftWorkspace* workspace,float* low,float* high,Select_mode selection,Error_type errorType,float bound,unsigned int bits,void* out)
+ * \brief Keep the fewest frequencies of a bloc for which the error of the data stays under bound.
+ *
+ * The error of the dropped frequencies is known without inverse FFT : with X the frequencies of a bloc of N data
+ * and w(k) = 1 for the frequencies 0 and N/2 (N even), 2 for the others (their conjugates are dropped too), the
+ * RMS error is sqrt(sum(w(k)|X(k)|^2))/N (Parseval) and the max error is lower than sum(w(k)|X(k)|)/N.
+ * out receives a mask of (size/2+1+31)/32 words (bit k%32 of word k/32 set when the frequency k is kept), then the
+ * real and imaginary parts of the kept frequencies by increasing frequency, written by fftQuantize with bits bits.
+ * out does not need to be aligned. The error of the quantization (see fftQuantize) is included in bound : with bits
+ * 8 or 16, each kept frequency adds the error of its two quantized parts, and the frequencies smaller than it are
+ * dropped. When even the kept frequencies alone exceed bound, the error is the smallest one reachable.
+ *
+ * \param workspace Workspace of the size of the array UNcompressed (forward or inverse).
+ * \param low Float Array compressed by fftLow function.
+ * \param high Float Array compressed by fftHigh function.
+ * \param selection TOP_K to drop the smallest frequencies, BAND to drop the highest frequencies.
+ * \param errorType RMS_ERROR or MAX_ERROR.
+ * \param bound Error allowed on the data of the bloc.
+ * \param bits Bits of a kept value (8, 16 or 32, see fftQuantize).
+ * \param out Buffer receiving the mask and the kept frequencies, NULL to get their size only.
+ * \return number of 4 bytes words of out, -1 if it FAILED.
+ */
+
+int fftSelect(FftWorkspace* workspace,float* low,float* high,Select_mode selection,Error_type errorType,float bound,unsigned int bits,void* out)
+{
+    if (workspace == NULL || low == NULL || high == NULL)
+    {
+        perror("Error : A workspace and the Low and High arrays are needed\n");
+        return -1;
+    }
+    if (bits != 8 && bits != 16 && bits != 32)
+    {
+        perror("Error : A coefficient must be quantized on 8, 16 or 32 bits\n");
+        return -1;
+    }
+    if (selectBuffers(workspace) != 0)
+        return -1;
+    unsigned int size = workspace->size, binNumber = size/2+1;
+    unsigned int maskWords = (binNumber+31)/32;
+    kiss_fft_cpx* bins = workspace->bins;
+    FftCost* costs = workspace->costs;
+    unpackBins(bins,low,high,size);
+    for(unsigned int k=0;k<binNumber;k++)
+    {
+        double weight = (k == 0 || (size%2 == 0 && k == size/2)) ? 1. : 2.;
+        double square = (double)bins[k].r*bins[k].r + (double)bins[k].i*bins[k].i;
+        costs[k].cost = (errorType == RMS_ERROR) ? weight*square : weight*sqrt(square);
+        costs[k].index = k;
+    }
+    double budget = (errorType == RMS_ERROR) ? ((double)bound*size)*((double)bound*size) : (double)bound*size;
+    /*A kept frequency has an error on its real and imaginary parts, counted with the weight 2*/
+    double quantization = quantizationError((const float*)bins,2*binNumber,bits);
+    double keptCost = (errorType == RMS_ERROR) ? 4.*quantization*quantization : 2.*M_SQRT2*quantization;
+    unsigned int kept = selectMask(workspace,binNumber,selection,budget,keptCost);
+    unsigned int words = maskWords + fftQuantizeWords(2*kept,bits);
+    if (out == NULL)
+        return (int)words;
+    uint32_t* mask = workspace->mask;
+    char* cursor = (char*)out;
+    memcpy(cursor,mask,maskWords*sizeof(uint32_t));
+    cursor += maskWords*sizeof(uint32_t);
+    /*The kept frequencies are moved to the front of bins, then written together*/
+    kept = 0;
+    for(unsigned int k=0;k<binNumber;k++)
+    {
+        if (mask[k/32] & ((uint32_t)1 << (k%32)))
+            bins[kept++] = bins[k];
+    }
+    fftQuantize((float*)bins,2*kept,bits,cursor);
+    return (int)words;
 }
 
 /**
- * \fn float* fftHigh(float* array,unsigned int size)
- * \brief Compress the float array into frequency data and return an array with only High frequencies.
+ * \fn int ifftSelect(FftWorkspace* workspace,void* in,unsigned int bits,float* dataOut)
+ * \brief Transform the mask and the frequencies written by fftSelect into the data of the bloc.
  *
- * \param array Float Array to compress.
- * \param size Size of the array uncompressed.
- * \return An float array with only High frequencies.
+ * \param workspace Inverse workspace (fftWorkspaceAcquire(size,1)) of the size of the array UNcompressed.
+ * \param in Buffer written by fftSelect (it does not need to be aligned).
+ * \param bits Bits of a kept value given to fftSelect.
+ * \param dataOut Float array of size "size" in which the data is written (no allocation).
+ * \return number of 4 bytes words read from in, -1 if it FAILED.
  */
 
-float* fftHigh(float* array,unsigned int size) {
-    //FFT HIGH FREQ
-    kiss_fft_cpx out_cpx[size],*cpx_buf;
-    kiss_fftr_cfg fft = kiss_fftr_alloc(size*2 ,0 ,0,0);
-    cpx_buf = copycpx(array,size);
-    kiss_fftr(fft,(kiss_fft_scalar*)cpx_buf, out_cpx);
-    int newSize = ((size)/2)+((size)/2)%2;
-    int stop = (size-1)/2+(size-1)%2+1;
-    float *newArray;
-    newArray = (float*)malloc(newSize*sizeof(float));
-	if (newArray == NULL)
-	{
-		perror("Error : Memory allocation impossible for newArray\n");
-		return NULL;
-	}
-    int g =0;
-    for(int i=stop-newSize/2;i<stop;i++)
+int ifftSelect(FftWorkspace* workspace,void* in,unsigned int bits,float* dataOut)
+{
+    if (workspace == NULL || workspace->inverse != 1)
     {
-        newArray[g] = out_cpx[i].r;
-        g++;
+        perror("Error : An inverse workspace is needed\n");
+        return -1;
     }
-    for(int i=stop-newSize/2;i<stop;i++)
+    unsigned int size = workspace->size, binNumber = size/2+1, maskWords = (binNumber+31)/32;
+    kiss_fft_cpx* bins = workspace->bins;
+    uint32_t mask = 0;
+    unsigned int kept = 0;
+    for(unsigned int w=0;w<maskWords;w++)
     {
-        newArray[g] = out_cpx[i].i;
-        g++;
+        memcpy(&mask,(const char*)in + w*sizeof(uint32_t),sizeof(uint32_t));
+        for(;mask != 0;mask &= mask-1)
+            kept++;
     }
+    /*The kept frequencies are read at the front of bins, then moved to their place from the highest one*/
+    int words = fftDequantize((char*)in + maskWords*sizeof(uint32_t),2*kept,bits,(float*)bins);
+    if (words < 0)
+        return -1;
+    for(unsigned int k=binNumber;k-->0;)
+    {
+        if (k%32 == 31 || k == binNumber-1)
+            memcpy(&mask,(const char*)in + (k/32)*sizeof(uint32_t),sizeof(uint32_t));
+        if (mask & ((uint32_t)1 << (k%32)))
+            bins[k] = bins[--kept];
+        else
+        {
+            bins[k].r = 0.;
+            bins[k].i = 0.;
+        }
+    }
+    inverseBins(workspace,dataOut);
+    return (int)maskWords + words;
+}
 
-    free(fft);
-    free(cpx_buf);
-    return newArray;
+/**
+ * \fn int dctBloc(FftWorkspace* workspace,float* data,float* coefficients)
+ * \brief Write the orthonormal DCT-II of the data of a bloc into coefficients, with one FFT of the size of the bloc.
+ *
+ * The data are reordered (even indexes, then odd indexes backward) into v, and the coefficient k is
+ * Re(exp(-i*pi*k/(2N))*V(k)) with V the FFT of v (Makhoul), times sqrt(1/N) for k = 0 and sqrt(2/N) for the others.
+ *
+ * \param workspace Forward workspace (fftWorkspaceAcquire(size,0)) of the size of the bloc.
+ * \param data Float array of size "size".
+ * \param coefficients Float array of size "size" (not data) receiving the coefficients.
+ * \return 0 if it SUCCESSED, -1 if it FAILED.
+ */
+
+int dctBloc(FftWorkspace* workspace,float* data,float* coefficients)
+{
+    if (workspace == NULL || workspace->inverse != 0)
+    {
+        perror("Error : A forward workspace is needed\n");
+        return -1;
+    }
+    if (selectBuffers(workspace) != 0)
+        return -1;
+    unsigned int size = workspace->size;
+    for(unsigned int n=0;2*n<size;n++)
+    {
+        coefficients[n] = data[2*n];
+    }
+    for(unsigned int n=0;2*n+1<size;n++)
+    {
+        coefficients[size-1-n] = data[2*n+1];
+    }
+    transformBins(workspace,coefficients);
+    kiss_fft_cpx* bins = workspace->bins;
+    kiss_fft_cpx* twiddles = workspace->twiddles;
+    float first = (float)sqrt(1./size), other = (float)sqrt(2./size);
+    for(unsigned int k=0;k<size;k++)
+    {
+        /*The frequencies over size/2 are the conjugates of the first ones*/
+        float r = (k <= size/2) ? bins[k].r : bins[size-k].r;
+        float i = (k <= size/2) ? bins[k].i : -bins[size-k].i;
+        coefficients[k] = (twiddles[k].r*r - twiddles[k].i*i)*((k == 0) ? first : other);
+    }
+    return 0;
 }
 
 /**
- * \fn float* fftAll(float* array,unsigned int size)
- * \brief Transform the float array into frequency data and return an array with all frequencies.
+ * \fn int idctBloc(FftWorkspace* workspace,float* coefficients,float* dataOut)
+ * \brief Write the data of a bloc from its orthonormal DCT-II coefficients (DCT-III), with one inverse FFT.
  *
- * \param array Float Array to compress.
- * \param size Size of the array uncompressed.
- * \return An float array with all frequencies.
+ * \param workspace Inverse workspace (fftWorkspaceAcquire(size,1)) of the size of the bloc.
+ * \param coefficients Float array of size "size" written by dctBloc.
+ * \param dataOut Float array of size "size" (not coefficients) receiving the data.
+ * \return 0 if it SUCCESSED, -1 if it FAILED.
  */
 
-float* fftAll(float* array,unsigned int size) {
-    //FFT ALL
-    kiss_fft_cpx out_cpx[size],*cpx_buf;
-    kiss_fftr_cfg fft = kiss_fftr_alloc(size*2 ,0 ,0,0);
-    cpx_buf = copycpx(array,size);
-    kiss_fftr(fft,(kiss_fft_scalar*)cpx_buf, out_cpx);
+int idctBloc(FftWorkspace* workspace,float* coefficients,float* dataOut)
+{
+    if (workspace == NULL || workspace->inverse != 1)
+    {
+        perror("Error : An inverse workspace is needed\n");
+        return -1;
+    }
+    if (selectBuffers(workspace) != 0)
+        return -1;
+    unsigned int size = workspace->size;
+    kiss_fft_cpx* bins = workspace->bins;
+    kiss_fft_cpx* twiddles = workspace->twiddles;
+    float first = (float)sqrt((double)size), other = (float)sqrt(size/2.);
+    /*V(k) = exp(i*pi*k/(2N))*(y(k) - i*y(N-k)) with y the coefficients without the orthonormal factors and y(N) = 0*/
+    for(unsigned int k=0;k<=size/2;k++)
+    {
+        float a = coefficients[k]*((k == 0) ? first : other);
+        float b = (k == 0) ? 0.f : coefficients[size-k]*other;
+        bins[k].r = a*twiddles[k].r - b*twiddles[k].i;
+        bins[k].i = -a*twiddles[k].i - b*twiddles[k].r;
+    }
+    float* v = workspace->dct;
+    inverseBins(workspace,v);
+    for(unsigned int n=0;2*n<size;n++)
+    {
+        dataOut[2*n] = v[n];
+    }
+    for(unsigned int n=0;2*n+1<size;n++)
+    {
+        dataOut[2*n+1] = v[size-1-n];
+    }
+    return 0;
+}
 
-    float* newArray;
-    newArray = (float*)malloc((2*(size/2)+2)*sizeof(float));
-	if (newArray == NULL)
-	{
-		perror("Error : Memory allocation impossible for newArray\n");
-		return NULL;
-	}
-    for(unsigned int i=0;i<size/2+1;i++)
+/**
+ * \fn int dctSelect(FftWorkspace* workspace,float* data,Select_mode selection,Error_type errorType,float bound,unsigned int bits,void* out)
+ * \brief Keep the fewest DCT-II coefficients of a bloc for which the error of the data stays under bound.
+ *
+ * The DCT is orthonormal : the RMS error is sqrt(sum(c(k)^2)/N) over the dropped coefficients, and the max error is
+ * lower than sum(|c(k)|*w(k)) with w(0) = sqrt(1/N) and w(k) = sqrt(2/N). out receives a mask of (size+31)/32 words,
+ * then the kept coefficients by increasing index, written by fftQuantize with bits bits. The error of the
+ * quantization is included in bound, as with fftSelect.
+ *
+ * \param workspace Forward workspace of the size of the bloc.
+ * \param data Float array of size "size".
+ * \param selection TOP_K to drop the smallest coefficients, BAND to drop the highest coefficients.
+ * \param errorType RMS_ERROR or MAX_ERROR.
+ * \param bound Error allowed on the data of the bloc.
+ * \param bits Bits of a kept value (8, 16 or 32, see fftQuantize).
+ * \param out Buffer receiving the mask and the kept coefficients, NULL to get their size only.
+ * \return number of 4 bytes words of out, -1 if it FAILED.
+ */
+
+int dctSelect(FftWorkspace* workspace,float* data,Select_mode selection,Error_type errorType,float bound,unsigned int bits,void* out)
+{
+    if (bits != 8 && bits != 16 && bits != 32)
     {
-        newArray[i] = out_cpx[i].r;
+        perror("Error : A coefficient must be quantized on 8, 16 or 32 bits\n");
+        return -1;
     }
-    int g = 0;
-    for(unsigned int i=size/2+1;i<2*(size/2)+2;i++)
+    if (workspace == NULL || selectBuffers(workspace) != 0 || dctBloc(workspace,data,workspace->dct) != 0)
+        return -1;
+    unsigned int size = workspace->size, maskWords = (size+31)/32;
+    float* coefficients = workspace->dct;
+    FftCost* costs = workspace->costs;
+    double first = sqrt(1./size), other = sqrt(2./size);
+    for(unsigned int k=0;k<size;k++)
     {
-        newArray[i] = out_cpx[g].i;
-        g++;
+        double value = coefficients[k];
+        costs[k].cost = (errorType == RMS_ERROR) ? value*value : fabs(value)*((k == 0) ? first : other);
+        costs[k].index = k;
     }
-    free(fft);
-    free(cpx_buf);
-    return newArray;
+    double budget = (errorType == RMS_ERROR) ? (double)bound*bound*size : (double)bound;
+    double quantization = quantizationError(coefficients,size,bits);
+    double keptCost = (errorType == RMS_ERROR) ? quantization*quantization : quantization*other;
+    unsigned int kept = selectMask(workspace,size,selection,budget,keptCost);
+    unsigned int words = maskWords + fftQuantizeWords(kept,bits);
+    if (out == NULL)
+        return (int)words;
+    uint32_t* mask = workspace->mask;
+    char* cursor = (char*)out;
+    memcpy(cursor,mask,maskWords*sizeof(uint32_t));
+    cursor += maskWords*sizeof(uint32_t);
+    kept = 0;
+    for(unsigned int k=0;k<size;k++)
+    {
+        if (mask[k/32] & ((uint32_t)1 << (k%32)))
+            coefficients[kept++] = coefficients[k];
+    }
+    fftQuantize(coefficients,kept,bits,cursor);
+    return (int)words;
 }
 
 /**
- * \fn float* ifftLow(float* newArray,unsigned int size)
- * \brief Transform the frequency array previously compressed by fftLow function into data array.
+ * \fn int idctSelect(FftWorkspace* workspace,void* in,unsigned int bits,float* dataOut)
+ * \brief Transform the mask and the coefficients written by dctSelect into the data of the bloc.
  *
- * \param newArray Float Array compressed by fftLow function.
- * \param size Size of the array UNcompressed.
- * \return An float arraywith Low frequency data of size "size"
+ * \param workspace Inverse workspace (fftWorkspaceAcquire(size,1)) of the size of the bloc.
+ * \param in Buffer written by dctSelect (it does not need to be aligned).
+ * \param bits Bits of a kept value given to dctSelect.
+ * \param dataOut Float array of size "size" in which the data is written.
+ * \return number of 4 bytes words read from in, -1 if it FAILED.
  */
 
-float* ifftLow(float* newArray,unsigned int size) {
-    //IFFT LOW FREQ
-    float* dataOut;
-    dataOut = (float*)malloc(size*sizeof(float));
-	if (dataOut == NULL)
-	{
-		perror("Error : Memory allocation impossible for dataOut\n");
-		return NULL;
-	}
-    int isinverse = 1;
-    kiss_fft_cpx out[size], new_out_cpx[size];
-    kiss_fftr_cfg ifft = kiss_fftr_alloc(size*2,isinverse,0,0);
-    unsigned int newSize = ((size+2)/2)+((size+2)/2)%2;
-    for(unsigned int i=0;i<size+1;i++)
+int idctSelect(FftWorkspace* workspace,void* in,unsigned int bits,float* dataOut)
+{
+    if (workspace == NULL || workspace->inverse != 1)
     {
-        new_out_cpx[i].r = 0.;
-        new_out_cpx[i].i = 0.;
+        perror("Error : An inverse workspace is needed\n");
+        return -1;
     }
-    for(unsigned int i=0;i<newSize/2;i++)
+    if (selectBuffers(workspace) != 0)
+        return -1;
+    unsigned int size = workspace->size, maskWords = (size+31)/32;
+    float* coefficients = workspace->dct;
+    uint32_t mask = 0;
+    unsigned int kept = 0;
+    for(unsigned int w=0;w<maskWords;w++)
     {
-        new_out_cpx[i].r = newArray[i];
-        new_out_cpx[size-i].r = newArray[i];
-        new_out_cpx[i].i = newArray[i+newSize/2];
-        new_out_cpx[size-i].i = -newArray[i+newSize/2];
+        memcpy(&mask,(const char*)in + w*sizeof(uint32_t),sizeof(uint32_t));
+        for(;mask != 0;mask &= mask-1)
+            kept++;
+    }
+    /*The kept coefficients are read at the front, then moved to their place from the highest one*/
+    int words = fftDequantize((char*)in + maskWords*sizeof(uint32_t),kept,bits,coefficients);
+    if (words < 0)
+        return -1;
+    for(unsigned int k=size;k-->0;)
+    {
+        if (k%32 == 31 || k == size-1)
+            memcpy(&mask,(const char*)in + (k/32)*sizeof(uint32_t),sizeof(uint32_t));
+        coefficients[k] = (mask & ((uint32_t)1 << (k%32))) ? coefficients[--kept] : 0.f;
+    }
+    if (idctBloc(workspace,coefficients,dataOut) != 0)
+        return -1;
+    return (int)maskWords + words;
+}
+
+/**
+ * \fn static void binAt(float* low,float* high,unsigned int size,unsigned int k,float* r,float* i)
+ * \brief Read the frequency k (0 to size/2) of a bloc from its fftLow and fftHigh arrays (they split the frequencies).
+ */
+
+static void binAt(float* low,float* high,unsigned int size,unsigned int k,float* r,float* i)
+{
+    unsigned int sizeL = ((size+2)/2)+((size+2)/2)%2;
+    unsigned int sizeH = ((size)/2)+((size)/2)%2;
+    if (k < sizeL/2)
+    {
+        *r = low[k];
+        *i = low[k+sizeL/2];
+        return;
     }
-    kiss_fftri(ifft,new_out_cpx,(kiss_fft_scalar*)out );
+    k -= (size-1)/2+(size-1)%2-sizeH/2+1;
+    *r = high[k];
+    *i = high[k+sizeH/2];
+}
 
-    for(unsigned int i=0;i<size;i++)
+/**
+ * \fn static double phasorSum(const float* re,const float* im,unsigned int number,unsigned int first,unsigned int t,unsigned int size)
+ * \brief Return the sum of re[j]*cos(a) - im[j]*sin(a), with a = 2*pi*(first+j)*t/size, for j from 0 to number-1.
+ *
+ * The angle of a frequency is the angle of the previous one plus a constant : cos and sin are only called for the
+ * first frequencies, then phasors are rotated. Four phasors are rotated together, so the rotations don't wait for each other.
+ */
+
+static double phasorSum(const float* re,const float* im,unsigned int number,unsigned int first,unsigned int t,unsigned int size)
+{
+    double c[4], s[4], sums[4] = {0, 0, 0, 0}, next;
+    /*The angles are reduced modulo 2*pi in integers to keep their precision*/
+    double rotation = 2*M_PI*(double)((4ul*t)%size)/size;
+    double rotationCos = cos(rotation), rotationSin = sin(rotation);
+    unsigned int j = 0;
+    for(unsigned int l=0;l<4;l++)
     {
-        dataOut[i] = (out[i].r)/(size*2);
+        double angle = 2*M_PI*(double)(((unsigned long)(first+l)*t)%size)/size;
+        c[l] = cos(angle);
+        s[l] = sin(angle);
     }
-    //free(newArray);
-    free(ifft);
-    return dataOut;
+    for(;j+4<=number;j+=4)
+    {
+        for(unsigned int l=0;l<4;l++)
+        {
+            sums[l] += re[j+l]*c[l] - im[j+l]*s[l];
+            next = c[l]*rotationCos - s[l]*rotationSin;
+            s[l] = s[l]*rotationCos + c[l]*rotationSin;
+            c[l] = next;
+        }
+    }
+    for(unsigned int l=0;j<number;j++,l++)
+        sums[l] += re[j]*c[l] - im[j]*s[l];
+    return sums[0] + sums[1] + sums[2] + sums[3];
 }
 
 /**
- * \fn float* ifftHigh(float* newArray,unsigned int size)
- * \brief Transform the frequency array previously compressed by fftHigh function into data array.
+ * \fn double fftBlocData(float* low,float* high,unsigned int size,unsigned int t)
+ * \brief Return the data t of a bloc from its fftLow and fftHigh arrays, without inverse transform.
  *
- * \param newArray Float Array compressed by fftHigh function.
- * \param size Size of the array UNcompressed.
- * \return An float array with High frequency data of size "size"
+ * \param low Float Array compressed by fftLow function.
+ * \param high Float Array compressed by fftHigh function.
+ * \param size Size of the bloc uncompressed.
+ * \param t Index of the data in the bloc (0 to size-1).
+ * \return the data t, computed in O(size).
  */
 
-float* ifftHigh(float* newArray,unsigned int size)
+double fftBlocData(float* low,float* high,unsigned int size,unsigned int t)
+{
+    unsigned int sizeL = ((size+2)/2)+((size+2)/2)%2;
+    unsigned int sizeH = ((size)/2)+((size)/2)%2;
+    unsigned int lowNumber = (sizeL/2 < size/2+1) ? sizeL/2 : size/2+1;
+    unsigned int highFirst = sizeL/2-((size-1)/2+(size-1)%2-sizeH/2+1);
+    double value;
+    float r, i;
+    /*The frequencies 1 to size/2 are counted twice, they stand for their conjugates*/
+    value = 2*phasorSum(low,low+sizeL/2,lowNumber,0,t,size) - low[0];
+    if (size/2+1 > lowNumber)
+        value += 2*phasorSum(high+highFirst,high+highFirst+sizeH/2,size/2+1-lowNumber,lowNumber,t,size);
+    if (size%2 == 0)
+    {
+        binAt(low,high,size,size/2,&r,&i);
+        value -= (t%2 == 0) ? r : -r;
+    }
+    return value/size;
+}
+
+/**
+ * \fn int fftBlocMoments(float* low,float* high,unsigned int size,double* sum,double* square)
+ * \brief Add the sum and the sum of squares of the data of a bloc to sum and square, from its frequencies.
+ *
+ * The sum of the size data is the frequency 0 and the sum of their squares follows from Parseval : both cost O(size)
+ * without inverse transform.
+ *
+ * \param low Float Array compressed by fftLow function.
+ * \param high Float Array compressed by fftHigh function.
+ * \param size Size of the bloc uncompressed.
+ * \param sum Receive the sum of the data (added to its value).
+ * \param square Receive the sum of the squares of the data (added to its value).
+ * \return 0 if it SUCCESSED, -1 if it FAILED.
+ */
+
+int fftBlocMoments(float* low,float* high,unsigned int size,double* sum,double* square)
+{
+    if (low == NULL || high == NULL || sum == NULL || square == NULL)
+    {
+        perror("Error : The arrays and the sums are needed\n");
+        return -1;
+    }
+    unsigned int sizeL = ((size+2)/2)+((size+2)/2)%2;
+    unsigned int sizeH = ((size)/2)+((size)/2)%2;
+    double blocSquare = 0;
+    float r, i;
+    /*Each value of the arrays is a part of one frequency, counted twice but for the frequencies 0 and size/2*/
+    for(unsigned int k=0;k<sizeL;k++)
+        blocSquare += (double)low[k]*low[k];
+    for(unsigned int k=0;k<sizeH;k++)
+        blocSquare += (double)high[k]*high[k];
+    blocSquare = 2*blocSquare - (double)low[0]*low[0];
+    if (size%2 == 0)
+    {
+        binAt(low,high,size,size/2,&r,&i);
+        blocSquare -= (double)r*r;
+    }
+    *sum += low[0];
+    *square += blocSquare/size;
+    return 0;
+}
+
+/**
+ * \fn int fftBlocBands(float* low,float* high,unsigned int size,const float* edges,unsigned int bandNumber,double* powers)
+ * \brief Add the power of each frequency band of a bloc to powers, from its frequencies (Parseval).
+ *
+ * The power of a band is the mean of the squares of the size data of the bloc due to its frequencies : the powers of
+ * bands covering 0 to 0.5 add up to the mean of the squares of the bloc (its mean squared is in the band of 0).
+ *
+ * \param low Float Array compressed by fftLow function.
+ * \param high Float Array compressed by fftHigh function.
+ * \param size Size of the bloc uncompressed.
+ * \param edges bandNumber+1 increasing frequencies in cycles per data (0 to 0.5) : band b is [edges[b], edges[b+1]), the last band includes its upper edge.
+ * \param bandNumber Number of bands.
+ * \param powers Array of bandNumber values receiving the powers (added to their values).
+ * \return 0 if it SUCCESSED, -1 if it FAILED.
+ */
+
+int fftBlocBands(float* low,float* high,unsigned int size,const float* edges,unsigned int bandNumber,double* powers)
+{
+    if (low == NULL || high == NULL || edges == NULL || powers == NULL || bandNumber == 0)
+    {
+        perror("Error : The arrays and at least one band are needed\n");
+        return -1;
+    }
+    unsigned int band = 0;
+    float r, i;
+    for(unsigned int k=0;k<=size/2;k++)
+    {
+        double frequency = (double)k/size;
+        if (frequency < edges[0])
+            continue;
+        while (band < bandNumber-1 && frequency >= edges[band+1])
+            band++;
+        if (frequency > edges[bandNumber])
+            break;
+        binAt(low,high,size,k,&r,&i);
+        powers[band] += ((k == 0 || 2*k == size) ? 1 : 2)*((double)r*r + (double)i*i)/((double)size*size);
+    }
+    return 0;
+}
+
+/**
+ * \fn static float* inverseArray(float* low,float* high,unsigned int size)
+ * \brief Return the data of the arrays of a bloc compressed by fftLow and/or fftHigh (NULL if not kept).
+ */
+
+static float* inverseArray(float* low,float* high,unsigned int size)
 {
-    //IFFT HIGH FREQ
     float* dataOut;
     dataOut = (float*)malloc(size*sizeof(float));
 	if (dataOut == NULL)
@@ -195,33 +1494,46 @@ float* ifftHigh(float* newArray,unsigned int size)
 		perror("Error : Memory allocation impossible for dataOut\n");
 		return NULL;
 	}
-    int isinverse = 1;
-    kiss_fft_cpx out[size], new_out_cpx[size];
-    kiss_fftr_cfg ifft = kiss_fftr_alloc(size*2,isinverse,0,0);
-    unsigned int newSize = ((size)/2)+((size)/2)%2;
-    unsigned int stop = (size-1)/2+(size-1)%2;
-    for(unsigned int i=0;i<size+1;i++)
+    FftWorkspace* workspace = fftWorkspaceAcquire(size,1);
+    if (ifftBloc(workspace,low,high,dataOut) != 0)
     {
-        new_out_cpx[i].r = 0.;
-        new_out_cpx[i].i = 0.;
+        fftWorkspaceRelease(workspace);
+        free(dataOut);
+        return NULL;
     }
-    for(unsigned int i=0;i<newSize/2;i++)
-    {
-        new_out_cpx[stop-newSize/2+i+1].r = newArray[i];
-        new_out_cpx[stop+newSize/2-i-1+size%2].r = newArray[i];
-        new_out_cpx[stop+newSize/2-i-1+size%2].i = -newArray[i+newSize/2];
-        new_out_cpx[stop-newSize/2+i+1].i = newArray[i+newSize/2];
-    }
-    kiss_fftri(ifft,new_out_cpx,(kiss_fft_scalar*)out );
-    for(unsigned int i=0;i<size;i++)
-    {
-        dataOut[i] = (out[i].r)/(size*2);
-    }
-    //free(newArray);
-    free(ifft);
+    fftWorkspaceRelease(workspace);
     return dataOut;
 }
 
+/**
+ * \fn float* ifftLow(float* newArray,unsigned int size)
+ * \brief Transform the frequency array previously compressed by fftLow function into data array.
+ *
+ * \param newArray Float Array compressed by fftLow function.
+ * \param size Size of the array UNcompressed.
+ * \return An float arraywith Low frequency data of size "size"
+ */
+
+float* ifftLow(float* newArray,unsigned int size) {
+    //IFFT LOW FREQ
+    return inverseArray(newArray,NULL,size);
+}
+
+/**
+ * \fn float* ifftHigh(float* newArray,unsigned int size)
+ * \brief Transform the frequency array previously compressed by fftHigh function into data array.
+ *
+ * \param newArray Float Array compressed by fftHigh function.
+ * \param size Size of the array UNcompressed.
+ * \return An float array with High frequency data of size "size"
+ */
+
+float* ifftHigh(float* newArray,unsigned int size)
+{
+    //IFFT HIGH FREQ
+    return inverseArray(NULL,newArray,size);
+}
+
 /**
  * \fn float* ifftAll(float* newArray,unsigned int size)
  * \brief Transform the frequency array previously compressed by fftAll function into data array.
@@ -241,25 +1553,19 @@ float* ifftAll(float* newArray,unsigned int size)
 		perror("Error : Memory allocation impossible for dataOut\n");
 		return NULL;
 	}
-    int isinverse = 1;
-    kiss_fft_cpx out[size], new_out_cpx[size];
-    kiss_fftr_cfg ifft = kiss_fftr_alloc(size*2,isinverse,0,0);
-
+    FftWorkspace* workspace = fftWorkspaceAcquire(size,1);
+    if (workspace == NULL)
+    {
+        free(dataOut);
+        return NULL;
+    }
+    kiss_fft_cpx* new_out_cpx = workspace->bins;
     for(unsigned int i=0;i<size/2+1;i++)
     {
         new_out_cpx[i].r = newArray[i];
-        new_out_cpx[size-i].r = newArray[i];
-        new_out_cpx[size-i].i = -newArray[i+size/2+1];
         new_out_cpx[i].i = newArray[i+size/2+1];
-
-    }
-    kiss_fftri(ifft,new_out_cpx,(kiss_fft_scalar*)out );
-
-    for(unsigned int i=0;i<size;i++)
-    {
-        dataOut[i] = (out[i].r)/(size*2);
     }
-    //free(newArray);
-    free(ifft);
+    inverseBins(workspace,dataOut);
+    fftWorkspaceRelease(workspace);
     return dataOut;
 }
@@ -11,6 +11,10 @@
 
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <math.h>
+#include <pthread.h>
 #include "fftStack.h"
 #include "fftFreq.h"
 
@@ -63,329 +67,1780 @@ void fftDeinitialize(FftStack* myFftStack)
 }
 
 
+/*Loops converting number data of a type into floats and back, one per Data_type. The data is converted by blocs of
+FFT_CONVERT_WIDTH so that the conversions into floats are vectorized without runtime checks from -O2 (the
+conversions back are not : their comparisons may raise floating point exceptions).*/
+#define FFT_CONVERT_WIDTH 8
+#define TO_FLOAT(type, i) values[i] = (float)in[i]
+#define FROM_FLOAT(type, min, max, i) \
+  do { float v = values[i]; \
+    out[i] = (v >= (float)(max)) ? (max) : (v > (float)(min)) ? (type)(v + ((v >= 0.f) ? 0.5f : -0.5f)) : (v != v) ? 0 : (min); } while (0)
+#define TO_FLOAT_LOOP(type) \
+  do { const type* in = (const type*)data; size_t i = 0; \
+    for (; i + FFT_CONVERT_WIDTH <= number; i += FFT_CONVERT_WIDTH) \
+      for (size_t j = i; j < i + FFT_CONVERT_WIDTH; j++) TO_FLOAT(type, j); \
+    for (; i < number; i++) TO_FLOAT(type, i); } while (0)
+#define FROM_FLOAT_LOOP(type, min, max) \
+  do { type* out = (type*)data; size_t i = 0; \
+    for (; i + FFT_CONVERT_WIDTH <= number; i += FFT_CONVERT_WIDTH) \
+      for (size_t j = i; j < i + FFT_CONVERT_WIDTH; j++) FROM_FLOAT(type, min, max, j); \
+    for (; i < number; i++) FROM_FLOAT(type, min, max, i); } while (0)
+
+/**
+ * \fn int fftDataToFloat(const void* data, Data_type dataType, size_t number, float* values)
+ * \brief Convert number data of a Data_type (as stored in an IdElement) into floats.
+ *
+ * \param data Array of number data of dataType (an LDOUBLE takes sizeDataType(LDOUBLE) bytes).
+ * \param dataType Type of the data, any type but CHAR.
+ * \param number Number of data.
+ * \param values Array of number floats receiving the data.
+ * \return 0 if it SUCCESSED, -1 if it FAILED.
+ */
+
+int fftDataToFloat(const void* data, Data_type dataType, size_t number, float* values)
+{
+  switch (dataType) {
+    case UINT8_T : TO_FLOAT_LOOP(uint8_t); break;
+    case INT8_T : TO_FLOAT_LOOP(int8_t); break;
+    case UINT16_T : TO_FLOAT_LOOP(uint16_t); break;
+    case INT16_T : TO_FLOAT_LOOP(int16_t); break;
+    case UINT32_T : TO_FLOAT_LOOP(uint32_t); break;
+    case INT32_T : TO_FLOAT_LOOP(int32_t); break;
+    case UINT64_T : TO_FLOAT_LOOP(uint64_t); break;
+    case INT64_T : TO_FLOAT_LOOP(int64_t); break;
+    case FLOAT : memmove(values, data, number*sizeof(float)); break;
+    case DOUBLE : TO_FLOAT_LOOP(double); break;
+    case LDOUBLE :
+      for (size_t i = 0; i < number; i++)
+      {
+        long double value = 0;
+        memcpy(&value, (const char*)data + i*sizeDataType(LDOUBLE), (sizeof(value) < (size_t)sizeDataType(LDOUBLE)) ? sizeof(value) : (size_t)sizeDataType(LDOUBLE));
+        values[i] = (float)value;
+      }
+      break;
+    default:
+      perror("Error : Only numbers can be converted into floats");
+      return -1;
+  }
+  return 0;
+}
+
+/**
+ * \fn int fftFloatToData(const float* values, size_t number, Data_type dataType, void* data)
+ * \brief Convert number floats into data of a Data_type, the reverse of fftDataToFloat.
+ *
+ * The floats are rounded to the nearest integer and saturated to the range of an integer type (NaN gives 0).
+ *
+ * \param values Array of number floats.
+ * \param number Number of data.
+ * \param dataType Type of the data, any type but CHAR.
+ * \param data Array receiving the number data of dataType.
+ * \return 0 if it SUCCESSED, -1 if it FAILED.
+ */
+
+int fftFloatToData(const float* values, size_t number, Data_type dataType, void* data)
+{
+  switch (dataType) {
+    case UINT8_T : FROM_FLOAT_LOOP(uint8_t, 0, UINT8_MAX); break;
+    case INT8_T : FROM_FLOAT_LOOP(int8_t, INT8_MIN, INT8_MAX); break;
+    case UINT16_T : FROM_FLOAT_LOOP(uint16_t, 0, UINT16_MAX); break;
+    case INT16_T : FROM_FLOAT_LOOP(int16_t, INT16_MIN, INT16_MAX); break;
+    case UINT32_T : FROM_FLOAT_LOOP(uint32_t, 0, UINT32_MAX); break;
+    case INT32_T : FROM_FLOAT_LOOP(int32_t, INT32_MIN, INT32_MAX); break;
+    case UINT64_T : FROM_FLOAT_LOOP(uint64_t, 0, UINT64_MAX); break;
+    case INT64_T : FROM_FLOAT_LOOP(int64_t, INT64_MIN, INT64_MAX); break;
+    case FLOAT : memmove(data, values, number*sizeof(float)); break;
+    case DOUBLE :
+      for (size_t i = 0; i < number; i++)
+        ((double*)data)[i] = values[i];
+      break;
+    case LDOUBLE :
+      for (size_t i = 0; i < number; i++)
+      {
+        long double value = values[i];
+        memcpy((char*)data + i*sizeDataType(LDOUBLE), &value, (sizeof(value) < (size_t)sizeDataType(LDOUBLE)) ? sizeof(value) : (size_t)sizeDataType(LDOUBLE));
+      }
+      break;
+    default:
+      perror("Error : Only numbers can be converted from floats");
+      return -1;
+  }
+  return 0;
+}
+
+/**
+ * \struct FftBatch
+ * \brief Whole blocs of a segment popped from an IdElement, compressed together.
+ */
+
+typedef struct FftBatch FftBatch;
+struct FftBatch
+{
+  FftElement *fftElement;  //FftElement receiving the blocs
+  void *data;  //batchBlocs*fftSize data popped (the last bloc padded if nbElement < blocSize, each bloc extended to fftSize)
+  Data_type dataType;  //type of the data (FLOAT, or INT16_T and INT32_T for a fixed point FftElement)
+  float *coefficients;  //Low arrays of the blocs then their High arrays (int32_t for a fixed point FftElement)
+  float *scales;  //scale of each bloc of a fixed point FftElement, after the coefficients
+  unsigned int startTime;  //time of the first data
+  unsigned int nbElement;  //number of data of each bloc
+  unsigned int batchBlocs;  //number of blocs
+  int result;  //result of fftSplitBatch
+};
+
+/**
+ * \fn static IdElement* checkPush(FftStack* myFftStack, IdStack* myIdStack, Id_type id, unsigned int stopTime, FftElement** fftElement)
+ * \brief Find the IdElement and the FftElement of an id and check that the IdElement can be compressed.
+ *
+ * \return the IdElement, NULL if it can't be compressed.
+ */
+
+static IdElement* checkPush(FftStack* myFftStack, IdStack* myIdStack, Id_type id, unsigned int stopTime, FftElement** fftElement)
+{
+  if (myFftStack == NULL)
+  {
+    perror("Error : the FftStack should be initialied before\n");
+    return NULL;
+  }
+  IdElement* idElement;
+  idElement = searchIdElement(myIdStack,id);
+  if (idElement == NULL)
+  {
+    perror("Error : The Element corresponding to the ID is inexistant\n");
+    return NULL;
+  }
+  if (idElement->dataType == CHAR || sizeDataType(idElement->dataType) < 0)
+  {
+    perror("Error : Elements corresponding to the ID are not numbers\n");
+    return NULL;
+  }
+  if (idElement->timeStack != NULL)
+  {
+    perror("Error : Irregular channels can't be compressed\n");
+    return NULL;
+  }
+  idElementDrain(myIdStack, idElement);
+  if (idElement->startTime > stopTime)
+  {
+    perror("Error : stopTime should be higher than startTime\n");
+    return NULL;
+  }
+  *fftElement = searchFftElement(myFftStack, id);
+  if (*fftElement == NULL)
+  {
+    perror("Error : The FftElement should be initialized before\n");
+    return NULL;
+  }
+  if ((*fftElement)->fixedPoint && idElement->dataType != INT16_T && idElement->dataType != INT32_T)
+  {
+    perror("Error : Only INT16_T and INT32_T elements can be compressed in fixed point\n");
+    return NULL;
+  }
+  (*fftElement)->id = id;
+  (*fftElement)->timeInterval = idElement->timeInterval;
+  (*fftElement)->dataType = idElement->dataType;
+  return idElement;
+}
+
+/**
+ * \fn static float extensionValue(float firstValue, float lastValue, unsigned int i, unsigned int blocSize, unsigned int fftSize)
+ * \brief Return the data i (blocSize to fftSize-1) added by extendBlocs to a bloc, before its conversion to the Data_type.
+ */
+
+static float extensionValue(float firstValue, float lastValue, unsigned int i, unsigned int blocSize, unsigned int fftSize)
+{
+  return lastValue + (firstValue - lastValue)*(float)(i - blocSize + 1)/(float)(fftSize - blocSize + 1);
+}
+
+/**
+ * \fn static int extendBlocs(FftBatch* batch, unsigned int blocSize, unsigned int fftSize)
+ * \brief Extend each bloc of blocSize data of a batch to the fftSize data of its transform.
+ *
+ * The added data go from the last value of the bloc back to its first one, so the periodic extension seen by the
+ * FFT has no jump. They are dropped by the decoding.
+ *
+ * \return 0 if it SUCCESSED, -1 if it FAILED (batch->data is then freed).
+ */
+
+static int extendBlocs(FftBatch* batch, unsigned int blocSize, unsigned int fftSize)
+{
+  size_t numberSize = sizeDataType(batch->dataType);
+  char* extended = (char*) malloc((size_t)batch->batchBlocs*fftSize*numberSize);
+  if (extended == NULL)
+  {
+    perror("Error : Memory allocation for the extended blocs impossible");
+    free(batch->data);
+    return -1;
+  }
+  for (unsigned int j = 0; j < batch->batchBlocs; j++)
+  {
+    char* bloc = extended + (size_t)j*fftSize*numberSize;
+    float firstValue, lastValue;
+    memcpy(bloc, (char*)batch->data + (size_t)j*blocSize*numberSize, blocSize*numberSize);
+    fftDataToFloat(bloc, batch->dataType, 1, &firstValue);
+    fftDataToFloat(bloc + (blocSize-1)*numberSize, batch->dataType, 1, &lastValue);
+    for (unsigned int i = blocSize; i < fftSize; i++)
+    {
+      float value = extensionValue(firstValue, lastValue, i, blocSize, fftSize);
+      fftFloatToData(&value, 1, batch->dataType, bloc + i*numberSize);
+    }
+  }
+  free(batch->data);
+  batch->data = extended;
+  return 0;
+}
+
+/**
+ * \fn static int nextBatch(IdStack* myIdStack, IdElement* idElement, FftElement* fftElement, unsigned int stopTime, FftBatch* batch)
+ * \brief Pop the next whole blocs of an IdElement until stopTime, FFT_BATCH_BLOCS at most.
+ *
+ * A bloc never spans a gap : the blocs are cut segment by segment, and the end of a segment followed by a gap is
+ * padded with its last value.
+ *
+ * \return 1 if blocs were popped, 0 if there is no whole bloc left, -1 if it FAILED.
+ */
+
+static int nextBatch(IdStack* myIdStack, IdElement* idElement, FftElement* fftElement, unsigned int stopTime, FftBatch* batch)
+{
+  IdSegment segment;
+  unsigned int blocSize = fftElement->blocSize, fftSize = fftElement->fftSize;
+  if (idElementSegments(idElement, idElement->startTime, stopTime, &segment, 1) == 0)
+    return 0;
+  int gapAfter = idElement->segmentNumber > 1 && segment.dataNumber == idElement->segments[0].dataNumber;
+  batch->fftElement = fftElement;
+  batch->dataType = idElement->dataType;
+  batch->startTime = segment.startTime;
+  batch->nbElement = (segment.dataNumber < blocSize && gapAfter) ? segment.dataNumber : blocSize;
+  if (batch->nbElement > segment.dataNumber)
+    return 0;
+  batch->batchBlocs = (batch->nbElement < blocSize) ? 1 : segment.dataNumber/blocSize;
+  if (batch->batchBlocs > FFT_BATCH_BLOCS)
+    batch->batchBlocs = FFT_BATCH_BLOCS;
+  batch->coefficients = NULL;
+  batch->result = -1;
+  batch->data = dataHandlePop(myIdStack, idElement->handle, segment.startTime + ((batch->batchBlocs-1)*blocSize+batch->nbElement-1)*idElement->timeInterval);
+  if (batch->data == NULL){
+    perror("Error : Unable to Pop uncompressed Data");
+    return -1;
+  }
+  if (batch->nbElement < blocSize)
+  {
+    size_t numberSize = sizeDataType(batch->dataType);
+    char* paddedPointer = (char*) realloc(batch->data, blocSize*numberSize);
+    if (paddedPointer == NULL)
+    {
+      perror("Error : Memory allocation for the padded bloc impossible");
+      free(batch->data);
+      return -1;
+    }
+    batch->data = paddedPointer;
+    for (unsigned int i = batch->nbElement; i < blocSize; i++)
+      memcpy(paddedPointer + i*numberSize, paddedPointer + (batch->nbElement-1)*numberSize, numberSize);
+  }
+  if (fftSize > blocSize && extendBlocs(batch, blocSize, fftSize) != 0)
+    return -1;
+  if (batch->dataType != FLOAT && !fftElement->fixedPoint)
+  {
+    float* values = (float*) malloc((size_t)batch->batchBlocs*fftSize*sizeof(float));
+    if (values == NULL || fftDataToFloat(batch->data, batch->dataType, (size_t)batch->batchBlocs*fftSize, values) != 0)
+    {
+      perror("Error : Conversion of the data into floats impossible");
+      free(values);
+      free(batch->data);
+      return -1;
+    }
+    free(batch->data);
+    batch->data = values;
+    batch->dataType = FLOAT;
+  }
+  batch->coefficients = (float*) malloc((size_t)batch->batchBlocs*(fftElement->sizeCompressedL+fftElement->sizeCompressedH+1)*sizeof(float));
+  if (batch->coefficients == NULL)
+  {
+    perror("Error : Memory allocation for the coefficients impossible");
+    free(batch->data);
+    return -1;
+  }
+  batch->scales = batch->coefficients + (size_t)batch->batchBlocs*(fftElement->sizeCompressedL+fftElement->sizeCompressedH);
+  return 1;
+}
+
+/**
+ * \fn static void transformBatch(FftBatch* batch)
+ * \brief Compress the blocs of a batch into its coefficients. The result is kept in batch->result.
+ */
+
+static void transformBatch(FftBatch* batch)
+{
+  FftElement* fftElement = batch->fftElement;
+  float* low = batch->coefficients;
+  float* high = batch->coefficients + (size_t)batch->batchBlocs*fftElement->sizeCompressedL;
+  if (batch->dataType == FLOAT)
+    batch->result = fftSplitBatch(batch->data, fftElement->fftSize, batch->batchBlocs, low, high);
+  else
+    batch->result = fftSplitBatchFixed(batch->data, (batch->dataType == INT16_T) ? 16 : 32, fftElement->fftSize, batch->batchBlocs, (int32_t*)low, (int32_t*)high, batch->scales);
+}
+
+/**
+ * \fn static float* newColumn(unsigned int number)
+ * \brief Return an array of number floats aligned on FFT_ALIGN.
+ */
+
+static float* newColumn(unsigned int number)
+{
+  size_t size = ((number*sizeof(float) + FFT_ALIGN - 1)/FFT_ALIGN)*FFT_ALIGN;
+  return (float*) aligned_alloc(FFT_ALIGN, (size == 0) ? FFT_ALIGN : size);
+}
+
+/**
+ * \fn static int reserveBlocs(FftElement* fftElement, unsigned int number)
+ * \brief Make room for number blocs after the newest bloc of an FftElement.
+ *
+ * The popped blocs are reclaimed by moving the live blocs to the start of the columns, the columns are doubled
+ * when this isn't enough.
+ *
+ * \return 0 if it SUCCESSED, -1 if it FAILED.
+ */
+
+static int reserveBlocs(FftElement* fftElement, unsigned int number)
+{
+  unsigned int sizeCompressedL = fftElement->sizeCompressedL, sizeCompressedH = fftElement->sizeCompressedH;
+  unsigned int first = fftElement->firstBloc, live = fftElement->dataNumber;
+  if (first + live + number <= fftElement->blocCapacity)
+    return 0;
+  if (live + number <= fftElement->blocCapacity)
+  {
+    memmove(fftElement->low, fftElement->low + (size_t)first*sizeCompressedL, (size_t)live*sizeCompressedL*sizeof(float));
+    memmove(fftElement->high, fftElement->high + (size_t)first*sizeCompressedH, (size_t)live*sizeCompressedH*sizeof(float));
+    memmove(fftElement->blocs, fftElement->blocs + first, live*sizeof(FftBloc));
+    fftElement->firstBloc = 0;
+    return 0;
+  }
+  unsigned int capacity = (fftElement->blocCapacity < 16) ? 16 : 2*fftElement->blocCapacity;
+  if (capacity < live + number)
+    capacity = live + number;
+  float* low = newColumn(capacity*sizeCompressedL);
+  float* high = newColumn(capacity*sizeCompressedH);
+  FftBloc* blocs = (FftBloc*) malloc(capacity*sizeof(FftBloc));
+  if (low == NULL || high == NULL || blocs == NULL)
+  {
+    perror("Error : Memory allocation for the columns of the FftElement impossible");
+    free(low);
+    free(high);
+    free(blocs);
+    return -1;
+  }
+  if (live > 0)
+  {
+    memcpy(low, fftElement->low + (size_t)first*sizeCompressedL, (size_t)live*sizeCompressedL*sizeof(float));
+    memcpy(high, fftElement->high + (size_t)first*sizeCompressedH, (size_t)live*sizeCompressedH*sizeof(float));
+    memcpy(blocs, fftElement->blocs + first, live*sizeof(FftBloc));
+  }
+  free(fftElement->low);
+  free(fftElement->high);
+  free(fftElement->blocs);
+  fftElement->low = low;
+  fftElement->high = high;
+  fftElement->blocs = blocs;
+  fftElement->firstBloc = 0;
+  fftElement->blocCapacity = capacity;
+  return 0;
+}
+
+/**
+ * \fn static int storeBatch(FftBatch* batch)
+ * \brief Append the compressed blocs of a batch after the newest bloc of its FftElement.
+ *
+ * \return 0 if it SUCCESSED, -1 if it FAILED.
+ */
+
+static int storeBatch(FftBatch* batch)
+{
+  FftElement* myFftElement = batch->fftElement;
+  unsigned int sizeCompressedL = myFftElement->sizeCompressedL, sizeCompressedH = myFftElement->sizeCompressedH;
+  if (batch->result != 0)
+  {
+    perror("Error : Compression of the blocs impossible");
+    return -1;
+  }
+  if (reserveBlocs(myFftElement, batch->batchBlocs) != 0)
+    return -1;
+  unsigned int index = myFftElement->firstBloc + myFftElement->dataNumber;
+  memcpy(myFftElement->low + (size_t)index*sizeCompressedL, batch->coefficients, (size_t)batch->batchBlocs*sizeCompressedL*sizeof(float));
+  memcpy(myFftElement->high + (size_t)index*sizeCompressedH, batch->coefficients + (size_t)batch->batchBlocs*sizeCompressedL, (size_t)batch->batchBlocs*sizeCompressedH*sizeof(float));
+  for (unsigned int j = 0; j < batch->batchBlocs; j++)
+  {
+    myFftElement->blocs[index+j].startTime = batch->startTime + j*myFftElement->blocSize*myFftElement->timeInterval;
+    myFftElement->blocs[index+j].dataNumber = batch->nbElement;
+    myFftElement->blocs[index+j].scale = (myFftElement->fixedPoint) ? batch->scales[j] : 1.f;
+  }
+  if (myFftElement->dataNumber == 0)
+    myFftElement->startTime = batch->startTime;
+  myFftElement->dataNumber += batch->batchBlocs;
+  return 0;
+}
+
 /**
  * \fn FftElement* fftPush(FftStack* myFftStack, IdStack* myIdStack, Id_type id,unsigned int stopTime)
  * \brief Transform and transfer a selected array of float data into the compressed data architecture.
  *
+ * The channels of every type but CHAR are converted into floats with fftDataToFloat and their frequencies are stored
+ * as floats, but the INT16_T and INT32_T channels set with fftSetFixedPoint : they are transformed and stored in Q31
+ * (see fftSplitBatchFixed).
  * \param myFftStack FftStack instance in which we want to store the compressed data.
  * \param id Type of the ID we are looking for (defined in the Id_type enum).
  * \param stopTime unsigned int corresponding to the wanted stoping time of data (Must be higher than the startTime of data and lower than the biggest time value). The stopTime migh be unreached during the storage if a bloc can't be completelly filled.
+ * A bloc never contains a gap of the IdElement (see dataIdStackSkip) : the last data of a segment followed by a gap are compressed in a bloc padded with the last value.
  *
  * \return pointer to the FftElement in which the data is stored.
  */
 
-FftElement* fftPush(FftStack* myFftStack, IdStack* myIdStack, Id_type id,unsigned int stopTime)
+FftElement* fftPush(FftStack* myFftStack, IdStack* myIdStack, Id_type id,unsigned int stopTime)
+{
+  unsigned int nbBlocs = 0;
+  int result;
+  FftElement* myFftElement;
+  FftBatch batch;
+  IdElement* idElement = checkPush(myFftStack, myIdStack, id, stopTime, &myFftElement);
+  if (idElement == NULL)
+    return NULL;
+  while ((result = nextBatch(myIdStack, idElement, myFftElement, stopTime, &batch)) > 0)
+  {
+    transformBatch(&batch);
+    result = storeBatch(&batch);
+    free(batch.data);
+    free(batch.coefficients);
+    if (result != 0)
+      return NULL;
+    nbBlocs += batch.batchBlocs;
+  }
+  if (result < 0)
+    return NULL;
+  if (nbBlocs == 0)
+  {
+    perror("Error : Unable to store compressed data, the number of elements is lower than the size of blocs\n");
+    return NULL;
+  }
+  return myFftElement;
+}
+
+/**
+ * \struct FftWorker
+ * \brief Range of batches of a thread of fftPushParallel. The other threads steal from its end.
+ */
+
+typedef struct FftWorker FftWorker;
+struct FftWorker
+{
+  pthread_mutex_t mutex;
+  unsigned int first;  //index of the next batch of the thread
+  unsigned int last;  //index after the last batch of the thread
+  FftBatch *batches;  //batches of all the threads
+  FftWorker *workers;  //all the threads
+  unsigned int workerNumber;  //number of threads
+};
+
+/**
+ * \fn static void* fftWorker(void* parameter)
+ * \brief Compress the batches of a FftWorker from its start, then steal the batches of the others from their end.
+ */
+
+static void* fftWorker(void* parameter)
+{
+  FftWorker* worker = parameter;
+  unsigned int index = 0;
+  for (;;)
+  {
+    int found = 0;
+    for (unsigned int i = 0; i < worker->workerNumber && !found; i++)
+    {
+      FftWorker* victim = &worker->workers[(worker - worker->workers + i) % worker->workerNumber];
+      pthread_mutex_lock(&victim->mutex);
+      if (victim->first < victim->last)
+      {
+        index = (victim == worker) ? victim->first++ : --victim->last;
+        found = 1;
+      }
+      pthread_mutex_unlock(&victim->mutex);
+    }
+    if (!found)
+      return NULL;
+    transformBatch(&worker->batches[index]);
+  }
+}
+
+/**
+ * \fn int fftPushParallel(FftStack* myFftStack, IdStack* myIdStack, Id_type* ids, unsigned int channelNumber, unsigned int stopTime, unsigned int threadNumber)
+ * \brief fftPush of several channels until stopTime, the blocs being compressed by threadNumber threads.
+ *
+ * The data are popped on the calling thread (the IdStack isn't shared), cut into tasks of FFT_BATCH_BLOCS blocs at
+ * most, and compressed by a pool of threads which steal the tasks of each other. The compressed blocs are then
+ * stored in the order of the channels and of the times : the FftElements are the same as with fftPush.
+ *
+ * \param myFftStack FftStack instance in which the FftElements of the channels were initialized.
+ * \param myIdStack IdStack instance of the channels.
+ * \param ids Array of the channelNumber ids to compress.
+ * \param channelNumber Number of channels.
+ * \param stopTime Time until which the data of each channel are compressed.
+ * \param threadNumber Number of threads, the calling thread included (1 compresses on the calling thread only).
+ * \return the number of compressed blocs. -1 if it FAILED.
+ */
+
+int fftPushParallel(FftStack* myFftStack, IdStack* myIdStack, Id_type* ids, unsigned int channelNumber, unsigned int stopTime, unsigned int threadNumber)
+{
+  FftBatch* batches = NULL;
+  unsigned int batchNumber = 0, batchSize = 0, nbBlocs = 0;
+  int result = 0;
+  if (ids == NULL || threadNumber == 0)
+  {
+    perror("Error : ids should be given and threadNumber higher than 0");
+    return -1;
+  }
+  for (unsigned int c = 0; c < channelNumber && result >= 0; c++)
+  {
+    FftElement* fftElement;
+    IdElement* idElement = checkPush(myFftStack, myIdStack, ids[c], stopTime, &fftElement);
+    if (idElement == NULL)
+    {
+      result = -1;
+      break;
+    }
+    do
+    {
+      if (batchNumber == batchSize)
+      {
+        batchSize = (batchSize == 0) ? 16 : 2*batchSize;
+        FftBatch* newBatches = (FftBatch*) realloc(batches, batchSize*sizeof(*batches));
+        if (newBatches == NULL)
+        {
+          perror("Error : Memory allocation for the batches impossible");
+          result = -1;
+          break;
+        }
+        batches = newBatches;
+      }
+      result = nextBatch(myIdStack, idElement, fftElement, stopTime, &batches[batchNumber]);
+      if (result > 0)
+        batchNumber++;
+    } while (result > 0);
+  }
+
+  if (batchNumber > 0)
+  {
+    if (threadNumber > batchNumber)
+      threadNumber = batchNumber;
+    FftWorker workers[threadNumber];
+    pthread_t threads[threadNumber];
+    for (unsigned int i = 0; i < threadNumber; i++)
+    {
+      pthread_mutex_init(&workers[i].mutex, NULL);
+      workers[i].first = (unsigned int)((unsigned long)batchNumber*i/threadNumber);
+      workers[i].last = (unsigned int)((unsigned long)batchNumber*(i+1)/threadNumber);
+      workers[i].batches = batches;
+      workers[i].workers = workers;
+      workers[i].workerNumber = threadNumber;
+    }
+    unsigned int started = 1;
+    while (started < threadNumber && pthread_create(&threads[started], NULL, fftWorker, &workers[started]) == 0)
+      started++;
+    fftWorker(&workers[0]);
+    for (unsigned int i = 1; i < started; i++)
+      pthread_join(threads[i], NULL);
+    for (unsigned int i = 0; i < threadNumber; i++)
+      pthread_mutex_destroy(&workers[i].mutex);
+  }
+
+  /*Batches are stored in the order they were popped, so the FftElements don't depend on the threads.
+    The batches popped before an error are stored too, their data are no longer in the IdStack*/
+  for (unsigned int i = 0; i < batchNumber; i++)
+  {
+    if (storeBatch(&batches[i]) != 0)
+      result = -1;
+    nbBlocs += batches[i].batchBlocs;
+    free(batches[i].data);
+    free(batches[i].coefficients);
+  }
+  free(batches);
+  return (result < 0) ? -1 : (int)nbBlocs;
+}
+
+/**
+ * \fn static unsigned int dataTime(IdElement *idElement, unsigned int index)
+ * \brief Return the time of the data index (from the oldest one) of a periodic IdElement, gaps included.
+ */
+
+static unsigned int dataTime(IdElement *idElement, unsigned int index)
+{
+  for (unsigned int i = 0; i < idElement->segmentNumber; i++)
+  {
+    if (index < idElement->segments[i].dataNumber)
+      return idElement->segments[i].startTime + index*idElement->timeInterval;
+    index -= idElement->segments[i].dataNumber;
+  }
+  return idElement->startTime + index*idElement->timeInterval;
+}
+
+/**
+ * \fn int fftEvict(IdStack* myIdStack, IdElement* idElement, unsigned int number, void* myFftStack)
+ * \brief Evict_function compressing the oldest data of an IdElement into its FftElement before it is dropped.
+ *
+ * Use it with idStackSetBudget(myIdStack, budget, fftEvict, myFftStack). Whole blocs covering at least number data are compressed, or the segments ended by a gap.
+ *
+ * \param myIdStack IdStack instance over its budget.
+ * \param idElement IdElement from which data is evicted.
+ * \param number Number of data to evict.
+ * \param myFftStack FftStack instance in which the FftElement of the IdElement was initialized.
+ * \return number of compressed data. 0 if the IdElement can't be compressed (no FftElement, CHAR, less than a bloc) : it is then dropped.
+ */
+
+int fftEvict(IdStack* myIdStack, IdElement* idElement, unsigned int number, void* myFftStack)
+{
+  FftElement* fftElement;
+  unsigned int dataNumber;
+  if (idElement->id == REGISTERED || idElement->dataType == CHAR || idElement->timeStack != NULL)
+    return 0;
+  fftElement = searchFftElement((FftStack*)myFftStack, idElement->id);
+  if (fftElement == NULL)
+    return 0;
+  dataNumber = idElement->dataNumber;
+  number = ((number + fftElement->blocSize - 1)/fftElement->blocSize)*fftElement->blocSize;
+  if (number > dataNumber)
+    number = dataNumber;
+  if (number == 0)
+    return 0;
+  if (fftPush((FftStack*)myFftStack, myIdStack, idElement->id, dataTime(idElement, number-1)) == NULL)
+    return 0;
+  return dataNumber - idElement->dataNumber;
+}
+
+/**
+ * \fn static int streamPush(IdStack* myIdStack, IdElement* idElement, void* myFftStack)
+ * \brief Push_function of fftStream compressing the whole blocs of an IdElement.
+ *
+ * \return number of compressed data. -1 if it FAILED.
+ */
+
+static int streamPush(IdStack* myIdStack, IdElement* idElement, void* myFftStack)
+{
+  unsigned int dataNumber = idElement->dataNumber;
+  if (fftPush((FftStack*)myFftStack, myIdStack, idElement->id, dataTime(idElement, dataNumber-1)) == NULL)
+    return -1;
+  return dataNumber - idElement->dataNumber;
+}
+
+/**
+ * \fn int fftStream(FftStack* myFftStack, IdStack* myIdStack, Id_type id)
+ * \brief Compress the data of a channel bloc by bloc as they are pushed.
+ *
+ * Each bloc is compressed by the push which fills it, so the IdElement never holds a whole bloc of raw data.
+ * The data already pushed are compressed now. idElementSetPush(myIdStack, idElement, 0, NULL, NULL) stops the streaming.
+ * The streaming stops too when a compression fails, the data then stay raw in the IdElement.
+ *
+ * \param myFftStack FftStack instance in which the FftElement of id was initialized.
+ * \param myIdStack IdStack instance in which the data of id are pushed.
+ * \param id Type of the ID to compress.
+ * \return 0 if it SUCCESSED, -1 if it FAILED (the compression of the data already pushed included).
+ */
+
+int fftStream(FftStack* myFftStack, IdStack* myIdStack, Id_type id)
+{
+  IdElement* idElement = searchIdElement(myIdStack, id);
+  FftElement* fftElement = searchFftElement(myFftStack, id);
+  if (idElement == NULL || fftElement == NULL)
+  {
+    perror("Error : The IdElement and the FftElement of the ID should be initialized before");
+    return -1;
+  }
+  if (idElement->dataType == CHAR || idElement->timeStack != NULL)
+  {
+    perror("Error : Elements corresponding to the ID can't be compressed");
+    return -1;
+  }
+  return idElementSetPush(myIdStack, idElement, fftElement->blocSize, streamPush, myFftStack);
+}
+
+/**
+ * \fn static unsigned int lastBlocTime(FftElement *fftElement, FftBloc *fftBloc)
+ * \brief Return the time of the last data compressed in a bloc (padding excluded).
+ */
+
+static unsigned int lastBlocTime(FftElement *fftElement, FftBloc *fftBloc)
+{
+  return fftBloc->startTime + (fftBloc->dataNumber-1)*fftElement->timeInterval;
+}
+
+/**
+ * \fn static unsigned int findBloc(FftElement *fftElement, unsigned int time)
+ * \brief Return the index (from the oldest bloc) of the first bloc with data at or after time, dataNumber if none.
+ */
+
+static unsigned int findBloc(FftElement *fftElement, unsigned int time)
+{
+  FftBloc *blocs = fftElement->blocs + fftElement->firstBloc;
+  unsigned int low = 0, high = fftElement->dataNumber;
+  while (low < high)
+  {
+    unsigned int middle = low + (high - low)/2;
+    if (lastBlocTime(fftElement, &blocs[middle]) < time)
+      low = middle + 1;
+    else
+      high = middle;
+  }
+  return low;
+}
+
+/**
+ * \fn static int rangeBlocs(FftElement* fftElement, unsigned int startTime, unsigned int stopTime, unsigned int* first, int* nbBlocs)
+ * \brief Find the blocs with data between startTime and stopTime : first is their index in the columns and nbBlocs their number.
+ *
+ * \return 0 if it SUCCESSED, -1 if it FAILED.
+ */
+
+static int rangeBlocs(FftElement* fftElement, unsigned int startTime, unsigned int stopTime, unsigned int* first, int* nbBlocs)
+{
+  *nbBlocs = blocNumberCount(fftElement,startTime,stopTime);
+  if (*nbBlocs < 1)
+  {
+    perror("Error : Number of blocs must be higher than 0");
+    return -1;
+  }
+  *first = fftElement->firstBloc + findBloc(fftElement, startTime);
+  return 0;
+}
+
+/**
+ * \fn static FftElement* selectBlocs(FftStack* myFftStack, Id_type id, unsigned int startTime, unsigned int stopTime, Erase_mode erase, unsigned int* first, int* nbBlocs)
+ * \brief Find the blocs popped by fftPop : first is their index in the columns and nbBlocs their number (the selection stops at the first gap).
+ *
+ * \return the FftElement of id, NULL on error.
+ */
+
+static FftElement* selectBlocs(FftStack* myFftStack, Id_type id, unsigned int startTime, unsigned int stopTime, Erase_mode erase, unsigned int* first, int* nbBlocs)
+{
+  if (myFftStack == NULL)
+  {
+    perror("Error : the FftStack should be initialied before");
+    return NULL;
+  }
+  FftElement* fftElement;
+  fftElement = searchFftElement(myFftStack, id);
+  if (fftElement == NULL)
+  {
+    perror("Error : The FftElement should be initialized before");
+    return NULL;
+  }
+  if (erase == ERASE)
+  {
+    startTime = fftElement->startTime;
+  }
+  if (rangeBlocs(fftElement, startTime, stopTime, first, nbBlocs) != 0)
+    return NULL;
+  FftBloc *blocs = fftElement->blocs + *first;
+  /*The popped blocs are contiguous : the array stops at the first gap*/
+  for(int j = 1; j < *nbBlocs; j++){
+    if (blocs[j-1].dataNumber != fftElement->blocSize || blocs[j].startTime != blocs[j-1].startTime + fftElement->blocSize*fftElement->timeInterval)
+    {
+      *nbBlocs = j;
+      break;
+    }
+  }
+  return fftElement;
+}
+
+/**
+ * \fn static float* newCoefficients(FftElement* fftElement)
+ * \brief Allocate the floats receiving the arrays of a bloc of a fixed point FftElement (see blocArrays).
+ *
+ * \return the array, NULL if it FAILED.
+ */
+
+static float* newCoefficients(FftElement* fftElement)
+{
+  size_t number = (fftElement->fixedPoint) ? fftElement->sizeCompressedL+fftElement->sizeCompressedH : 1;
+  float* coefficients = (float*) malloc(number*sizeof(float));
+  if (coefficients == NULL)
+    perror("Error : Memory allocation impossible for the coefficients of a bloc");
+  return coefficients;
+}
+
+/**
+ * \fn static float* blocArrays(FftElement* fftElement, unsigned int index, float* coefficients, float** high)
+ * \brief Return the Low array of the bloc index of the columns as floats, high receiving its High array.
+ *
+ * The arrays of a float FftElement are read in its columns, the Q31 arrays of a fixed point FftElement are converted
+ * into coefficients (given by newCoefficients).
+ */
+
+static float* blocArrays(FftElement* fftElement, unsigned int index, float* coefficients, float** high)
+{
+  unsigned int sizeCompressedL = fftElement->sizeCompressedL, sizeCompressedH = fftElement->sizeCompressedH;
+  float* low = fftElement->low + (size_t)index*sizeCompressedL;
+  *high = fftElement->high + (size_t)index*sizeCompressedH;
+  if (!fftElement->fixedPoint)
+    return low;
+  fftFixedToFloat(low, sizeCompressedL, fftElement->blocs[index].scale, coefficients);
+  fftFixedToFloat(*high, sizeCompressedH, fftElement->blocs[index].scale, coefficients + sizeCompressedL);
+  *high = coefficients + sizeCompressedL;
+  return coefficients;
+}
+
+/**
+ * \fn static float roundToData(float value, Data_type dataType)
+ * \brief Return a float as it is stored in a bloc of dataType : rounded and saturated for the integer types.
+ */
+
+static float roundToData(float value, Data_type dataType)
+{
+  long double data;
+  if (dataType < FLOAT)
+  {
+    fftFloatToData(&value, 1, dataType, &data);
+    fftDataToFloat(&data, dataType, 1, &value);
+  }
+  return value;
+}
+
+/**
+ * \fn static void removeAddedData(FftElement* fftElement, unsigned int index, float* low, float* high, double* sum, double* square)
+ * \brief Remove from the sum and the sum of squares of the fftSize data of a bloc the data added to it by fftPush.
+ *
+ * A bloc padded before a gap repeats its last data up to blocSize, then extendBlocs adds a ramp from its last data
+ * back to its first one up to fftSize : both only depend on the two data found by fftBlocData, in O(fftSize). The
+ * padding is removed in closed form, and so is the ramp of a floating point channel. The ramp of an integer channel
+ * was rounded to its Data_type : it is recomputed data by data, each in O(1).
+ */
+
+static void removeAddedData(FftElement* fftElement, unsigned int index, float* low, float* high, double* sum, double* square)
+{
+  unsigned int number = fftElement->blocs[index].dataNumber, blocSize = fftElement->blocSize, fftSize = fftElement->fftSize;
+  if (number == fftSize)
+    return;
+  float lastValue = roundToData((float)fftBlocData(low, high, fftSize, number-1), fftElement->dataType);
+  float firstValue = roundToData((float)fftBlocData(low, high, fftSize, 0), fftElement->dataType);
+  double padding = blocSize - number, ramp = fftSize - blocSize;
+  *sum -= padding*lastValue;
+  *square -= padding*lastValue*lastValue;
+  if (fftElement->dataType < FLOAT)
+  {
+    for (unsigned int i = blocSize; i < fftSize; i++)
+    {
+      double value = roundToData(extensionValue(firstValue, lastValue, i, blocSize, fftSize), fftElement->dataType);
+      *sum -= value;
+      *square -= value*value;
+    }
+    return;
+  }
+  /*The ramp is lastValue + step*m for m = 1 to ramp*/
+  double step = ((double)firstValue - lastValue)/(ramp + 1);
+  *sum -= ramp*lastValue + step*ramp*(ramp + 1)/2;
+  *square -= ramp*lastValue*lastValue + lastValue*step*ramp*(ramp + 1) + step*step*ramp*(ramp + 1)*(2*ramp + 1)/6;
+}
+
+/**
+ * \fn long fftStats(FftStack* myFftStack, Id_type id, unsigned int startTime, unsigned int stopTime, float* mean, float* rms, float* variance)
+ * \brief Compute the mean, the RMS and the variance of the data of the blocs between startTime and stopTime from their frequencies.
+ *
+ * The blocs are the ones of fftPop for the same times, gaps included. Nothing is decompressed : a bloc costs O(fftSize)
+ * (see fftBlocMoments), and the data added to it when it was padded or extended to fftSize are left out (see removeAddedData).
+ *
+ * \param myFftStack FftStack instance in which the FftElement of id was initialized.
+ * \param id Type of the ID we are looking for (defined in the Id_type enum).
+ * \param startTime Time of the data in the first bloc.
+ * \param stopTime Time of the data in the last bloc.
+ * \param mean Receive the mean of the data (NULL if not wanted).
+ * \param rms Receive the root mean square of the data (NULL if not wanted).
+ * \param variance Receive the variance of the data (NULL if not wanted).
+ * \return number of data of the blocs. -1 if it FAILED.
+ */
+
+long fftStats(FftStack* myFftStack, Id_type id, unsigned int startTime, unsigned int stopTime, float* mean, float* rms, float* variance)
+{
+  unsigned int first;
+  int nbBlocs;
+  long number = 0;
+  double sum = 0, square = 0;
+  float *coefficients, *high;
+  FftElement* fftElement = searchFftElement(myFftStack, id);
+  if (fftElement == NULL || rangeBlocs(fftElement, startTime, stopTime, &first, &nbBlocs) != 0)
+    return -1;
+  if ((coefficients = newCoefficients(fftElement)) == NULL)
+    return -1;
+  for (unsigned int j = first; j < first + nbBlocs; j++)
+  {
+    float* low = blocArrays(fftElement, j, coefficients, &high);
+    double blocSum = 0, blocSquare = 0;
+    if (fftBlocMoments(low, high, fftElement->fftSize, &blocSum, &blocSquare) != 0)
+    {
+      free(coefficients);
+      return -1;
+    }
+    removeAddedData(fftElement, j, low, high, &blocSum, &blocSquare);
+    sum += blocSum;
+    square += (blocSquare > 0) ? blocSquare : 0;
+    number += fftElement->blocs[j].dataNumber;
+  }
+  free(coefficients);
+  if (mean != NULL)
+    *mean = (float)(sum/number);
+  if (rms != NULL)
+    *rms = (float)sqrt(square/number);
+  if (variance != NULL)
+    *variance = (float)((square/number > (sum/number)*(sum/number)) ? square/number - (sum/number)*(sum/number) : 0);
+  return number;
+}
+
+/**
+ * \fn static void rescaleBands(FftElement* fftElement, unsigned int index, float* low, float* high, const float* edges, unsigned int bandNumber, double* blocPowers)
+ * \brief Give to the band powers of a bloc with added data the mean and the variance of its own data.
+ */
+
+static void rescaleBands(FftElement* fftElement, unsigned int index, float* low, float* high, const float* edges, unsigned int bandNumber, double* blocPowers)
+{
+  unsigned int number = fftElement->blocs[index].dataNumber, size = fftElement->fftSize, band = 0;
+  double sum = 0, square = 0;
+  fftBlocMoments(low, high, size, &sum, &square);
+  double blocMean = sum/size, blocVariance = square/size - blocMean*blocMean;
+  removeAddedData(fftElement, index, low, high, &sum, &square);
+  double mean = sum/number, variance = square/number - mean*mean;
+  double scale = (blocVariance > 0 && variance > 0) ? variance/blocVariance : 0;
+  for (unsigned int b = 0; b < bandNumber; b++)
+    blocPowers[b] *= scale;
+  /*The frequency 0 is in the band found like in fftBlocBands*/
+  if (edges[0] > 0)
+    return;
+  while (band < bandNumber-1 && edges[band+1] <= 0)
+    band++;
+  blocPowers[band] += mean*mean - blocMean*blocMean*scale;
+}
+
+/**
+ * \fn long fftBandPower(FftStack* myFftStack, Id_type id, unsigned int startTime, unsigned int stopTime, const float* edges, unsigned int bandNumber, float* powers)
+ * \brief Compute the power of frequency bands of the blocs between startTime and stopTime from their frequencies.
+ *
+ * The power of a band is the mean of the squares of the data due to its frequencies (see fftBlocBands), averaged over
+ * the blocs weighted by their number of data. The spectrum of a bloc with added data (padding before a gap, extension
+ * to fftSize) is the one of its fftSize data transformed : its frequency 0 is replaced by the mean of its own data, and
+ * its other frequencies are scaled to the variance of its own data (see removeAddedData). Bands covering 0 to 0.5 then
+ * add up to the mean square given by fftStats.
+ *
+ * \param myFftStack FftStack instance in which the FftElement of id was initialized.
+ * \param id Type of the ID we are looking for (defined in the Id_type enum).
+ * \param startTime Time of the data in the first bloc.
+ * \param stopTime Time of the data in the last bloc.
+ * \param edges bandNumber+1 increasing frequencies in cycles per data (0 to 0.5) : band b is [edges[b], edges[b+1]), the last band includes its upper edge.
+ * \param bandNumber Number of bands.
+ * \param powers Array of bandNumber floats receiving the powers.
+ * \return number of data of the blocs. -1 if it FAILED.
+ */
+
+long fftBandPower(FftStack* myFftStack, Id_type id, unsigned int startTime, unsigned int stopTime, const float* edges, unsigned int bandNumber, float* powers)
+{
+  unsigned int first;
+  int nbBlocs;
+  long number = 0;
+  FftElement* fftElement = searchFftElement(myFftStack, id);
+  if (fftElement == NULL || rangeBlocs(fftElement, startTime, stopTime, &first, &nbBlocs) != 0)
+    return -1;
+  if (powers == NULL || bandNumber == 0)
+  {
+    perror("Error : At least one band is needed");
+    return -1;
+  }
+  double* sums = (double*) calloc(bandNumber, sizeof(*sums));
+  double* blocPowers = (double*) malloc(bandNumber*sizeof(*blocPowers));
+  float *coefficients = newCoefficients(fftElement), *high;
+  if (sums == NULL || blocPowers == NULL || coefficients == NULL)
+  {
+    perror("Error : Memory allocation for the band powers impossible");
+    free(sums);
+    free(blocPowers);
+    free(coefficients);
+    return -1;
+  }
+  for (unsigned int j = first; j < first + nbBlocs; j++)
+  {
+    memset(blocPowers, 0, bandNumber*sizeof(*blocPowers));
+    float* low = blocArrays(fftElement, j, coefficients, &high);
+    if (fftBlocBands(low, high, fftElement->fftSize, edges, bandNumber, blocPowers) != 0)
+    {
+      number = -1;
+      break;
+    }
+    if (fftElement->blocs[j].dataNumber != fftElement->fftSize)
+      rescaleBands(fftElement, j, low, high, edges, bandNumber, blocPowers);
+    for (unsigned int b = 0; b < bandNumber; b++)
+      sums[b] += blocPowers[b]*fftElement->blocs[j].dataNumber;
+    number += fftElement->blocs[j].dataNumber;
+  }
+  for (unsigned int b = 0; b < bandNumber && number > 0; b++)
+    powers[b] = (float)(sums[b]/number);
+  free(sums);
+  free(blocPowers);
+  free(coefficients);
+  return number;
+}
+
+/**
+ * \fn long fftDecimate(FftStack* myFftStack, Id_type id, unsigned int startTime, unsigned int stopTime, unsigned int factor, unsigned int* times, float* values, size_t capacity)
+ * \brief Uncompress one data out of factor of the blocs between startTime and stopTime, for overviews.
+ *
+ * Each bloc is decoded with one inverse FFT of fftSize/factor over its lowest frequencies (see ifftBlocDecimated) :
+ * the data are low-pass filtered before the decimation. The blocs are the ones of fftPop for the same times, gaps
+ * included : the data j of a bloc has the time startTime + j*factor*timeInterval of the bloc.
+ *
+ * \param myFftStack FftStack instance in which the FftElement of id was initialized.
+ * \param id Type of the ID we are looking for (defined in the Id_type enum).
+ * \param startTime Time of the data in the first bloc.
+ * \param stopTime Time of the data in the last bloc.
+ * \param factor Ratio between the rate of the channel and the rate of the data written (at least 2, dividing fftSize).
+ * \param times Array in which the time of each data is written, NULL if the times are not wanted.
+ * \param values Array in which the data is written, NULL to only compute the number of data.
+ * \param capacity Number of data which can be written in times and values.
+ * \return number of data (written or to write), -1 on error or if the buffers are too small.
+ */
+
+long fftDecimate(FftStack* myFftStack, Id_type id, unsigned int startTime, unsigned int stopTime, unsigned int factor, unsigned int* times, float* values, size_t capacity)
+{
+  unsigned int first;
+  int nbBlocs;
+  size_t number = 0;
+  FftElement* fftElement = searchFftElement(myFftStack, id);
+  if (fftElement == NULL || rangeBlocs(fftElement, startTime, stopTime, &first, &nbBlocs) != 0)
+    return -1;
+  if (factor < 2 || fftElement->fftSize%factor != 0)
+  {
+    perror("Error : The factor should be at least 2 and divide the size of the transforms");
+    return -1;
+  }
+  FftBloc* blocs = fftElement->blocs;
+  for (unsigned int j = first; j < first + nbBlocs; j++)
+    number += (blocs[j].dataNumber + factor - 1)/factor;
+  if (values == NULL)
+    return (long)number;
+  if (capacity < number)
+  {
+    perror("Error : buffer too small for the uncompressed data");
+    return -1;
+  }
+  unsigned int newSize = fftElement->fftSize/factor;
+  float* scratch = (float*) malloc(newSize*sizeof(float));
+  float *coefficients = newCoefficients(fftElement), *high;
+  FftWorkspace* workspace = fftWorkspaceAcquire(newSize, 1);
+  if (scratch == NULL || coefficients == NULL || workspace == NULL)
+  {
+    perror("Error : Memory allocation impossible for a bloc");
+    free(scratch);
+    free(coefficients);
+    fftWorkspaceRelease(workspace);
+    return -1;
+  }
+  long result = (long)number;
+  number = 0;
+  for (unsigned int j = first; j < first + nbBlocs; j++)
+  {
+    unsigned int blocNumber = (blocs[j].dataNumber + factor - 1)/factor;
+    if (ifftBlocDecimated(workspace, blocArrays(fftElement, j, coefficients, &high), fftElement->fftSize, scratch) != 0)
+    {
+      result = -1;
+      break;
+    }
+    memcpy(values + number, scratch, blocNumber*sizeof(float));
+    for (unsigned int i = 0; i < blocNumber && times != NULL; i++)
+      times[number + i] = blocs[j].startTime + i*factor*fftElement->timeInterval;
+    number += blocNumber;
+  }
+  fftWorkspaceRelease(workspace);
+  free(scratch);
+  free(coefficients);
+  return result;
+}
+
+/**
+ * \fn static float blocBound(FftElement* fftElement)
+ * \brief Return the error bound of the fftSize data of a transform for which the blocSize data of the bloc stay under the bound of the FftElement.
+ */
+
+static float blocBound(FftElement* fftElement)
+{
+  if (fftElement->errorType == RMS_ERROR)
+    return fftElement->errorBound*sqrtf((float)fftElement->blocSize/(float)fftElement->fftSize);
+  return fftElement->errorBound;
+}
+
+/**
+ * \fn static unsigned int selectBound(FftElement* fftElement, Fft_type fftType)
+ * \brief Return the largest number of bytes of a bloc in an ADAPTIVE or DCT array (every coefficient kept).
+ */
+
+static unsigned int selectBound(FftElement* fftElement, Fft_type fftType)
+{
+  unsigned int size = fftElement->fftSize, bits = fftElement->coefficientBits;
+  if (fftType == ADAPTIVE)
+    return ((size/2+1+31)/32 + fftQuantizeWords(2*(size/2+1), bits))*sizeof(float);
+  return ((size+31)/32 + fftQuantizeWords(size, bits))*sizeof(float);
+}
+
+/**
+ * \fn static char* selectTarget(FftElement* fftElement, Fft_type fftType, char* out, size_t capacity, long totalSize, char** scratch)
+ * \brief Return where the next bloc of an ADAPTIVE or DCT array is written : out when it has room for any bloc, a scratch bloc otherwise.
+ *
+ * \return pointer to write the bloc, NULL if the scratch can't be allocated.
+ */
+
+static char* selectTarget(FftElement* fftElement, Fft_type fftType, char* out, size_t capacity, long totalSize, char** scratch)
+{
+  unsigned int bound = selectBound(fftElement, fftType);
+  if (capacity - totalSize >= bound)
+    return out + totalSize;
+  if (*scratch == NULL && (*scratch = (char*) malloc(bound)) == NULL)
+    perror("Error : Memory allocation impossible for a bloc");
+  return *scratch;
+}
+
+/**
+ * \fn static long keepSelected(char* out, size_t capacity, long totalSize, char* target, int words)
+ * \brief Add a bloc of words written at target to an ADAPTIVE or DCT array, copying it from the scratch if needed.
+ *
+ * \return number of bytes of the array with the bloc, -1 if it FAILED or if out is too small.
+ */
+
+static long keepSelected(char* out, size_t capacity, long totalSize, char* target, int words)
+{
+  if (words < 0)
+    return -1;
+  if (capacity - totalSize < words*sizeof(float))
+  {
+    perror("Error : buffer too small for the compressed data");
+    return -1;
+  }
+  if (target != out + totalSize)
+    memcpy(out + totalSize, target, words*sizeof(float));
+  return totalSize + words*(long)sizeof(float);
+}
+
+/**
+ * \fn static long adaptiveBlocs(FftElement* fftElement, unsigned int first, int nbBlocs, char* out, size_t capacity)
+ * \brief Write into out the masks and the kept frequencies of nbBlocs blocs from the bloc first (see fftSelect).
+ *
+ * Each bloc is selected once : the blocs are written in place while out has room for a whole bloc, the last ones
+ * through a scratch bloc so that capacity is never exceeded.
+ *
+ * \return number of bytes of the blocs (only computed if out is NULL), -1 on error or if capacity is too small.
+ */
+
+static long adaptiveBlocs(FftElement* fftElement, unsigned int first, int nbBlocs, char* out, size_t capacity)
+{
+  FftWorkspace* workspace = fftWorkspaceAcquire(fftElement->fftSize, 0);
+  float *coefficients = newCoefficients(fftElement), *high;
+  float bound = blocBound(fftElement);
+  char* scratch = NULL;
+  if (workspace == NULL || coefficients == NULL)
+  {
+    fftWorkspaceRelease(workspace);
+    free(coefficients);
+    return -1;
+  }
+  long totalSize = 0;
+  for(int j = 0; j<nbBlocs && totalSize >= 0; j++){
+    char* target = (out == NULL) ? NULL : selectTarget(fftElement, ADAPTIVE, out, capacity, totalSize, &scratch);
+    if (out != NULL && target == NULL)
+    {
+      totalSize = -1;
+      break;
+    }
+    float* low = blocArrays(fftElement, first+j, coefficients, &high);
+    int words = fftSelect(workspace, low, high, fftElement->selection, fftElement->errorType, bound, fftElement->coefficientBits, target);
+    if (out == NULL)
+      totalSize = (words < 0) ? -1 : totalSize + words*(long)sizeof(float);
+    else
+      totalSize = keepSelected(out, capacity, totalSize, target, words);
+  }
+  free(scratch);
+  free(coefficients);
+  fftWorkspaceRelease(workspace);
+  return totalSize;
+}
+
+/**
+ * \fn static long dctBlocs(FftElement* fftElement, unsigned int first, int nbBlocs, char* out, size_t capacity)
+ * \brief Write into out the masks and the kept DCT coefficients of nbBlocs blocs from the bloc first (see dctSelect).
+ *
+ * The data of each bloc is found again from its frequencies with an inverse FFT, then transformed by a DCT. As in
+ * adaptiveBlocs, each bloc is selected once and capacity is never exceeded.
+ *
+ * \return number of bytes of the blocs (only computed if out is NULL), -1 on error or if capacity is too small.
+ */
+
+static long dctBlocs(FftElement* fftElement, unsigned int first, int nbBlocs, char* out, size_t capacity)
+{
+  FftWorkspace* inverse = fftWorkspaceAcquire(fftElement->fftSize, 1);
+  FftWorkspace* forward = fftWorkspaceAcquire(fftElement->fftSize, 0);
+  float* data = (float*) malloc(fftElement->fftSize*sizeof(float));
+  float *coefficients = newCoefficients(fftElement), *high;
+  float bound = blocBound(fftElement);
+  char* scratch = NULL;
+  long totalSize = 0;
+  if (inverse == NULL || forward == NULL || data == NULL || coefficients == NULL)
+  {
+    perror("Error : Memory allocation impossible for the DCT");
+    totalSize = -1;
+  }
+  for(int j = 0; j<nbBlocs && totalSize >= 0; j++){
+    int words = -1;
+    char* target = (out == NULL) ? NULL : selectTarget(fftElement, DCT, out, capacity, totalSize, &scratch);
+    float* low = blocArrays(fftElement, first+j, coefficients, &high);
+    if ((out == NULL || target != NULL) && ifftBloc(inverse, low, high, data) == 0)
+      words = dctSelect(forward, data, fftElement->selection, fftElement->errorType, bound, fftElement->coefficientBits, target);
+    if (out == NULL)
+      totalSize = (words < 0) ? -1 : totalSize + words*(long)sizeof(float);
+    else
+      totalSize = keepSelected(out, capacity, totalSize, target, words);
+  }
+  free(scratch);
+  free(data);
+  free(coefficients);
+  fftWorkspaceRelease(inverse);
+  fftWorkspaceRelease(forward);
+  return totalSize;
+}
+
+/**
+ * \fn static unsigned int popBits(FftElement* fftElement, Fft_type fftType)
+ * \brief Return the bits of a coefficient in an array sent by fftPop : FFT_FIXED_BITS for the Low and High arrays of a fixed point FftElement.
+ */
+
+static unsigned int popBits(FftElement* fftElement, Fft_type fftType)
+{
+  if (fftElement->fixedPoint && fftType != ADAPTIVE && fftType != DCT)
+    return FFT_FIXED_BITS;
+  return fftElement->coefficientBits;
+}
+
+/**
+ * \fn static size_t writeFixed(const float* column, unsigned int number, float scale, char* out)
+ * \brief Write the scale then the number Q31 coefficients of an array of a fixed point FftElement into out.
+ *
+ * \return number of bytes written.
+ */
+
+static size_t writeFixed(const float* column, unsigned int number, float scale, char* out)
+{
+  memcpy(out, &scale, sizeof(scale));
+  memcpy(out + sizeof(scale), column, number*sizeof(int32_t));
+  return fftQuantizeWords(number, FFT_FIXED_BITS)*sizeof(float);
+}
+
+/**
+ * \fn static long popBytes(FftElement* fftElement, unsigned int first, int nbBlocs, Fft_type fftType)
+ * \brief Return the number of bytes of the array sent by fftPop for nbBlocs blocs from the bloc first, -1 on error.
+ */
+
+static long popBytes(FftElement* fftElement, unsigned int first, int nbBlocs, Fft_type fftType)
+{
+  size_t totalSize = FFT_POP_PARAM;
+  unsigned int wordsL = fftQuantizeWords(fftElement->sizeCompressedL, popBits(fftElement, fftType));
+  unsigned int wordsH = fftQuantizeWords(fftElement->sizeCompressedH, popBits(fftElement, fftType));
+  if (fftType == ALL)
+    totalSize += (size_t)(wordsL+wordsH)*nbBlocs;
+  if (fftType == LOW)
+    totalSize += (size_t)wordsL*nbBlocs;
+  if (fftType == HIGH)
+    totalSize += (size_t)wordsH*nbBlocs;
+  if (fftType == ADAPTIVE || fftType == DCT)
+  {
+    long selectSize = (fftType == ADAPTIVE) ? adaptiveBlocs(fftElement, first, nbBlocs, NULL, 0) : dctBlocs(fftElement, first, nbBlocs, NULL, 0);
+    if (selectSize < 0)
+      return -1;
+    return (long)(totalSize*sizeof(float)) + selectSize;
+  }
+  return (long)(totalSize*sizeof(float));
+}
+
+/**
+ * \fn long fftPopSize(FftStack* myFftStack, Id_type id,unsigned int startTime, unsigned int stopTime, Erase_mode erase, Fft_type fftType)
+ * \brief Return the size of the buffer needed by fftPopInto with the same parameters (nothing is popped).
+ *
+ * \param myFftStack FftStack instance from which we want to popped the compressed data.
+ * \param id Type of the ID we are looking for (defined in the Id_type enum).
+ * \param startTime unsigned int corresponding to the wanted starting time of data (see fftPop).
+ * \param stopTime unsigned int corresponding to the wanted stoping time of data (see fftPop).
+ * \param erase ERASE/KEEP (an ERASE starts at the first data, as in fftPop).
+ * \param fftType Type of fft which will be send (ALL/LOW/HIGH/ADAPTIVE/DCT).
+ *
+ * \return number of bytes, -1 on error.
+ */
+
+long fftPopSize(FftStack* myFftStack, Id_type id,unsigned int startTime, unsigned int stopTime, Erase_mode erase, Fft_type fftType)
+{
+  unsigned int first;
+  int nbBlocs;
+  FftElement* fftElement = selectBlocs(myFftStack, id, startTime, stopTime, erase, &first, &nbBlocs);
+  if (fftElement == NULL)
+    return -1;
+  return popBytes(fftElement, first, nbBlocs, fftType);
+}
+
+/**
+ * \fn long fftPopInto(FftStack* myFftStack, Id_type id,unsigned int startTime, unsigned int stopTime, Erase_mode erase, Fft_type fftType, void* buffer, size_t bufferSize)
+ * \brief Same as fftPop but the array is written in buffer, without any allocation.
+ *
+ * \param buffer Buffer in which the array is written (it does not need to be aligned).
+ * \param bufferSize Size of buffer in bytes, at least the value returned by fftPopSize.
+ *
+ * \return number of bytes written, -1 on error or if buffer is too small (nothing is popped then).
+ */
+
+long fftPopInto(FftStack* myFftStack, Id_type id,unsigned int startTime, unsigned int stopTime, Erase_mode erase, Fft_type fftType, void* buffer, size_t bufferSize)
+{
+  unsigned int first;
+  int nbBlocs;
+  FftElement* fftElement = selectBlocs(myFftStack, id, startTime, stopTime, erase, &first, &nbBlocs);
+  if (fftElement == NULL)
+    return -1;
+  /*The size of an ADAPTIVE or DCT array is only known once its blocs are selected : bufferSize is checked while they are written*/
+  long totalSize = (fftType == ADAPTIVE || fftType == DCT) ? (long)(FFT_POP_PARAM*sizeof(float)) : popBytes(fftElement, first, nbBlocs, fftType);
+  if (totalSize < 0)
+    return -1;
+  if (buffer == NULL || bufferSize < (size_t)totalSize)
+  {
+    perror("Error : buffer too small for the compressed data");
+    return -1;
+  }
+  FftBloc *blocs = fftElement->blocs;
+  unsigned int time = blocs[first].startTime;
+  unsigned int sizeCompressedL = fftElement->sizeCompressedL, sizeCompressedH = fftElement->sizeCompressedH;
+  float* low = fftElement->low + (size_t)first*sizeCompressedL;
+  float* high = fftElement->high + (size_t)first*sizeCompressedH;
+  float header[FFT_POP_PARAM];
+  header[0] = (float)fftType;
+  header[1] = (float)nbBlocs;
+  header[2] = (float)fftElement->blocSize;
+  header[3] = (float)time;
+  header[4] = (float)(fftElement->timeInterval);
+  header[5] = (float)(blocs[first+nbBlocs-1].dataNumber);
+  header[6] = (float)popBits(fftElement, fftType);
+  header[7] = (float)fftElement->dataType;
+  header[8] = (float)fftElement->fftSize;
+  char* array = (char*) buffer;
+  memcpy(array, header, sizeof(header));
+  array += sizeof(header);
+  /*The Low and High arrays of a bloc are quantized separately : their values have very different ranges. The Q31
+  arrays of a fixed point FftElement are sent as they are, with the scale of their bloc.*/
+  unsigned int bits = fftElement->coefficientBits;
+  for(int j = 0;j<nbBlocs && (fftType == ALL || fftType == LOW || fftType == HIGH);j++){
+    float scale = blocs[first+j].scale;
+    if ((fftType == ALL || fftType == LOW) && fftElement->fixedPoint)
+      array += writeFixed(low + (size_t)j*sizeCompressedL, sizeCompressedL, scale, array);
+    else if (fftType == ALL || fftType == LOW)
+      array += fftQuantize(low + (size_t)j*sizeCompressedL, sizeCompressedL, bits, array)*sizeof(float);
+    if ((fftType == ALL || fftType == HIGH) && fftElement->fixedPoint)
+      array += writeFixed(high + (size_t)j*sizeCompressedH, sizeCompressedH, scale, array);
+    else if (fftType == ALL || fftType == HIGH)
+      array += fftQuantize(high + (size_t)j*sizeCompressedH, sizeCompressedH, bits, array)*sizeof(float);
+  }
+  if (fftType == ADAPTIVE || fftType == DCT)
+  {
+    long selectSize = (fftType == ADAPTIVE) ? adaptiveBlocs(fftElement, first, nbBlocs, array, bufferSize - totalSize) : dctBlocs(fftElement, first, nbBlocs, array, bufferSize - totalSize);
+    if (selectSize < 0)
+      return -1;
+    totalSize += selectSize;
+  }
+  if (erase == ERASE)
+  {
+    fftElement->firstBloc += nbBlocs;
+    fftElement->dataNumber -= nbBlocs;
+    if (fftElement->dataNumber != 0)
+      fftElement->startTime = blocs[fftElement->firstBloc].startTime;
+    else
+    {
+      fftElement->firstBloc = 0;
+      fftElement->startTime = time + nbBlocs * fftElement->blocSize * fftElement->timeInterval;
+    }
+  }
+  return totalSize;
+}
+
+/**
+ * \fn float* fftPop(FftStack* myFftStack, Id_type id,unsigned int startTime, unsigned int stopTime, Erase_mode erase, Fft_type fftType)
+ * \brief Transform and transfer a selected array of data into the compressed data architecture.
+ *
+ * \param myFftStack FftStack instance from which we want to popped the compressed data.
+ * \param id Type of the ID we are looking for (defined in the Id_type enum).
+ * \param startTime unsigned int corresponding to the wanted starting time of data (Must be higher than the startTime of data and lower than the biggest time value). It's possible that data are taken before startTime in case which it isn't at the beginning of a bloc. During an ERASE, this parameter is useless, the first one will be choosen.
+ * \param stopTime unsigned int corresponding to the wanted stoping time of data (Must be higher than the startTime of data and lower than the biggest time value). The stopTime migh be unreached during the storage if a bloc can't be completelly filled.
+ * \param erase if we want to erase the popped data (ERASE/KEEP) (defined in the Erase_mode enum).
+ * \param fftType Type of fft to perform on the data which will be send (ALL/LOW/HIGH/ADAPTIVE/DCT) (defined in the Fft_type enum).
+ *
+ * \return pointer to the array in which the compress data is stored, after FFT_POP_PARAM floats :
+ * array[0] the type of FFT, array[1] the number of blocs, array[2] the size of blocs, array[3] the startTime,
+ * array[4] the timeInterval, array[5] the number of data of the last bloc (lower than the size of blocs when it was
+ * padded before a gap), array[6] the bits of a coefficient (see fftSetQuantization), array[7] the Data_type of the
+ * channel (see ifftDataType) and array[8] the size of the transform of a bloc (fftSize, the data after the size of
+ * blocs are dropped by the decoding). The array stops at the first gap between two blocs. Use fftPopSize and
+ * fftPopInto to write it in an existing buffer.
+ */
+
+
+float* fftPop(FftStack* myFftStack, Id_type id,unsigned int startTime, unsigned int stopTime, Erase_mode erase, Fft_type fftType)
 {
-  unsigned int nbElement = 0;
-  unsigned timeInterval =0;
-  if (myFftStack == NULL)
-  {
-    perror("Error : the FftStack should be initialied before\n");
+  unsigned int first;
+  int nbBlocs;
+  FftElement* fftElement = selectBlocs(myFftStack, id, startTime, stopTime, erase, &first, &nbBlocs);
+  if (fftElement == NULL)
     return NULL;
-  }
-  IdElement* idElement;
-  idElement = searchIdElement(myIdStack,id);
-  if (idElement == NULL)
+  /*An ADAPTIVE or DCT array is written into a buffer for its largest size, then shrunk : its blocs are selected once*/
+  long boundSize = (fftType == ADAPTIVE || fftType == DCT) ? (long)(FFT_POP_PARAM*sizeof(float) + (size_t)nbBlocs*selectBound(fftElement, fftType)) : popBytes(fftElement, first, nbBlocs, fftType);
+  if (boundSize < 0)
+    return NULL;
+  float* array = (float*) malloc(boundSize);
+  if (array == NULL)
   {
-    perror("Error : The Element corresponding to the ID is inexistant\n");
+    perror("Error : Allocation array for compressed data impossible");
     return NULL;
   }
-  if (idElement->dataType != FLOAT)
+  long totalSize = fftPopInto(myFftStack, id, startTime, stopTime, erase, fftType, array, boundSize);
+  if (totalSize < 0)
   {
-    perror("Error : Elements corresponding to the ID are not Floats\n");
+    free(array);
     return NULL;
   }
-  unsigned int startTime = idElement->startTime;
-  if (startTime > stopTime)
+  if (totalSize < boundSize)
   {
-    perror("Error : stopTime should be higher than startTime\n");
-    return NULL;
+    float* shrunk = (float*) realloc(array, totalSize);
+    if (shrunk != NULL)
+      array = shrunk;
   }
+  return array;
+}
 
-  timeInterval = idElement->timeInterval;
-  unsigned int finalTime = (idElement->startTime) + (idElement->dataNumber-1)*(idElement->timeInterval);
-  nbElement = stackNumberCount(idElement->dataStack, idElement->timeInterval, finalTime,startTime,stopTime);
+/**
+ * \struct FftHeader
+ * \brief Parameters of an array sent by fftPop.
+ */
 
+typedef struct FftHeader FftHeader;
+struct FftHeader
+{
+  Fft_type fftType;
+  unsigned int nbBlocs;
+  unsigned int sizeBlocs;  //number of data of a bloc
+  unsigned int fftSize;  //size of the transform of a bloc, the data after sizeBlocs are dropped
+  unsigned int startTime;
+  unsigned int timeInterval;
+  unsigned int lastNumber;  //number of data of the last bloc
+  unsigned int bits;  //bits of a coefficient
+  Data_type dataType;  //type of the data of the channel
+  unsigned int sizeCompressedL;
+  unsigned int sizeCompressedH;
+};
 
-  FftElement* myFftElement;
-  myFftElement = searchFftElement(myFftStack, id);
-  if (myFftElement == NULL)
+/**
+ * \fn static int readHeader(float* array, FftHeader* header)
+ * \brief Read and check the parameters of an array sent by fftPop.
+ *
+ * \return 0 if it SUCCESSED, -1 if it FAILED.
+ */
+
+static int readHeader(float* array, FftHeader* header)
+{
+  //array[0] = Fft_Type
+  //array[1] = nbBlocs
+  //array[2] = sizeBlocs
+  //array[3] = startTime
+  //array[4] = timeInterval
+  //array[5] = number of data of the last bloc
+  //array[6] = bits of a coefficient
+  //array[7] = Data_type of the channel
+  //array[8] = size of the transform of a bloc
+  if (array == NULL)
   {
-    perror("Error : The FftElement should be initialized before\n");
-    return NULL;
+    perror("Error : No compressed data");
+    return -1;
   }
-  myFftElement->id = id;
-  myFftElement->timeInterval = timeInterval;
-  unsigned int blocSize = myFftElement->blocSize;
-  if (blocSize > nbElement)
+  header->fftType = (Fft_type)(int)array[0];
+  header->nbBlocs = (unsigned int)array[1];
+  header->sizeBlocs = (unsigned int)array[2];
+  header->startTime = (unsigned int)array[3];
+  header->timeInterval = (unsigned int)array[4];
+  header->lastNumber = (unsigned int)array[5];
+  header->bits = (unsigned int)array[6];
+  header->dataType = (Data_type)(int)array[7];
+  header->fftSize = (unsigned int)array[8];
+  header->sizeCompressedL = ((header->fftSize+2)/2)+((header->fftSize+2)/2)%2;
+  header->sizeCompressedH = ((header->fftSize)/2)+((header->fftSize)/2)%2;
+  if ((header->fftType != ALL && header->fftType != LOW && header->fftType != HIGH && header->fftType != ADAPTIVE && header->fftType != DCT) || header->nbBlocs < 1 || header->sizeBlocs < 1 || header->fftSize < header->sizeBlocs || header->lastNumber < 1 || header->lastNumber > header->sizeBlocs || (header->bits != 8 && header->bits != 16 && header->bits != 32 && (header->bits != FFT_FIXED_BITS || header->fftType == ADAPTIVE || header->fftType == DCT)) || header->dataType == CHAR || sizeDataType(header->dataType) < 0)
   {
-    perror("Error : Unable to store compressed data, the number of elements is lower than the size of blocs\n");
-    return NULL;
-  }
-  else {
-    unsigned int nbBlocs = (unsigned int)(nbElement/(myFftElement->blocSize));
-
-    FftDataStack* myFftDataStack = myFftElement -> fftDataStack;
-    if ( myFftElement -> fftDataStack != NULL){
-      while (myFftDataStack->next != NULL){
-        myFftDataStack = myFftDataStack->next;
-      }
-    }
-    float* dataPointer;
-    for(unsigned int i = 0 ; i<nbBlocs;i++)
-    {
-      dataPointer = dataIdStackPop(myIdStack,id,startTime +((i+1)*blocSize-1)*timeInterval);
-      if (myFftDataStack == NULL){
-        myFftElement -> fftDataStack = (FftDataStack*) malloc(sizeof(*myFftDataStack));
-        if (myFftElement -> fftDataStack == NULL)
-        {
-          perror("Error : Memory allocation for myFftElement -> fftDataStack impossible");
-          return NULL;
-        }
-        myFftElement->startTime = startTime;
-        myFftDataStack = myFftElement -> fftDataStack;
-      }
-      else{
-        myFftDataStack -> next = (FftDataStack*) malloc(sizeof(*myFftDataStack));
-        if (myFftDataStack -> next == NULL)
-          {
-            perror("Error : Memory allocation for myFftDataStack -> next impossible");
-            return NULL;
-          }
-        myFftDataStack = myFftDataStack -> next;
-      }
-      if (dataPointer == NULL){
-        perror("Error : Unable to Pop uncompressed Data");
-        return NULL;
-      }
-      myFftDataStack -> pointerHigh = fftHigh(dataPointer,blocSize);
-      myFftDataStack -> pointerLow = fftLow(dataPointer,blocSize);
-      free(dataPointer);
-      myFftElement->dataNumber += 1;
-    }
-    myFftDataStack -> next = NULL;
-
-
+    perror("Error : Wrong parameters of compressed data");
+    return -1;
   }
-  return myFftElement;
+  return 0;
 }
 
 /**
- * \fn float* fftPop(FftStack* myFftStack, Id_type id,unsigned int startTime, unsigned int stopTime, Erase_mode erase, Fft_type fftType)
- * \brief Transform and transfer a selected array of data into the compressed data architecture.
+ * \fn static float* decodeBloc(FftWorkspace* workspace, float* array, FftHeader* header, float* coefficients, float* dataOut)
+ * \brief Write the fftSize data of the bloc which starts at array (in the data of an array sent by fftPop) into dataOut.
  *
- * \param myFftStack FftStack instance from which we want to popped the compressed data.
- * \param id Type of the ID we are looking for (defined in the Id_type enum).
- * \param startTime unsigned int corresponding to the wanted starting time of data (Must be higher than the startTime of data and lower than the biggest time value). It's possible that data are taken before startTime in case which it isn't at the beginning of a bloc. During an ERASE, this parameter is useless, the first one will be choosen.
- * \param stopTime unsigned int corresponding to the wanted stoping time of data (Must be higher than the startTime of data and lower than the biggest time value). The stopTime migh be unreached during the storage if a bloc can't be completelly filled.
- * \param erase if we want to erase the popped data (ERASE/KEEP) (defined in the Erase_mode enum).
- * \param fftType Type of fft to perform on the data which will be send (ALL/LOW/HIGH) (defined in the Fft_type enum).
+ * coefficients receives the dequantized arrays of the bloc (sizeCompressedL+sizeCompressedH floats), it is not used
+ * when the coefficients are floats.
  *
- * \return pointer to the array in which the compress data is stored with first the type of FFT, the number of blocs, the size of blocs and then the startTime.
+ * \return pointer to the next bloc, NULL on error.
  */
 
-
-float* fftPop(FftStack* myFftStack, Id_type id,unsigned int startTime, unsigned int stopTime, Erase_mode erase, Fft_type fftType)
+static float* decodeBloc(FftWorkspace* workspace, float* array, FftHeader* header, float* coefficients, float* dataOut)
 {
-
-  int nbParam = 5;  //Number of parameter before the data.
-  if (myFftStack == NULL)
+  unsigned int sizeCompressedL = header->sizeCompressedL, sizeCompressedH = header->sizeCompressedH, bits = header->bits;
+  if (header->fftType == ADAPTIVE || header->fftType == DCT)
   {
-    perror("Error : the FftStack should be initialied before");
-    return NULL;
+    int words = (header->fftType == ADAPTIVE) ? ifftSelect(workspace, array, bits, dataOut) : idctSelect(workspace, array, bits, dataOut);
+    return (words < 0) ? NULL : array + words;
   }
-  FftElement* fftElement;
-  fftElement = searchFftElement(myFftStack, id);
-  if (fftElement == NULL)
+  float *low = NULL, *high = NULL;
+  float* next = array;
+  if (header->fftType == ALL || header->fftType == LOW)
   {
-    perror("Error : The FftElement should be initialized before");
-    return NULL;
+    low = (bits == 32) ? next : coefficients;
+    next += fftDequantize(next, sizeCompressedL, bits, low);
   }
-  if (erase == ERASE)
+  if (header->fftType == ALL || header->fftType == HIGH)
   {
-    startTime = fftElement->startTime;
+    high = (bits == 32) ? next : coefficients + sizeCompressedL;
+    next += fftDequantize(next, sizeCompressedH, bits, high);
   }
-  int nbBlocs = blocNumberCount(fftElement,startTime,stopTime);
-  if (nbBlocs < 1)
+  return (ifftBloc(workspace, low, high, dataOut) != 0) ? NULL : next;
+}
+
+/**
+ * \fn long ifftSize(float* array)
+ * \brief Return the number of data of an array sent by fftPop (the size needed by ifftDecode).
+ *
+ * \param array Array of compressed data sent by fftPop.
+ * \return number of data, -1 if the array is wrong.
+ */
+
+long ifftSize(float* array)
+{
+  FftHeader header;
+  if (readHeader(array, &header) != 0)
+    return -1;
+  return (long)(header.nbBlocs-1)*header.sizeBlocs + header.lastNumber;
+}
+
+/**
+ * \fn long ifftDecode(float* array, unsigned int* times, float* values, size_t capacity)
+ * \brief Uncompress the data sent by fftPop into the buffers of the caller.
+ *
+ * \param array Array of compressed data sent by fftPop (it is not freed).
+ * \param times Array in which the time of each data is written, NULL if the times are not wanted.
+ * \param values Array in which the data is written.
+ * \param capacity Number of data which can be written in times and values, at least the value returned by ifftSize.
+ * \return number of data written, -1 on error or if the buffers are too small.
+ */
+
+long ifftDecode(float* array, unsigned int* times, float* values, size_t capacity)
+{
+  FftHeader header;
+  if (readHeader(array, &header) != 0)
+    return -1;
+  unsigned int nbBlocs = header.nbBlocs, sizeBlocs = header.sizeBlocs, lastNumber = header.lastNumber, fftSize = header.fftSize;
+  size_t totalSize = (size_t)(nbBlocs-1)*sizeBlocs + lastNumber;
+  if (values == NULL || capacity < totalSize)
   {
-    perror("Error : Number of blocs must be higher than 0");
-    return NULL;
+    perror("Error : buffer too small for the uncompressed data");
+    return -1;
   }
-  //
-  unsigned int time = fftElement->startTime;
-  FftDataStack *fftDataStack = fftElement->fftDataStack;
-  if(fftDataStack == NULL)
+  /*The full blocs are written in place when they weren't extended, only a padded last bloc needs a copy then.
+  Quantized coefficients need a bloc of floats too.*/
+  unsigned int fullBlocs = (fftSize != sizeBlocs) ? 0 : (lastNumber == sizeBlocs) ? nbBlocs : nbBlocs-1;
+  size_t scratchSize = ((fullBlocs < nbBlocs) ? fftSize : 0) + ((header.bits != 32) ? header.sizeCompressedL+header.sizeCompressedH : 0);
+  float* scratch = NULL;
+  if (scratchSize > 0 && (scratch = (float*)malloc(scratchSize*sizeof(float))) == NULL)
   {
-    perror("Error : No data in FftDataStack");
-    return NULL;
+    perror("Error : Memory allocation impossible for a bloc");
+    return -1;
   }
-  while(time + fftElement->timeInterval * (fftElement->blocSize-1) < startTime){
-    fftDataStack = fftDataStack->next;
-    time += fftElement->timeInterval * fftElement->blocSize;
+  FftWorkspace* workspace = fftWorkspaceAcquire(fftSize, 1);
+  float* coefficients = scratch;
+  float* tabTemp = (header.bits != 32) ? scratch + header.sizeCompressedL+header.sizeCompressedH : scratch;
+  float* array2 = (workspace == NULL) ? NULL : array+FFT_POP_PARAM;
+  for(unsigned int i = 0; i<fullBlocs && array2 != NULL; i++){
+    array2 = decodeBloc(workspace, array2, &header, coefficients, values + (size_t)i*sizeBlocs);
   }
-  //
-  float* array = NULL;
-  unsigned int totalSize;
-  if (fftType == ALL)
+  for(unsigned int i = fullBlocs; i<nbBlocs && array2 != NULL; i++){
+    array2 = decodeBloc(workspace, array2, &header, coefficients, tabTemp);
+    if (array2 != NULL)
+      memcpy(values + (size_t)i*sizeBlocs, tabTemp, ((i == nbBlocs-1) ? lastNumber : sizeBlocs)*sizeof(float));
+  }
+  fftWorkspaceRelease(workspace);
+  free(scratch);
+  if (array2 == NULL)
+    return -1;
+  if (times != NULL)
   {
-    totalSize = (fftElement->sizeCompressedL+fftElement->sizeCompressedH)*nbBlocs+nbParam;
-    array = (float*) malloc(totalSize*sizeof(float));
-    if (array == NULL)
-    {
-      perror("Error : Allocation array for compressed data impossible");
-      return NULL;
-    }
-    float* array2 = array+nbParam;
-    for(int j = 0;j<nbBlocs;j++){
-      for(unsigned int i=0;i<fftElement->sizeCompressedL;i++)
-      {
-        array2[i+j*(fftElement->sizeCompressedL+fftElement->sizeCompressedH)] = fftDataStack->pointerLow[i];
-      }
-      int g =0;
-      for(unsigned int i=fftElement->sizeCompressedL;i<fftElement->sizeCompressedL+fftElement->sizeCompressedH;i++)
-      {
-        array2[i+j*(fftElement->sizeCompressedL+fftElement->sizeCompressedH)] = fftDataStack->pointerHigh[g];
-        g++;
-      }
-      fftDataStack = fftDataStack->next;
+    unsigned int time = header.startTime;
+    for(size_t i = 0; i<totalSize; i++){
+      times[i] = time;
+      time += header.timeInterval;
     }
   }
-  if (fftType == LOW)
+  return (long)totalSize;
+}
+
+/**
+ * \fn int ifftStream(float* array, Decode_function sink, void* context)
+ * \brief Uncompress the data sent by fftPop bloc after bloc, each bloc is given to sink.
+ *
+ * \param array Array of compressed data sent by fftPop (it is not freed).
+ * \param sink Function called with the data of each bloc (the values are only valid during the call).
+ * \param context Pointer given to sink.
+ * \return number of blocs given to sink, -1 on error.
+ */
+
+int ifftStream(float* array, Decode_function sink, void* context)
+{
+  FftHeader header;
+  if (readHeader(array, &header) != 0)
+    return -1;
+  if (sink == NULL)
   {
-    totalSize = fftElement->sizeCompressedL*nbBlocs+nbParam;
-    array = (float*)malloc(totalSize*sizeof(float));
-    if (array == NULL)
-    {
-      perror("Error : Memory allocation impossible for Low frequency array\n");
-      return NULL;
-    }
-    float* array2 = array+nbParam;
-    for(int j = 0;j<nbBlocs;j++){
-      for(unsigned int i=0;i<fftElement->sizeCompressedL;i++)
-      {
-        array2[i+j*fftElement->sizeCompressedL] = fftDataStack->pointerLow[i];
-      }
-      fftDataStack = fftDataStack->next;
-    }
+    perror("Error : No function to call with the data");
+    return -1;
   }
-  if (fftType == HIGH)
+  unsigned int nbBlocs = header.nbBlocs, sizeBlocs = header.sizeBlocs, fftSize = header.fftSize;
+  float* tabTemp = (float*)malloc((fftSize+header.sizeCompressedL+header.sizeCompressedH)*sizeof(float));
+  FftWorkspace* workspace = fftWorkspaceAcquire(fftSize, 1);
+  if (tabTemp == NULL || workspace == NULL)
   {
-    totalSize = fftElement->sizeCompressedH*nbBlocs+nbParam;
-    array = (float*)malloc(totalSize*sizeof(float));
-    if (array == NULL)
+    perror("Error : Memory allocation impossible for a bloc");
+    free(tabTemp);
+    fftWorkspaceRelease(workspace);
+    return -1;
+  }
+  float* array2 = array+FFT_POP_PARAM;
+  unsigned int time = header.startTime, timeInterval = header.timeInterval;
+  unsigned int i;
+  for(i = 0; i<nbBlocs; i++){
+    array2 = decodeBloc(workspace, array2, &header, tabTemp + fftSize, tabTemp);
+    if (array2 == NULL)
     {
-      perror("Error : Memory allocation impossible for High frequency array\n");
-      return NULL;
+      free(tabTemp);
+      fftWorkspaceRelease(workspace);
+      return -1;
     }
-    float* array2 = array+nbParam;
-    for(int j = 0;j<nbBlocs;j++){
-      for(unsigned int i=0;i<fftElement->sizeCompressedH;i++)
-      {
-        array2[i+j*fftElement->sizeCompressedH] = fftDataStack->pointerHigh[i];
-      }
-      fftDataStack = fftDataStack->next;
+    unsigned int number = (i == nbBlocs-1) ? header.lastNumber : sizeBlocs;
+    if (sink(time, timeInterval, tabTemp, number, context) != 0)
+    {
+      i++;
+      break;
     }
+    time += sizeBlocs*timeInterval;
   }
+  fftWorkspaceRelease(workspace);
+  free(tabTemp);
+  return (int)i;
+}
 
-  array[0] = (float)fftType;
-  array[1] = (float)nbBlocs;
-  array[2] = (float)fftElement->blocSize;
-  array[3] = (float)time;
-  array[4] = (float)(fftElement->timeInterval);
-  if (erase == ERASE)
+/**
+ * \struct DataSink
+ * \brief Buffers filled by ifftDecodeData through ifftStream.
+ */
+
+typedef struct DataSink DataSink;
+struct DataSink
+{
+  char *data;  //next data to write
+  unsigned int *times;  //next time to write, NULL if the times are not wanted
+  Data_type dataType;  //type of the data
+  size_t numberSize;  //size of a data
+};
+
+/**
+ * \fn static int dataSink(unsigned int startTime, unsigned int timeInterval, float* values, unsigned int number, void* context)
+ * \brief Decode_function converting the data of a bloc into the buffers of a DataSink.
+ */
+
+static int dataSink(unsigned int startTime, unsigned int timeInterval, float* values, unsigned int number, void* context)
+{
+  DataSink* sink = (DataSink*)context;
+  fftFloatToData(values, number, sink->dataType, sink->data);
+  sink->data += number*sink->numberSize;
+  for (unsigned int i = 0; sink->times != NULL && i < number; i++)
+    *sink->times++ = startTime + i*timeInterval;
+  return 0;
+}
+
+/**
+ * \fn long ifftDecodeData(float* array, unsigned int* times, void* data, size_t capacity)
+ * \brief Uncompress the data sent by fftPop into data of the type of its channel (see ifftDataType).
+ *
+ * The data is decoded bloc after bloc and converted with fftFloatToData.
+ *
+ * \param array Array of compressed data sent by fftPop (it is not freed).
+ * \param times Array in which the time of each data is written, NULL if the times are not wanted.
+ * \param data Array in which the data is written, with the type of the channel.
+ * \param capacity Number of data which can be written in times and data, at least the value returned by ifftSize.
+ * \return number of data written, -1 on error or if the buffers are too small.
+ */
+
+long ifftDecodeData(float* array, unsigned int* times, void* data, size_t capacity)
+{
+  FftHeader header;
+  long number = ifftSize(array);
+  if (number < 0 || readHeader(array, &header) != 0)
+    return -1;
+  if (data == NULL || capacity < (size_t)number)
   {
-    FftDataStack *fftDataStack = fftElement->fftDataStack;
-    FftDataStack *previousFftDataStack = fftElement->fftDataStack;
-    for(int i = 0; i < nbBlocs;i++)
-    {
-      free(fftDataStack->pointerLow);
-      free(fftDataStack->pointerHigh);
-      fftDataStack = fftDataStack->next;
-      free(previousFftDataStack);
-      previousFftDataStack = fftDataStack;
-    }
-    fftElement->dataNumber -= nbBlocs;
-    fftElement->fftDataStack = fftDataStack;
-    fftElement->startTime += nbBlocs * fftElement->blocSize * fftElement->timeInterval;
+    perror("Error : buffer too small for the uncompressed data");
+    return -1;
   }
-  return array;
+  DataSink sink = {(char*)data, times, header.dataType, (size_t)sizeDataType(header.dataType)};
+  if (ifftStream(array, dataSink, &sink) < 0)
+    return -1;
+  return number;
+}
+
+/**
+ * \fn int ifftDataType(float* array)
+ * \brief Return the Data_type of the channel of the data sent by fftPop, -1 on error.
+ */
+
+int ifftDataType(float* array)
+{
+  FftHeader header;
+  if (readHeader(array, &header) != 0)
+    return -1;
+  return (int)header.dataType;
 }
 
 /**
  * \fn float* float* ifft(float* array)
- * \brief Uncompress and print the data sent by fftPop.
+ * \brief Uncompress and print the data sent by fftPop. Use ifftDecode or ifftStream to get the data.
  *
- * \param array Array of compressed data compressed sent by fftPop.
+ * \param array Array of compressed data compressed sent by fftPop (it is freed).
  *
  * \return NULL.
  */
 
 float* ifft(float* array){
-  //array[0] = Fft_Type
-  //array[1] = nbBlocs
-  //array[2] = sizeBlocs
-  //array[3] = startTime
-  //array[4] = timeInterval
-
-  Fft_type fftType = (int)array[0];
-  unsigned int nbBlocs = ((unsigned int)array[1]);
-  unsigned int sizeBlocs =((unsigned int)array[2]);
-  unsigned int startTime = ((unsigned int)array[3]);
-  unsigned int timeInterval= ((unsigned int)array[4]);
-  unsigned int nbParam = 5;
-  unsigned int totalSize = nbBlocs*sizeBlocs;
-  float* array2 = array+nbParam;
-  float *tabTemp,*tabTemp2;
-  float* tabExit = (float*)malloc(totalSize*sizeof(float));
-  unsigned int sizeCompressedH, sizeCompressedL;
-
-  if (array == NULL)
+  long totalSize = ifftSize(array);
+  if (totalSize < 0)
   {
-    perror("Error : Memory allocation impossible for Exit array\n");
+    free(array);
     return NULL;
   }
-  if (fftType == LOW){
-    sizeCompressedL = ((sizeBlocs+2)/2)+((sizeBlocs+2)/2)%2;
-    for(unsigned int i = 0; i<nbBlocs;i++){
-      tabTemp = ifftLow(array2 + i*sizeCompressedL,sizeBlocs);
-      for(unsigned int j = 0; j<sizeBlocs;j++){
-        tabExit[j+i*nbBlocs] = tabTemp[j];
-      }
-      free(tabTemp);
-    }
-  }
-  if (fftType == HIGH){
-    sizeCompressedH = ((sizeBlocs)/2)+((sizeBlocs)/2)%2;
-    for(unsigned int i = 0; i<nbBlocs;i++){
-      tabTemp = ifftHigh(array2 + i*sizeCompressedH,sizeBlocs);
-      for(unsigned int j = 0; j<sizeBlocs;j++){
-        tabExit[j+i*nbBlocs] = tabTemp[j];
-      }
-      free(tabTemp);
-    }
+  unsigned int* times = (unsigned int*)malloc(totalSize*sizeof(unsigned int));
+  float* tabExit = (float*)malloc(totalSize*sizeof(float));
+  if (times == NULL || tabExit == NULL)
+  {
+    perror("Error : Memory allocation impossible for Exit array\n");
   }
-  if (fftType == ALL){
-    sizeCompressedL = ((sizeBlocs+2)/2)+((sizeBlocs+2)/2)%2;
-    sizeCompressedH = ((sizeBlocs)/2)+((sizeBlocs)/2)%2;
-    for(unsigned int i = 0; i<nbBlocs;i++){
-      tabTemp = ifftLow(array2 + i*(sizeCompressedL+sizeCompressedH),sizeBlocs);
-      tabTemp2= ifftHigh(array2 +i*(sizeCompressedL+sizeCompressedH) + sizeCompressedL,sizeBlocs);
-      for(unsigned int j = 0; j<sizeBlocs;j++){
-        tabExit[j+i*sizeBlocs] = tabTemp[j] + tabTemp2[j];
-      }
-      free(tabTemp);
-      free(tabTemp2);
+  else if (ifftDecode(array, times, tabExit, totalSize) == totalSize)
+  {
+    printf("\nTIME\tVALUE\n");
+    for(long i = 0; i<totalSize;i++){
+      printf("%d\t%f\n",times[i],tabExit[i]);
     }
   }
-  unsigned int time = startTime;
-  printf("\nTIME\tVALUE\n");
-  for(unsigned int i = 0; i<totalSize;i++){
-    printf("%d\t%f\n",time,tabExit[i]);
-    time += timeInterval;
-  }
   free(array);
+  free(times);
   free(tabExit);
-  //return array2;
   return NULL;
 }
 
@@ -398,14 +1853,14 @@ float* ifft(float* array){
  *
  * \param myFftStack FftStack instance in which we want to initialize a new FftElement.
  * \param id Type of the ID to initialize (defined in the Id_type enum).
- * \param blocSize Size of each compressed bloc. This parameter should be choosen be carrefuly : Indeed, a bloc couldn't be split and have to be completely full before the send. It must be a multiple of 2; But a bigger value implies a bigger compression.
+ * \param blocSize Size of each compressed bloc. This parameter should be choosen be carrefuly : Indeed, a bloc couldn't be split and have to be completely full before the send. Any size can be used : the blocs are transformed with the size given by fftFastSize (see fftFreq.h), the data added to a bloc being dropped by the decoding. But a bigger value implies a bigger compression.
  * \return the initialized fftElement instance.
  */
 
 
 FftElement* initializeFftElement(FftStack *myFftStack, Id_type id, unsigned int blocSize)
 {
-  if (blocSize < 1) {
+  if (blocSize < 1 || fftFastSize(blocSize) == 0) {
     perror("Error : Size of blocs should be higher than 0\n");
     return NULL;
   }
@@ -422,10 +1877,21 @@ FftElement* initializeFftElement(FftStack *myFftStack, Id_type id, unsigned int
     }
   fftElement -> id = id;
   fftElement -> blocSize = blocSize; //>=1
-  fftElement -> sizeCompressedH = ((blocSize)/2)+((blocSize)/2)%2;
-  fftElement -> sizeCompressedL = ((blocSize+2)/2)+((blocSize+2)/2)%2;
+  fftElement -> fftSize = fftFastSize(blocSize);
+  fftElement -> sizeCompressedH = ((fftElement->fftSize)/2)+((fftElement->fftSize)/2)%2;
+  fftElement -> sizeCompressedL = ((fftElement->fftSize+2)/2)+((fftElement->fftSize+2)/2)%2;
   fftElement ->dataNumber = 0;  //4    number of blocs of data in the FftElement.
-  fftElement ->fftDataStack = NULL;
+  fftElement ->firstBloc = 0;
+  fftElement ->blocCapacity = 0;
+  fftElement ->low = NULL;
+  fftElement ->high = NULL;
+  fftElement ->blocs = NULL;
+  fftElement ->selection = TOP_K;
+  fftElement ->errorType = RMS_ERROR;
+  fftElement ->errorBound = 0.f;
+  fftElement ->coefficientBits = 32;
+  fftElement ->dataType = FLOAT;
+  fftElement ->fixedPoint = 0;
   fftElement ->next = NULL;
   fftElement -> next = myFftStack -> first;
   myFftStack->first = fftElement;
@@ -461,23 +1927,11 @@ int deinitializeFftElement(FftStack *myFftStack, Id_type id)
   }
   previousFftElement -> next = currentFftElement -> next;
   //deinitialize
-  FftDataStack* myFftDataStack = currentFftElement -> fftDataStack;
-  FftDataStack* oldFftDataStack = myFftDataStack;
-  if(myFftDataStack != NULL)
-  {
-    while (myFftDataStack->next != NULL) {
-      free(myFftDataStack -> pointerHigh);
-      free(myFftDataStack -> pointerLow);
-      oldFftDataStack = myFftDataStack;
-      myFftDataStack = myFftDataStack -> next;
-      free(oldFftDataStack);
-    }
-    free(myFftDataStack -> pointerHigh);
-    free(myFftDataStack -> pointerLow);
-    free(myFftDataStack);
-  }
   if (myFftStack->first == currentFftElement)
     myFftStack->first = currentFftElement->next;
+  free(currentFftElement->low);
+  free(currentFftElement->high);
+  free(currentFftElement->blocs);
   free(currentFftElement);
   return id;
 }
@@ -504,23 +1958,9 @@ int deinitializeFirstFftElement(FftStack *myFftStack)
     {
         id = fftElement->id;
         myFftStack->first = fftElement->next;
-
-
-  FftDataStack* myFftDataStack = fftElement -> fftDataStack;
-  FftDataStack* oldFftDataStack = myFftDataStack;
-  if(myFftDataStack != NULL)
-  {
-    while (myFftDataStack->next != NULL) {
-      free(myFftDataStack -> pointerHigh);
-      free(myFftDataStack -> pointerLow);
-      oldFftDataStack = myFftDataStack;
-      myFftDataStack = myFftDataStack -> next;
-      free(oldFftDataStack);
-    }
-    free(myFftDataStack -> pointerHigh);
-    free(myFftDataStack -> pointerLow);;
-    free(myFftDataStack);
-  }
+        free(fftElement->low);
+        free(fftElement->high);
+        free(fftElement->blocs);
         free(fftElement);
     }
   return id;
@@ -556,6 +1996,104 @@ FftElement* searchFftElement(FftStack *myFftStack, Id_type id)
 }
 
 
+/**
+ * \fn int fftSetErrorBound(FftStack* myFftStack, Id_type id, Select_mode selection, Error_type errorType, float bound)
+ * \brief Set the error allowed on each bloc by the ADAPTIVE and DCT pops of a FftElement.
+ *
+ * The bound includes the error of the quantization set by fftSetQuantization : with 8 or 16 bits, fewer
+ * coefficients are dropped, and a bound below the quantization error of the kept coefficients can not be met.
+ *
+ * \param myFftStack FftStack instance which contains the FftElement.
+ * \param id Type of the ID of the FftElement (defined in the Id_type enum).
+ * \param selection TOP_K to keep the largest frequencies, BAND to keep the lowest frequencies.
+ * \param errorType RMS_ERROR to bound the RMS error of the data of a bloc, MAX_ERROR to bound its max error.
+ * \param bound Error allowed (0 by default : only the null frequencies are dropped).
+ * \return 0 if it SUCCESSED, -1 if it FAILED.
+ */
+
+int fftSetErrorBound(FftStack* myFftStack, Id_type id, Select_mode selection, Error_type errorType, float bound)
+{
+  FftElement* fftElement = searchFftElement(myFftStack, id);
+  if (fftElement == NULL)
+  {
+    perror("Error : The FftElement should be initialized before");
+    return -1;
+  }
+  if (bound < 0 || (selection != TOP_K && selection != BAND) || (errorType != RMS_ERROR && errorType != MAX_ERROR))
+  {
+    perror("Error : Wrong error bound");
+    return -1;
+  }
+  fftElement->selection = selection;
+  fftElement->errorType = errorType;
+  fftElement->errorBound = bound;
+  return 0;
+}
+
+/**
+ * \fn int fftSetQuantization(FftStack* myFftStack, Id_type id, unsigned int bits)
+ * \brief Set the bits of a coefficient in the arrays popped from a FftElement.
+ *
+ * With 8 or 16 bits, each Low, High (or ADAPTIVE) array of a bloc is sent as unsigned integers with its offset and
+ * its scale (see fftQuantize) : the error of a coefficient is lower than half of its scale. The ADAPTIVE and DCT
+ * pops count this error in the bound set by fftSetErrorBound.
+ *
+ * \param myFftStack FftStack instance which contains the FftElement.
+ * \param id Type of the ID of the FftElement (defined in the Id_type enum).
+ * \param bits 8 or 16 for integers, 32 for floats (by default).
+ * \return 0 if it SUCCESSED, -1 if it FAILED.
+ */
+
+int fftSetQuantization(FftStack* myFftStack, Id_type id, unsigned int bits)
+{
+  FftElement* fftElement = searchFftElement(myFftStack, id);
+  if (fftElement == NULL)
+  {
+    perror("Error : The FftElement should be initialized before");
+    return -1;
+  }
+  if (bits != 8 && bits != 16 && bits != 32)
+  {
+    perror("Error : A coefficient must be quantized on 8, 16 or 32 bits");
+    return -1;
+  }
+  fftElement->coefficientBits = bits;
+  return 0;
+}
+
+/**
+ * \fn int fftSetFixedPoint(FftStack* myFftStack, Id_type id, int fixedPoint)
+ * \brief Transform the INT16_T or INT32_T data of a FftElement in fixed point and keep its frequencies in Q31.
+ *
+ * For nodes without FPU : the blocs are transformed by fftSplitBatchFixed, and their Q31 frequencies are stored and
+ * sent by the ALL, LOW and HIGH pops (with FFT_FIXED_BITS bits, the quantization set by fftSetQuantization being
+ * kept for the ADAPTIVE and DCT pops). The decoding converts them into floats. By default (fixedPoint 0), the data
+ * of every type is converted into floats and transformed by a float FFT, which is faster and more accurate with an
+ * FPU. A push of the FftElement fails if its channel isn't INT16_T or INT32_T.
+ *
+ * \param myFftStack FftStack instance which contains the FftElement.
+ * \param id Type of the ID of the FftElement (defined in the Id_type enum).
+ * \param fixedPoint 1 for the fixed point transform, 0 for the float one.
+ * \return 0 if it SUCCESSED, -1 if it FAILED (the FftElement still stores blocs).
+ */
+
+int fftSetFixedPoint(FftStack* myFftStack, Id_type id, int fixedPoint)
+{
+  FftElement* fftElement = searchFftElement(myFftStack, id);
+  if (fftElement == NULL)
+  {
+    perror("Error : The FftElement should be initialized before");
+    return -1;
+  }
+  if (fftElement->dataNumber != 0 && fftElement->fixedPoint != (fixedPoint != 0))
+  {
+    perror("Error : The transform can't be changed while the FftElement stores blocs");
+    return -1;
+  }
+  fftElement->fixedPoint = (fixedPoint != 0);
+  return 0;
+}
+
 /**
  * \fn int blocNumberCount(FftElement *fftElement, unsigned int startTime,unsigned int stopTime)
  * \brief Function used to count the number of blocs satisfying the time condition.
@@ -574,8 +2112,12 @@ int blocNumberCount(FftElement *fftElement, unsigned int startTime,unsigned int
         perror("Error : fftElement uninitialized");
     return -1;
     }
-  unsigned int finalTime = fftElement->startTime + (fftElement->dataNumber * fftElement->blocSize -1)* fftElement->timeInterval ;
-  if(stopTime>finalTime)
+  if(fftElement->dataNumber == 0)
+  {
+    perror("Error : No data in FftElement");
+    return -1;
+  }
+  if(stopTime>lastBlocTime(fftElement, &fftElement->blocs[fftElement->firstBloc+fftElement->dataNumber-1]))
   {
     perror("Error : stopTime higher than the last time of data");
     return -1;
@@ -585,22 +2127,18 @@ int blocNumberCount(FftElement *fftElement, unsigned int startTime,unsigned int
     perror("Error : startTime lower than the first time of data");
     return -1;
   }
-  unsigned int time = fftElement->startTime;
-  FftDataStack *fftDataStack = fftElement->fftDataStack;
-  if(fftDataStack == NULL)
+  /*The blocs are sorted by time : the first bloc after stopTime is found by a binary search too*/
+  FftBloc *blocs = fftElement->blocs + fftElement->firstBloc;
+  unsigned int first = findBloc(fftElement, startTime), low = first, high = fftElement->dataNumber;
+  while (low < high)
   {
-    perror("Error : No data in FftDataStack");
-    return -1;
-  }
-  while(time + fftElement->timeInterval * (fftElement->blocSize-1) < startTime){
-    fftDataStack = fftDataStack->next;
-    time += fftElement->timeInterval * fftElement->blocSize;
-  }
-  while(time<=stopTime){
-    fftDataStack = fftDataStack->next;
-    time += fftElement->timeInterval * fftElement->blocSize;
-    i++;
+    unsigned int middle = low + (high - low)/2;
+    if (blocs[middle].startTime <= stopTime)
+      low = middle + 1;
+    else
+      high = middle;
   }
+  i = low - first;
   return i;
 }
 
@@ -630,7 +2168,7 @@ void printFftStack(FftStack *fftStack)
 
     while (current != NULL)
     {
-        printf("ID:%d\tStartTime:%d\tBlocSize:%d\tsizeCompressedLow:%d\tsizeCompressedHigh:%d\tTimeInterval:%d\tNumber of Element : %d\n", current->id,current->startTime,current->blocSize,current->sizeCompressedL,current->sizeCompressedH,current->timeInterval,current->dataNumber);
+        printf("ID:%d\tStartTime:%d\tBlocSize:%d\tFftSize:%d\tsizeCompressedLow:%d\tsizeCompressedHigh:%d\tTimeInterval:%d\tNumber of Element : %d\n", current->id,current->startTime,current->blocSize,current->fftSize,current->sizeCompressedL,current->sizeCompressedH,current->timeInterval,current->dataNumber);
     //printFftDataStack(current);
         current = current->next;
     }
@@ -647,32 +2185,32 @@ void printFftStack(FftStack *fftStack)
 
 void printFftDataStack(FftElement *fftElement)
 {
-  FftDataStack* current;
     if (fftElement == NULL)
     {
         perror("Error : FftStack must be initialized\n");
     return;
     }
 
-
-  current = fftElement->fftDataStack;
-  if (current == NULL)
-    {
-        return;
-    }
-
-    while (current != NULL)
+    for(unsigned int k = fftElement->firstBloc; k<fftElement->firstBloc+fftElement->dataNumber; k++)
     {
     for(unsigned int i = 0; i<(fftElement ->sizeCompressedL);i++)
     {
-          printf("  %f\tLow\n", current->pointerLow[i]);
+          float value;
+          if (fftElement->fixedPoint)
+            fftFixedToFloat(&fftElement->low[(size_t)k*fftElement->sizeCompressedL+i], 1, fftElement->blocs[k].scale, &value);
+          else
+            value = fftElement->low[(size_t)k*fftElement->sizeCompressedL+i];
+          printf("  %f\tLow\n", value);
     }
     for(unsigned int i = 0; i<(fftElement ->sizeCompressedH);i++)
     {
-          printf("  %f\tHigh\n", current->pointerHigh[i]);
+          float value;
+          if (fftElement->fixedPoint)
+            fftFixedToFloat(&fftElement->high[(size_t)k*fftElement->sizeCompressedH+i], 1, fftElement->blocs[k].scale, &value);
+          else
+            value = fftElement->high[(size_t)k*fftElement->sizeCompressedH+i];
+          printf("  %f\tHigh\n", value);
     }
-
-        current = current->next;
     }
 
     printf("\n");
@@ -11,230 +11,2141 @@
 
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
+#include <stdatomic.h>
+#include <stdint.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
 #include "idStack.h"
 
+/*Identification and version of the snapshot files*/
+#define SNAPSHOT_MAGIC "IDSTACK"
+#define SNAPSHOT_VERSION 3
+/*Alignment of the data arrays in a snapshot file*/
+#define SNAPSHOT_ALIGN 16
+/*Handles of a snapshot file are lower than this limit : a corrupted handle can't make idRestore allocate
+  more than SNAPSHOT_HANDLE_LIMIT slots in IdStack->handles, nor overflow their unsigned int count*/
+#define SNAPSHOT_HANDLE_LIMIT 0x1000000
+
+typedef struct IdTable IdTable;
+typedef struct IdRetired IdRetired;
+typedef struct IdSnapshotHeader IdSnapshotHeader;
+typedef struct IdSnapshotRecord IdSnapshotRecord;
+
+/**
+ * \struct IdSnapshotHeader
+ * \brief Beginning of a snapshot file. It is followed by elementNumber IdSnapshotRecords, then by the data arrays.
+ *
+ */
+struct IdSnapshotHeader
+{
+  char magic[8];   //SNAPSHOT_MAGIC
+  uint32_t version;   //SNAPSHOT_VERSION
+  uint32_t elementNumber;   //number of IdSnapshotRecords
+  uint64_t size;   //size of the file in bytes
+};
+
+/**
+ * \struct IdSnapshotRecord
+ * \brief Header of an IdElement in a snapshot file.
+ *
+ */
+struct IdSnapshotRecord
+{
+  uint32_t id;
+  uint32_t dataType;
+  uint32_t signalType;
+  uint32_t startTime;
+  uint32_t timeInterval;
+  uint32_t dataNumber;
+  uint32_t handle;
+  uint32_t priority;
+  uint32_t irregular;   //1 for an irregular channel
+  uint32_t segmentNumber;   //number of IdSegments of a periodic channel with gaps
+  uint64_t quota;
+  uint64_t offset;   //position of the data array (dataNumber data, from the oldest one) in the file
+  uint64_t timeOffset;   //position of the array of the dataNumber times of an irregular channel (0 for a periodic channel)
+  uint64_t segmentOffset;   //position of the array of the IdSegments (0 without gap)
+  char name[ID_NAME_SIZE];
+};
+
+/**
+ * \struct IdTable
+ * \brief Handle table read by the producer threads. It is replaced by a bigger copy when it is full.
+ *
+ */
+struct IdTable
+{
+  unsigned int size;   //number of slots
+  _Atomic(IdElement*) slots[];   //IdElements indexed by their handle
+};
+
+/**
+ * \struct IdRetired
+ * \brief IdElement or IdTable unpublished by the consumer, freed when no producer can still use it.
+ *
+ */
+struct IdRetired
+{
+  void *pointer;   //IdElement or IdTable
+  int isElement;   //1 if pointer is an IdElement
+  unsigned int epoch;   //epoch during which pointer was unpublished
+  IdRetired *next;
+};
+
+/**
+ * \struct IdConcurrent
+ * \brief State of a concurrent IdStack shared with the producer threads.
+ *
+ * A producer counts itself in readers[epoch%2] while it uses the table. Something unpublished during an epoch e
+ * is freed when the epoch goes from e+1 to e+2 : the readers of the epochs e and e-1 are all gone at that time.
+ */
+struct IdConcurrent
+{
+  _Atomic(IdTable*) table;   //handle table published to the producers
+  atomic_uint epoch;   //current epoch
+  atomic_uint readers[2];   //number of producers in the even and odd epochs
+  unsigned int ringSize;   //size of the RingBuffers of the IdElements
+  IdRetired *retired;   //unpublished IdElements and IdTables
+};
+
+/**
+ * \fn static void freeRetired(IdRetired *retired)
+ * \brief Free an unpublished IdElement (with its data and its RingBuffer) or IdTable.
+ */
+
+static void freeRetired(IdRetired *retired)
+{
+  if (retired->isElement)
+  {
+    IdElement *idElement = (IdElement*) retired->pointer;
+    deinitialize(idElement->dataStack);
+    ringDeinitialize(idElement->ring);
+    timeDeinitialize(idElement->timeStack);
+    free(idElement->segments);
+  }
+  free(retired->pointer);
+  free(retired);
+}
+
+/**
+ * \fn static void retire(IdConcurrent *concurrent, void *pointer, int isElement)
+ * \brief Keep an unpublished IdElement or IdTable until no producer can use it anymore.
+ */
+
+static void retire(IdConcurrent *concurrent, void *pointer, int isElement)
+{
+  IdRetired *retired = (IdRetired*) malloc(sizeof(*retired));
+  if (retired == NULL)
+  {
+    perror("Error : Memory allocation for retired impossible, the memory is lost");
+    return;
+  }
+  retired->pointer = pointer;
+  retired->isElement = isElement;
+  retired->epoch = atomic_load(&concurrent->epoch);
+  retired->next = concurrent->retired;
+  concurrent->retired = retired;
+}
+
+/**
+ * \fn static void reclaim(IdConcurrent *concurrent)
+ * \brief Go to the next epoch if the producers of the previous one are gone, and free what can't be used anymore.
+ *
+ * This function never waits : if producers are still in the previous epoch, nothing is done.
+ */
+
+static void reclaim(IdConcurrent *concurrent)
+{
+  unsigned int epoch = atomic_load(&concurrent->epoch);
+  IdRetired **retired = &concurrent->retired;
+  if (concurrent->retired == NULL || atomic_load(&concurrent->readers[(epoch+1)%2]) != 0)
+    return;
+  atomic_store(&concurrent->epoch, epoch+1);
+  while (*retired != NULL)
+  {
+    if (epoch - (*retired)->epoch >= 1)
+    {
+      IdRetired *oldRetired = *retired;
+      *retired = oldRetired->next;
+      freeRetired(oldRetired);
+    }
+    else
+    {
+      retired = &(*retired)->next;
+    }
+  }
+}
+
+/**
+ * \fn static int publishHandle(IdStack *myIdStack, unsigned int handle, IdElement *idElement)
+ * \brief Write an IdElement (or NULL) in the handle table of the producers. A full table is replaced by a bigger copy.
+ *
+ * \return 0 if it SUCCESSED, -1 if it FAILED.
+ */
+
+static int publishHandle(IdStack *myIdStack, unsigned int handle, IdElement *idElement)
+{
+  IdConcurrent *concurrent = myIdStack->concurrent;
+  IdTable *table = atomic_load(&concurrent->table);
+  if (table == NULL || handle >= table->size)
+  {
+    unsigned int newSize = myIdStack->handleSize;
+    IdTable *newTable = (IdTable*) malloc(sizeof(*newTable) + newSize*sizeof(newTable->slots[0]));
+    if (newTable == NULL)
+    {
+      perror("Error : Memory allocation for the handle table impossible");
+      return -1;
+    }
+    newTable->size = newSize;
+    for (unsigned int i = 0; i < newSize; i++)
+    {
+      IdElement *published = (i < myIdStack->handleNumber) ? myIdStack->handles[i] : NULL;
+      /*The irregular channels can't be produced : they aren't published*/
+      atomic_init(&newTable->slots[i], (published != NULL && published->timeStack == NULL) ? published : NULL);
+    }
+    atomic_store(&concurrent->table, newTable);
+    if (table != NULL)
+      retire(concurrent, table, 0);
+  }
+  else
+  {
+    atomic_store(&table->slots[handle], idElement);
+  }
+  return 0;
+}
+
 /**
  * \fn IdStack* idInitialize()
  * \brief Function used to initialize a idStack instance.
  *
  * This function have to be used before everything else function to initialise an instance where will be stored IdElements
  *
- * \return the initialized idStack instance.
+ * \return the initialized idStack instance.
+ */
+
+IdStack* idInitialize()
+{
+    IdStack *idStack = (IdStack*) malloc(sizeof(*idStack));
+  if (idStack == NULL)
+    {
+        perror("Error : Memory allocation for idStack impossible");
+    return NULL;
+    }
+    idStack->first = NULL;
+    idStack->handles = NULL;
+    idStack->handleNumber = 0;
+    idStack->handleSize = 0;
+    idStack->memoryUsed = 0;
+    idStack->memoryBudget = 0;
+    idStack->evict = NULL;
+    idStack->evictContext = NULL;
+    idStack->concurrent = NULL;
+    idStack->snapshot = NULL;
+    idStack->snapshotSize = 0;
+  return idStack;
+}
+
+/**
+ * \fn void idDeinitialize(IdStack* myIdStack)
+ * \brief Function used to deinitialize a idStack instance.
+ *
+ * This function have to be used after everything else function to deinitialise an IdStack instance.
+ *
+ * \param myIdStack IdStack instance which have to be deinitialized.
+ */
+void idDeinitialize(IdStack* myIdStack)
+{
+  if (myIdStack == NULL)
+    {
+    perror("Error : myIdStack uninitialized");
+        return;
+    }
+  else
+    {
+    while(myIdStack->first != NULL)
+    {
+      firstIdStackPop(myIdStack);
+    }
+  }
+  if (myIdStack->concurrent != NULL)
+  {
+    while (myIdStack->concurrent->retired != NULL)
+    {
+      IdRetired *retired = myIdStack->concurrent->retired;
+      myIdStack->concurrent->retired = retired->next;
+      freeRetired(retired);
+    }
+    free(atomic_load(&myIdStack->concurrent->table));
+    free(myIdStack->concurrent);
+  }
+  if (myIdStack->snapshot != NULL)
+    munmap(myIdStack->snapshot, myIdStack->snapshotSize);
+  free(myIdStack->handles);
+  free(myIdStack);
+}
+
+/**
+ * \fn static size_t allocationSize(size_t size)
+ * \brief Estimate the memory really used by a malloc of size bytes (header and alignment of the allocator).
+ */
+
+static size_t allocationSize(size_t size)
+{
+  size = (size + sizeof(size_t) + 15) & ~(size_t)15;
+  return (size < 32) ? 32 : size;
+}
+
+/**
+ * \fn static size_t dataMemory(IdElement *idElement)
+ * \brief Return the memory used by one data of an IdElement (Element and data buffer, or data and time in a TimeStack).
+ */
+
+static size_t dataMemory(IdElement *idElement)
+{
+  if (idElement->timeStack != NULL)
+    return sizeDataType(idElement->dataType) + 1;
+  return allocationSize(sizeof(Element)) + allocationSize(sizeDataType(idElement->dataType));
+}
+
+/**
+ * \fn size_t idElementMemory(IdElement *idElement)
+ * \brief Return the memory used by an IdElement, its data and its spare Elements.
+ *
+ * The overhead of the allocator is estimated, so this is close to the resident memory.
+ * The data still read in a mapped snapshot are not counted.
+ *
+ * \param idElement IdElement instance we want the memory.
+ * \return memory used in bytes. 0 if the IdElement doesn't exist.
+ */
+
+size_t idElementMemory(IdElement *idElement)
+{
+  if (idElement == NULL)
+    return 0;
+  size_t memory = allocationSize(sizeof(*idElement)) + allocationSize(sizeof(Stack));
+  if (idElement->timeStack != NULL)
+    memory += allocationSize(sizeof(TimeStack)) + idElement->timeStack->memory;
+  else
+    memory += (idElement->dataNumber - idElement->dataStack->baseNumber + idElement->dataStack->spareNumber)*dataMemory(idElement);
+  if (idElement->segmentCapacity != 0)
+    memory += allocationSize(idElement->segmentCapacity*sizeof(IdSegment));
+  if (idElement->ring != NULL)
+    memory += allocationSize(sizeof(RingBuffer)) + allocationSize((size_t)(idElement->ring->mask+1)*idElement->ring->numberSize);
+  return memory;
+}
+
+/**
+ * \fn static void addData(IdElement *idElement, unsigned int number)
+ * \brief Count number data pushed after the newest data of a periodic IdElement.
+ */
+
+static void addData(IdElement *idElement, unsigned int number)
+{
+  idElement->dataNumber += number;
+  if (idElement->segmentNumber != 0)
+    idElement->segments[idElement->segmentNumber-1].dataNumber += number;
+}
+
+/**
+ * \fn static unsigned int countData(IdElement *idElement, unsigned int stopTime)
+ * \brief Return the number of data of a periodic IdElement with a time lower or equal to stopTime.
+ */
+
+static unsigned int countData(IdElement *idElement, unsigned int stopTime)
+{
+  IdSegment segment = {idElement->startTime, idElement->dataNumber};
+  IdSegment *segments = (idElement->segmentNumber != 0) ? idElement->segments : &segment;
+  unsigned int segmentNumber = (idElement->segmentNumber != 0) ? idElement->segmentNumber : 1;
+  unsigned int number = 0, segmentData;
+  for (unsigned int i = 0; i < segmentNumber && stopTime >= segments[i].startTime; i++)
+  {
+    segmentData = segments[i].dataNumber;
+    if (idElement->timeInterval != 0 && (stopTime - segments[i].startTime)/idElement->timeInterval < segmentData)
+      segmentData = (stopTime - segments[i].startTime)/idElement->timeInterval + 1;
+    number += segmentData;
+    if (segmentData < segments[i].dataNumber)
+      break;
+  }
+  return number;
+}
+
+/**
+ * \fn static int addSegment(IdElement *idElement, unsigned int startTime)
+ * \brief Add an empty segment starting at startTime after the newest one.
+ *
+ * \return 0 if it SUCCESSED, -1 if it FAILED.
+ */
+
+static int addSegment(IdElement *idElement, unsigned int startTime)
+{
+  if (idElement->segmentNumber == idElement->segmentCapacity)
+  {
+    unsigned int newCapacity = (idElement->segmentCapacity == 0) ? 4 : 2*idElement->segmentCapacity;
+    IdSegment *segments = (IdSegment*) realloc(idElement->segments, newCapacity*sizeof(*segments));
+    if (segments == NULL)
+    {
+      perror("Error : Memory allocation for segments impossible");
+      return -1;
+    }
+    idElement->segments = segments;
+    idElement->segmentCapacity = newCapacity;
+  }
+  idElement->segments[idElement->segmentNumber].startTime = startTime;
+  idElement->segments[idElement->segmentNumber].dataNumber = 0;
+  idElement->segmentNumber++;
+  return 0;
+}
+
+/**
+ * \fn static void dropSegments(IdElement *idElement, unsigned int number)
+ * \brief Remove the number oldest data from the segments of an IdElement and update its startTime.
+ *
+ * The newest segment is kept even when it is empty, it gives the time of the next data. When only one segment is
+ * left, the IdElement goes back to the case without gap.
+ */
+
+static void dropSegments(IdElement *idElement, unsigned int number)
+{
+  IdSegment *segments = idElement->segments;
+  unsigned int first = 0;
+  while (number > 0)
+  {
+    if (number < segments[first].dataNumber || first == idElement->segmentNumber-1)
+    {
+      segments[first].startTime += number*idElement->timeInterval;
+      segments[first].dataNumber -= number;
+      break;
+    }
+    number -= segments[first].dataNumber;
+    first++;
+  }
+  idElement->segmentNumber -= first;
+  memmove(segments, segments + first, idElement->segmentNumber*sizeof(*segments));
+  idElement->startTime = segments[0].startTime;
+  if (idElement->segmentNumber == 1)
+  {
+    free(idElement->segments);
+    idElement->segments = NULL;
+    idElement->segmentNumber = 0;
+    idElement->segmentCapacity = 0;
+  }
+}
+
+/**
+ * \fn static unsigned int drainIdElement(IdStack *myIdStack, IdElement *idElement)
+ * \brief Move the data produced in the RingBuffer of an IdElement into its dataStack.
+ *
+ * \return number of moved data.
+ */
+
+static unsigned int drainIdElement(IdStack *myIdStack, IdElement *idElement)
+{
+  unsigned int number;
+  if (idElement->ring == NULL || idElement->timeStack != NULL)
+    return 0;
+  number = ringAvailable(idElement->ring);
+  if (number == 0)
+    return 0;
+  size_t memory = idElementMemory(idElement);
+  for (unsigned int i = 0; i < number; i++)
+  {
+    stackPush(idElement->dataStack, ringPeek(idElement->ring, i), idElement->ring->numberSize);
+  }
+  ringRelease(idElement->ring, number);
+  addData(idElement, number);
+  myIdStack->memoryUsed += idElementMemory(idElement) - memory;
+  return number;
+}
+
+/**
+ * \fn static void* dataIdElementPop(IdStack *myIdStack, IdElement *idElement, unsigned int stopTime)
+ * \brief Pop an array of data between the startTime of an IdElement already found and stopTime (included).
+ *
+ * \param myIdStack IdStack instance owning the IdElement.
+ * \param idElement IdElement from which data is popped.
+ * \param stopTime unsigned int corresponding to the wanted stoping time of data.
+ * \return pointer to the first element of the data array. NULL if none data corresponds.
+ */
+
+static void* dataIdElementPop(IdStack *myIdStack, IdElement *idElement, unsigned int stopTime)
+{
+  unsigned int finalTime = 0;
+  int dataNumber=0;
+  void *array = NULL;
+  if (idElement != NULL && idElement->timeStack != NULL)
+  {
+    perror("Error : The data of an irregular channel are popped with dataHandlePopTime");
+    return NULL;
+  }
+  if (idElement != NULL)
+    drainIdElement(myIdStack, idElement);
+  if (idElement != NULL && idElement->segmentNumber != 0)
+  {
+    /*With gaps, the times are converted into a number of data and the Stack is popped by index*/
+    size_t memory = idElementMemory(idElement);
+    dataNumber = countData(idElement, stopTime);
+    if (dataNumber > 0)
+    {
+      array = stackPop(idElement->dataStack, sizeDataType(idElement->dataType), 1, idElement->dataNumber-1, dataNumber-1, dataNumber);
+      if (array == NULL)
+        return NULL;
+      idElement->dataNumber -= dataNumber;
+      dropSegments(idElement, dataNumber);
+      myIdStack->memoryUsed -= memory - idElementMemory(idElement);
+    }
+    return array;
+  }
+  if (idElement != NULL)
+  {
+    size_t memory = idElementMemory(idElement);
+    unsigned int startTime = idElement->startTime;
+    if (startTime != idElement->startTime && stopTime != idElement->startTime+idElement->timeInterval*idElement->dataNumber){
+      perror("startTime and stopTime can't be different from the extremals values at the same time");
+      return NULL;
+    }
+    finalTime = (idElement->startTime) + (idElement->dataNumber-1)*(idElement->timeInterval);
+    dataNumber = stackNumberCount(idElement->dataStack, idElement->timeInterval, finalTime,startTime,stopTime);
+    if (dataNumber > 0)
+    {
+      array = stackPop(idElement->dataStack, sizeDataType(idElement->dataType),idElement->timeInterval, finalTime, stopTime,dataNumber);
+      if (array == NULL)
+        return NULL;
+      idElement->dataNumber -= dataNumber;
+      if(startTime == idElement->startTime)
+        idElement->startTime = stopTime + idElement->timeInterval;
+      myIdStack->memoryUsed -= memory - idElementMemory(idElement);
+    }
+  }
+  return array;
+}
+
+/**
+ * \fn static unsigned int evictNumber(IdElement *idElement, size_t excess)
+ * \brief Return the number of data to evict from an IdElement to free excess bytes, once its spare Elements are freed.
+ */
+
+static unsigned int evictNumber(IdElement *idElement, size_t excess)
+{
+  size_t dataSize = dataMemory(idElement);
+  size_t spareMemory = idElement->dataStack->spareNumber * dataSize;
+  if (excess <= spareMemory)
+    return 0;
+  /*The data of the base (restored snapshot) are the oldest ones but free no memory : they are evicted with the Elements*/
+  return idElement->dataStack->baseNumber + (unsigned int)((excess - spareMemory + dataSize - 1)/dataSize);
+}
+
+/**
+ * \fn static int evictIdElement(IdStack *myIdStack, IdElement *idElement, unsigned int number)
+ * \brief Free the spare Elements of an IdElement and evict its number oldest data.
+ *
+ * The data are dropped if the Evict_function fails or removes no data, whatever it returns.
+ *
+ * \param myIdStack IdStack instance owning the IdElement.
+ * \param idElement IdElement from which data is evicted.
+ * \param number Number of data to evict (all the data if it is higher than idElement->dataNumber).
+ * \return number of evicted data.
+ */
+
+static int evictIdElement(IdStack *myIdStack, IdElement *idElement, unsigned int number)
+{
+  int evicted = 0;
+  unsigned int dataNumber = idElement->dataNumber;
+  size_t memory;
+  if (number > idElement->dataNumber)
+    number = idElement->dataNumber;
+  if (number > 0 && myIdStack->evict != NULL && myIdStack->evict(myIdStack, idElement, number, myIdStack->evictContext) > 0)
+    evicted = (int)(dataNumber - idElement->dataNumber);
+  memory = idElementMemory(idElement);
+  if (evicted < 1 && number > 0 && idElement->timeStack != NULL)
+  {
+    timeStackDrop(idElement->timeStack, number);
+    idElement->dataNumber -= number;
+    idElement->startTime = timeStackStartTime(idElement->timeStack);
+    evicted = number;
+  }
+  else if (evicted < 1 && number > 0)
+  {
+    stackDrop(idElement->dataStack, idElement->dataNumber - number);
+    idElement->dataNumber -= number;
+    if (idElement->segmentNumber != 0)
+      dropSegments(idElement, number);
+    else
+      idElement->startTime += number*idElement->timeInterval;
+    evicted = number;
+  }
+  stackTrim(idElement->dataStack);
+  myIdStack->memoryUsed -= memory - idElementMemory(idElement);
+  return evicted;
+}
+
+/**
+ * \fn static void checkMemory(IdStack *myIdStack, IdElement *idElement)
+ * \brief Evict data if idElement goes over its quota or myIdStack over its budget.
+ */
+
+static void checkMemory(IdStack *myIdStack, IdElement *idElement)
+{
+  if (idElement->quota != 0 && idElementMemory(idElement) > idElement->quota)
+  {
+    evictIdElement(myIdStack, idElement, evictNumber(idElement, idElementMemory(idElement) - (idElement->quota - idElement->quota/8)));
+  }
+  if (myIdStack->memoryBudget != 0 && myIdStack->memoryUsed > myIdStack->memoryBudget)
+  {
+    idStackEvict(myIdStack);
+  }
+}
+
+/**
+ * \fn static int notifyPush(IdStack *myIdStack, IdElement *idElement)
+ * \brief Call the Push_function of idElement if it holds pushThreshold data.
+ *
+ * The Push_function is detached during the call, so the pushes and drains it makes don't call it again. When it
+ * FAILED, it stays detached : it isn't called again by each push, and the data stay in the IdElement.
+ *
+ * \return 0 if the Push_function wasn't called or SUCCESSED, -1 if it FAILED.
+ */
+
+static int notifyPush(IdStack *myIdStack, IdElement *idElement)
+{
+  Push_function push = idElement->push;
+  if (push == NULL || idElement->dataNumber < idElement->pushThreshold)
+    return 0;
+  idElement->push = NULL;
+  if (push(myIdStack, idElement, idElement->pushContext) < 0)
+  {
+    perror("Error : The Push_function failed, it is detached from the IdElement");
+    idElement->pushContext = NULL;
+    idElement->pushThreshold = 0;
+    return -1;
+  }
+  idElement->push = push;
+  return 0;
+}
+
+/**
+ * \fn static IdElement* dataIdElementPush(IdStack *myIdStack, IdElement *idElement, void *newAdress)
+ * \brief Push a new data into an IdElement already found.
+ *
+ * \param myIdStack IdStack instance owning the IdElement.
+ * \param idElement IdElement in which the new data is pushed.
+ * \param newAdress Pointer on the data we want to push into the IdElement.
+ * \return pointer to the idElement in which was pushed the new data. NULL if the IdElement doesn't exist.
+ */
+
+static IdElement* dataIdElementPush(IdStack *myIdStack, IdElement *idElement, void *newAdress)
+{
+  if (idElement == NULL)
+  {
+    perror("Error : The Element corresponding to the ID is inexistant");
+    return NULL;
+  }
+  if (idElement->timeStack != NULL)
+  {
+    perror("Error : The data of an irregular channel are pushed with dataHandlePushTime");
+    return NULL;
+  }
+  size_t memory = idElementMemory(idElement);
+  stackPush(idElement->dataStack, newAdress, sizeDataType(idElement->dataType));
+  addData(idElement, 1);
+  myIdStack->memoryUsed += idElementMemory(idElement) - memory;
+  notifyPush(myIdStack, idElement);
+  checkMemory(myIdStack, idElement);
+  return idElement;
+}
+
+/**
+ * \fn int idElementSetPush(IdStack *myIdStack, IdElement *idElement, unsigned int pushThreshold, Push_function push, void *pushContext)
+ * \brief Call push each time a push or idStackDrain leaves at least pushThreshold data in an IdElement.
+ *
+ * Data already stored over the threshold are given to push now. A push returning -1 is detached (see notifyPush).
+ *
+ * \param myIdStack IdStack instance owning the IdElement.
+ * \param idElement IdElement to watch.
+ * \param pushThreshold Number of data from which push is called (at least 1).
+ * \param push Function consuming the data (NULL : the data stay in the IdElement until they are popped).
+ * \param pushContext Last parameter given to push.
+ * \return 0 if it SUCCESSED, -1 if it FAILED (push is then detached if it failed on the data already stored).
+ */
+
+int idElementSetPush(IdStack *myIdStack, IdElement *idElement, unsigned int pushThreshold, Push_function push, void *pushContext)
+{
+  if (myIdStack == NULL || idElement == NULL)
+  {
+    perror("Error : myIdStack and idElement should be initialized");
+    return -1;
+  }
+  if (push != NULL && pushThreshold == 0)
+  {
+    perror("Error : pushThreshold should be higher than 0");
+    return -1;
+  }
+  idElement->push = push;
+  idElement->pushContext = pushContext;
+  idElement->pushThreshold = pushThreshold;
+  return notifyPush(myIdStack, idElement);
+}
+
+/**
+ * \fn void idStackSetBudget(IdStack *myIdStack, size_t memoryBudget, Evict_function evict, void *evictContext)
+ * \brief Bound the memory used by an IdStack.
+ *
+ * When a push goes over the budget, idStackEvict is called. Data already stored over the budget is evicted now.
+ *
+ * \param myIdStack IdStack instance to bound.
+ * \param memoryBudget Maximum memory of the IdStack in bytes (0 : no budget).
+ * \param evict Function used to evict the oldest data of a channel (NULL : the oldest data are dropped).
+ * \param evictContext Last parameter given to evict.
+ */
+
+void idStackSetBudget(IdStack *myIdStack, size_t memoryBudget, Evict_function evict, void *evictContext)
+{
+  if (myIdStack == NULL)
+    {
+        perror("Error : myIdStack uninitialized");
+    return;
+    }
+  myIdStack->memoryBudget = memoryBudget;
+  myIdStack->evict = evict;
+  myIdStack->evictContext = evictContext;
+  if (memoryBudget != 0 && myIdStack->memoryUsed > memoryBudget)
+    idStackEvict(myIdStack);
+}
+
+/**
+ * \fn int idStackEvict(IdStack *myIdStack)
+ * \brief Evict data until the IdStack uses less than 7/8 of its budget.
+ *
+ * The spare Elements then the oldest data of the channel with the lowest priority are evicted first
+ * (the channel using the most memory if several ones have the same priority).
+ *
+ * \param myIdStack IdStack instance with a budget.
+ * \return number of evicted data. -1 if it FAILED.
+ */
+
+int idStackEvict(IdStack *myIdStack)
+{
+  IdElement *idElement, *victim;
+  int evicted = 0;
+  if (myIdStack == NULL)
+    {
+        perror("Error : myIdStack uninitialized");
+    return -1;
+    }
+  size_t target = myIdStack->memoryBudget - myIdStack->memoryBudget/8;
+  while (myIdStack->memoryUsed > target)
+  {
+    victim = NULL;
+    for (idElement = myIdStack->first; idElement != NULL; idElement = idElement->next)
+    {
+      if (idElement->dataNumber - idElement->dataStack->baseNumber + idElement->dataStack->spareNumber == 0)
+        continue;
+      if (victim == NULL || idElement->priority < victim->priority || (idElement->priority == victim->priority && idElementMemory(idElement) > idElementMemory(victim)))
+        victim = idElement;
+    }
+    if (victim == NULL)
+    {
+      perror("Error : The budget is lower than the memory of the empty IdElements");
+      break;
+    }
+    evicted += evictIdElement(myIdStack, victim, evictNumber(victim, myIdStack->memoryUsed - target));
+  }
+  return evicted;
+}
+
+/**
+ * \fn IdElement* dataIdStackPush(IdStack* myIdStack, Id_type id, void *newAdress)
+ * \brief Push a new data into the idElement corresponding to the id.
+ *
+ * \param myIdStack IdStack instance in which we want to search the IdElement where to put the new data.
+ * \param id Type of the ID we are looking for (defined in the Id_type enum).
+ * \param newAdress Pointer on the data we want to push into the IdElement.
+ * \return pointer to the idElement in which was pushed the new data.
+ */
+
+IdElement* dataIdStackPush(IdStack* myIdStack, Id_type id, void *newAdress)
+{
+  if (myIdStack == NULL)
+    {
+        perror("Error : myIdStack uninitialized");
+    return NULL;
+    }
+  return dataIdElementPush(myIdStack, searchIdElement(myIdStack,id), newAdress);
+}
+
+/**
+ * \fn void* dataIdStackPop(IdStack* myIdStack, Id_type id,unsigned int startTime,unsigned int stopTime)
+ * \brief Push an array of data between the startTime of data and StopTime (included) corresponding to the id.
+ *
+ * \param myIdStack IdStack instance in which we want to search the IdElement to pop data from.
+ * \param id Type of the ID we are looking for (defined in the Id_type enum).
+
+ * \param stopTime unsigned int corresponding to the wanted stoping time of data (Must be higher than the startTime of data and lower than the biggest time value)
+ * \return pointer to the first element of the data array. NULL if the id doesn't exist or the stopTime is lower than startTime or higher than the highest time value.
+ */
+
+void* dataIdStackPop(IdStack* myIdStack, Id_type id,unsigned int stopTime)
+{
+  if (myIdStack == NULL)
+    {
+        perror("Error : myIdStack uninitialized");
+    return NULL;
+    }
+  return dataIdElementPop(myIdStack, searchIdElement(myIdStack,id), stopTime);
+}
+
+/**
+ * \fn IdElement* searchIdElement(IdStack *myIdStack, Id_type id)
+ * \brief Search the pointer to the IdElement corresponding to the ID.
+ *
+ * \param myIdStack IdStack instance in which we want to search the IdElement.
+ * \param id Type of the ID we are looking for (defined in the Id_type enum).
+ * \return pointer to the idElement corresponding to the id. NULL if it doesn't exist.
+ */
+
+
+IdElement* searchIdElement(IdStack *myIdStack, Id_type id)
+{
+  IdElement *idElement = NULL;
+  if (myIdStack == NULL)
+    {
+        perror("Error : myIdStack uninitialized");
+    return NULL;
+    }
+  idElement = myIdStack->first;
+  if (myIdStack != NULL && myIdStack->first != NULL)
+    {
+    while(idElement != NULL && idElement->id != id)
+    {
+      idElement = idElement ->next;
+    }
+    return idElement;
+    }
+  return NULL;
+}
+
+/**
+ * \fn int getStartTime(IdStack *myIdStack)
+ * \brief Return the start time of the first IdElement of the IdStack.
+ *
+ * \param myIdStack IdStack instance which we want the first IdElement start time.
+ * \return int value of the first IdElement start time. -1 if the instance doesn't exist.
+ */
+
+int getStartTime(IdStack *myIdStack)
+{
+  if (myIdStack != NULL)
+    if (myIdStack != NULL)
+      return (myIdStack->first->startTime);
+  return -1;
+}
+
+/**
+ * \fn int getTimeInterval(IdStack *myIdStack)
+ * \brief Return the time of the first IdElement of the IdStack.
+ *
+ * \param myIdStack IdStack instance which we want the first IdElement time interval.
+ * \return int value of the first IdElement time interval. -1 if the instance doesn't exist.
+ */
+
+int getTimeInterval(IdStack *myIdStack)
+{
+  if (myIdStack != NULL)
+    if (myIdStack->first != NULL)
+      return (myIdStack->first->timeInterval);
+  return -1;
+}
+
+
+/**
+ * \fn static int attachHandle(IdStack *myIdStack, IdElement *idElement)
+ * \brief Give the first free handle of the IdStack to an IdElement.
+ *
+ * The handles array grows by doubling, so handles stay small integers even with thousands of channels.
+ *
+ * \param myIdStack IdStack instance owning the handles.
+ * \param idElement IdElement which receives the handle.
+ * \return 0 if it SUCCESSED, -1 if it FAILED.
+ */
+
+static int attachHandle(IdStack *myIdStack, IdElement *idElement)
+{
+  unsigned int handle = 0;
+  while (handle < myIdStack->handleNumber && myIdStack->handles[handle] != NULL)
+  {
+    handle++;
+  }
+  if (handle == myIdStack->handleSize)
+  {
+    unsigned int newSize = (myIdStack->handleSize == 0) ? 8 : 2*myIdStack->handleSize;
+    IdElement **newHandles = (IdElement**) realloc(myIdStack->handles, newSize*sizeof(*newHandles));
+    if (newHandles == NULL)
+    {
+      perror("Error : Memory allocation for handles impossible");
+      return -1;
+    }
+    myIdStack->handles = newHandles;
+    myIdStack->handleSize = newSize;
+  }
+  if (handle == myIdStack->handleNumber)
+  {
+    myIdStack->handleNumber++;
+  }
+  myIdStack->handles[handle] = idElement;
+  idElement->handle = handle;
+  if (myIdStack->concurrent != NULL && publishHandle(myIdStack, handle, idElement) != 0)
+  {
+    myIdStack->handles[handle] = NULL;
+    return -1;
+  }
+  return 0;
+}
+
+/**
+ * \fn static IdElement* newIdElement(IdStack *myIdStack, Id_type newId, const char *newName, Signal_type newSignalType, Data_type newDataType,unsigned int newStartTime, unsigned int newTimeInterval)
+ * \brief Allocate, configure and add a new IdElement with its handle on top of the IdStack.
+ *
+ * \return pointer on the new IdElement. NULL if it FAILED.
+ */
+
+static IdElement* newIdElement(IdStack *myIdStack, Id_type newId, const char *newName, Signal_type newSignalType, Data_type newDataType,unsigned int newStartTime, unsigned int newTimeInterval)
+{
+  if (myIdStack == NULL)
+    {
+        perror("Error : myIdStack uninitialized");
+    return NULL;
+    }
+  if (sizeDataType(newDataType) <= 0)
+  {
+        perror("Error : SizeDataType should be high than 0");
+    return NULL;
+    }
+    IdElement *idElement = (IdElement*) malloc(sizeof(*idElement));
+  if (idElement == NULL)
+    {
+        perror("Error : Memory allocation for idElement impossible");
+    return NULL;
+    }
+  idElement->dataNumber=0;
+    idElement->id = newId;
+  idElement->signalType = newSignalType;
+    idElement->dataType = newDataType;
+    idElement->startTime = newStartTime;
+    idElement->timeInterval = newTimeInterval;
+  strncpy(idElement->name, newName, ID_NAME_SIZE-1);
+  idElement->name[ID_NAME_SIZE-1] = '\0';
+  idElement->priority = 0;
+  idElement->quota = 0;
+  idElement->ring = NULL;
+  idElement->timeStack = NULL;
+  idElement->segments = NULL;
+  idElement->segmentNumber = 0;
+  idElement->segmentCapacity = 0;
+  idElement->push = NULL;
+  idElement->pushContext = NULL;
+  idElement->pushThreshold = 0;
+  idElement->dataStack = initialize();
+  if (idElement->dataStack != NULL && myIdStack->concurrent != NULL)
+  {
+    idElement->ring = ringInitialize(myIdStack->concurrent->ringSize, sizeDataType(newDataType));
+  }
+  if (idElement->dataStack == NULL || (myIdStack->concurrent != NULL && idElement->ring == NULL) || attachHandle(myIdStack, idElement) != 0)
+  {
+    ringDeinitialize(idElement->ring);
+    free(idElement->dataStack);
+    free(idElement);
+    return NULL;
+  }
+  myIdStack->memoryUsed += idElementMemory(idElement);
+    idElement->next = myIdStack->first;
+    myIdStack->first = idElement;
+  return idElement;
+}
+
+/**
+ * \fn static void freeIdElement(IdStack *myIdStack, IdElement *idElement)
+ * \brief Release the handle, the data and the memory of an IdElement already unlinked from the IdStack.
+ *
+ * In concurrent mode, the IdElement is only unpublished : it is freed later by idStackDrain.
+ */
+
+static void freeIdElement(IdStack *myIdStack, IdElement *idElement)
+{
+  myIdStack->handles[idElement->handle] = NULL;
+  myIdStack->memoryUsed -= idElementMemory(idElement);
+  if (myIdStack->concurrent != NULL)
+  {
+    publishHandle(myIdStack, idElement->handle, NULL);
+    retire(myIdStack->concurrent, idElement, 1);
+    return;
+  }
+  deinitialize(idElement->dataStack);
+  timeDeinitialize(idElement->timeStack);
+  free(idElement->segments);
+  free(idElement);
+}
+
+/**
+ * \fn IdElement* idStackPush(IdStack *myIdStack, Id_type newId,Signal_type newSignalType, Data_type newDataType,unsigned int newStartTime, unsigned int newTimeInterval)
+ * \brief Function used to add and configure a new IdElement
+ *
+ * This function have to be used after idInitialize().
+ *
+ * \param myIdStack IdStack instance in which an IdElement will be added.
+ * \param newId Type of the new ID (defined in the enum Id_type).
+ * \param newSignalType Type of the new ID Signal (defined in the enum Signal_type).
+ * \param newDataType Type of the data (defined in the enum Data_type).
+ * \param newStartTime Start time of the data.
+ * \param newTimeInterval Time interval between each data value.
+ * \return pointer on the new IdElement.
+ */
+
+IdElement* idStackPush(IdStack *myIdStack, Id_type newId,Signal_type newSignalType, Data_type newDataType,unsigned int newStartTime, unsigned int newTimeInterval)
+{
+  return newIdElement(myIdStack, newId, "", newSignalType, newDataType, newStartTime, newTimeInterval);
+}
+
+/**
+ * \fn IdElement* idStackRegister(IdStack *myIdStack, const char *name, Signal_type newSignalType, Data_type newDataType,unsigned int newStartTime, unsigned int newTimeInterval)
+ * \brief Function used to add a new IdElement which isn't part of the Id_type enum.
+ *
+ * The IdElement gets the REGISTERED id and is reached through the handle stored in IdElement->handle
+ * (or searchIdHandle(myIdStack, name) once, outside of the hot path).
+ *
+ * \param myIdStack IdStack instance in which an IdElement will be added.
+ * \param name Name of the channel (unique in the IdStack, shorter than ID_NAME_SIZE).
+ * \param newSignalType Type of the new ID Signal (defined in the enum Signal_type).
+ * \param newDataType Type of the data (defined in the enum Data_type).
+ * \param newStartTime Start time of the data.
+ * \param newTimeInterval Time interval between each data value.
+ * \return pointer on the new IdElement. NULL if the name is invalid or already registered.
+ */
+
+IdElement* idStackRegister(IdStack *myIdStack, const char *name, Signal_type newSignalType, Data_type newDataType,unsigned int newStartTime, unsigned int newTimeInterval)
+{
+  if (name == NULL || name[0] == '\0' || strlen(name) >= ID_NAME_SIZE)
+  {
+    perror("Error : The name should be non empty and shorter than ID_NAME_SIZE");
+    return NULL;
+  }
+  if (searchIdHandle(myIdStack, name) != -1)
+  {
+    perror("Error : This name is already registered");
+    return NULL;
+  }
+  return newIdElement(myIdStack, REGISTERED, name, newSignalType, newDataType, newStartTime, newTimeInterval);
+}
+
+/**
+ * \fn int searchIdHandle(IdStack *myIdStack, const char *name)
+ * \brief Search the handle of the IdElement registered with this name.
+ *
+ * This function compares names : call it once and keep the handle for the hot path.
+ *
+ * \param myIdStack IdStack instance in which we want to search the IdElement.
+ * \param name Name given to idStackRegister.
+ * \return handle of the IdElement. -1 if it doesn't exist.
+ */
+
+int searchIdHandle(IdStack *myIdStack, const char *name)
+{
+  IdElement *idElement;
+  if (myIdStack == NULL)
+    {
+        perror("Error : myIdStack uninitialized");
+    return -1;
+    }
+  if (name == NULL || name[0] == '\0')
+  {
+    return -1;
+  }
+  idElement = myIdStack->first;
+  while (idElement != NULL && strncmp(idElement->name, name, ID_NAME_SIZE) != 0)
+  {
+    idElement = idElement->next;
+  }
+  if (idElement == NULL)
+    return -1;
+  return (int)idElement->handle;
+}
+
+/**
+ * \fn IdElement* handleIdElement(IdStack *myIdStack, unsigned int handle)
+ * \brief Return the IdElement corresponding to the handle, without any search.
+ *
+ * \param myIdStack IdStack instance owning the handle.
+ * \param handle Handle of the IdElement (IdElement->handle).
+ * \return pointer to the idElement corresponding to the handle. NULL if it doesn't exist.
+ */
+
+IdElement* handleIdElement(IdStack *myIdStack, unsigned int handle)
+{
+  if (myIdStack == NULL)
+    {
+        perror("Error : myIdStack uninitialized");
+    return NULL;
+    }
+  if (handle >= myIdStack->handleNumber)
+    return NULL;
+  return myIdStack->handles[handle];
+}
+
+/**
+ * \fn IdElement* dataHandlePush(IdStack* myIdStack, unsigned int handle, void *newAdress)
+ * \brief Push a new data into the idElement corresponding to the handle.
+ *
+ * \param myIdStack IdStack instance owning the handle.
+ * \param handle Handle of the IdElement (IdElement->handle).
+ * \param newAdress Pointer on the data we want to push into the IdElement.
+ * \return pointer to the idElement in which was pushed the new data. NULL if the handle doesn't exist.
+ */
+
+IdElement* dataHandlePush(IdStack* myIdStack, unsigned int handle, void *newAdress)
+{
+  return dataIdElementPush(myIdStack, handleIdElement(myIdStack, handle), newAdress);
+}
+
+/**
+ * \fn void* dataHandlePop(IdStack* myIdStack, unsigned int handle, unsigned int stopTime)
+ * \brief Pop an array of data between the startTime of data and stopTime (included) corresponding to the handle.
+ *
+ * \param myIdStack IdStack instance owning the handle.
+ * \param handle Handle of the IdElement (IdElement->handle).
+ * \param stopTime unsigned int corresponding to the wanted stoping time of data.
+ * \return pointer to the first element of the data array. NULL if the handle doesn't exist or if the stopTime is invalid.
+ */
+
+void* dataHandlePop(IdStack* myIdStack, unsigned int handle, unsigned int stopTime)
+{
+  return dataIdElementPop(myIdStack, handleIdElement(myIdStack, handle), stopTime);
+}
+
+/**
+ * \fn int handleIdStackPop(IdStack *myIdStack, unsigned int handle)
+ * \brief Function used to Pop the IdElement corresponding to a handle. The handle can be given again to a new IdElement.
+ *
+ * \param myIdStack IdStack instance we want to Pop a specific IdElement.
+ * \param handle Handle of the IdElement (IdElement->handle).
+ * \return 0 if it SUCCESSED, -1 if it FAILED.
+ */
+
+int handleIdStackPop(IdStack *myIdStack, unsigned int handle)
+{
+  IdElement *idElement = handleIdElement(myIdStack, handle);
+  IdElement *stackElement;
+  if (idElement == NULL)
+    return -1;
+  if (myIdStack->first == idElement)
+  {
+    myIdStack->first = idElement->next;
+  }
+  else
+  {
+    stackElement = myIdStack->first;
+    while (stackElement->next != idElement)
+    {
+      stackElement = stackElement->next;
+    }
+    stackElement->next = idElement->next;
+  }
+  freeIdElement(myIdStack, idElement);
+  return 0;
+}
+
+/**
+ * \fn static IdElement* skipIdElement(IdStack *myIdStack, IdElement *idElement, unsigned int missedNumber)
+ * \brief Leave a gap of missedNumber data after the newest data of a periodic IdElement already found.
+ *
+ * \return pointer to the idElement. NULL if it FAILED.
+ */
+
+static IdElement* skipIdElement(IdStack *myIdStack, IdElement *idElement, unsigned int missedNumber)
+{
+  if (idElement == NULL || idElement->timeStack != NULL)
+  {
+    perror("Error : The Element corresponding to the ID is inexistant or irregular");
+    return NULL;
+  }
+  drainIdElement(myIdStack, idElement);
+  unsigned int gap = missedNumber*idElement->timeInterval;
+  if (gap == 0)
+    return idElement;
+  /*Without data after the last gap, the gap is only moved forward*/
+  if (idElement->segmentNumber == 0 && idElement->dataNumber == 0)
+  {
+    idElement->startTime += gap;
+    return idElement;
+  }
+  if (idElement->segmentNumber != 0 && idElement->segments[idElement->segmentNumber-1].dataNumber == 0)
+  {
+    idElement->segments[idElement->segmentNumber-1].startTime += gap;
+    return idElement;
+  }
+  size_t memory = idElementMemory(idElement);
+  if (idElement->segmentNumber == 0 && addSegment(idElement, idElement->startTime) != 0)
+    return NULL;
+  IdSegment *last = &idElement->segments[idElement->segmentNumber-1];
+  last->dataNumber = (idElement->segmentNumber == 1) ? idElement->dataNumber : last->dataNumber;
+  if (addSegment(idElement, last->startTime + last->dataNumber*idElement->timeInterval + gap) != 0)
+  {
+    if (idElement->segmentNumber == 1)
+      dropSegments(idElement, 0);
+    return NULL;
+  }
+  myIdStack->memoryUsed += idElementMemory(idElement) - memory;
+  return idElement;
+}
+
+/**
+ * \fn IdElement* dataIdStackSkip(IdStack *myIdStack, Id_type id, unsigned int missedNumber)
+ * \brief Declare that the sensor of the idElement corresponding to the id missed missedNumber data.
+ *
+ * The next data pushed gets the time it would have had if the missed data were pushed, but nothing is stored for
+ * them : the IdElement is split into IdSegments (see idElementSegments).
+ *
+ * \param myIdStack IdStack instance in which we want to search the IdElement.
+ * \param id Type of the ID we are looking for (defined in the Id_type enum).
+ * \param missedNumber Number of missed data.
+ * \return pointer to the idElement. NULL if it FAILED.
+ */
+
+IdElement* dataIdStackSkip(IdStack *myIdStack, Id_type id, unsigned int missedNumber)
+{
+  if (myIdStack == NULL)
+    {
+        perror("Error : myIdStack uninitialized");
+    return NULL;
+    }
+  return skipIdElement(myIdStack, searchIdElement(myIdStack, id), missedNumber);
+}
+
+/**
+ * \fn IdElement* dataHandleSkip(IdStack *myIdStack, unsigned int handle, unsigned int missedNumber)
+ * \brief Declare that the sensor of the idElement corresponding to the handle missed missedNumber data.
+ *
+ * \param myIdStack IdStack instance owning the handle.
+ * \param handle Handle of the IdElement (IdElement->handle).
+ * \param missedNumber Number of missed data.
+ * \return pointer to the idElement. NULL if it FAILED.
+ */
+
+IdElement* dataHandleSkip(IdStack *myIdStack, unsigned int handle, unsigned int missedNumber)
+{
+  return skipIdElement(myIdStack, handleIdElement(myIdStack, handle), missedNumber);
+}
+
+/**
+ * \fn unsigned int idElementSegments(IdElement *idElement, unsigned int startTime, unsigned int stopTime, IdSegment *segments, unsigned int maxNumber)
+ * \brief Give the segments of the data of a periodic IdElement between startTime and stopTime (included).
+ *
+ * The popped arrays hold the data of these segments one after the other. Only the segments are read, the cost
+ * doesn't depend on the number of data.
+ *
+ * \param idElement Periodic IdElement.
+ * \param startTime Time from which the segments are wanted.
+ * \param stopTime Time until which the segments are wanted.
+ * \param segments Array receiving at most maxNumber segments, cut to the times asked. It can be NULL.
+ * \param maxNumber Size of segments.
+ * \return the number of segments between startTime and stopTime, it can be greater than maxNumber.
+ */
+
+unsigned int idElementSegments(IdElement *idElement, unsigned int startTime, unsigned int stopTime, IdSegment *segments, unsigned int maxNumber)
+{
+  if (idElement == NULL || idElement->timeStack != NULL)
+    return 0;
+  IdSegment whole = {idElement->startTime, idElement->dataNumber};
+  IdSegment *elementSegments = (idElement->segmentNumber != 0) ? idElement->segments : &whole;
+  unsigned int elementNumber = (idElement->segmentNumber != 0) ? idElement->segmentNumber : 1;
+  unsigned int interval = idElement->timeInterval, number = 0, first, last;
+  for (unsigned int i = 0; i < elementNumber; i++)
+  {
+    IdSegment *segment = &elementSegments[i];
+    if (segment->dataNumber == 0 || stopTime < segment->startTime)
+      continue;
+    if (startTime <= segment->startTime)
+      first = 0;
+    else
+      first = (interval == 0) ? segment->dataNumber : (startTime - segment->startTime + interval - 1)/interval;
+    last = segment->dataNumber - 1;
+    if (interval != 0 && (stopTime - segment->startTime)/interval < last)
+      last = (stopTime - segment->startTime)/interval;
+    if (first > last)
+      continue;
+    if (segments != NULL && number < maxNumber)
+    {
+      segments[number].startTime = segment->startTime + first*interval;
+      segments[number].dataNumber = last - first + 1;
+    }
+    number++;
+  }
+  return number;
+}
+
+/**
+ * \fn IdFrame* idFrameInitialize(IdStack *myIdStack, unsigned int *handles, unsigned int channelNumber)
+ * \brief Compile a set of handles into an IdFrame used to push all their values in one call.
+ *
+ * The IdElements are searched only once here. Their handles are kept, so a push can see that one of them was popped.
+ *
+ * \param myIdStack IdStack instance owning the handles.
+ * \param handles Array of the handles of the frame, in the order of the values in a packed frame.
+ * \param channelNumber Number of handles.
+ * \return the initialized IdFrame instance. NULL if a handle doesn't exist or is irregular.
+ */
+
+IdFrame* idFrameInitialize(IdStack *myIdStack, unsigned int *handles, unsigned int channelNumber)
+{
+  if (myIdStack == NULL || handles == NULL || channelNumber == 0)
+  {
+    perror("Error : myIdStack and handles should be initialized");
+    return NULL;
+  }
+  IdFrame *idFrame = (IdFrame*) malloc(sizeof(*idFrame));
+  if (idFrame == NULL)
+  {
+    perror("Error : Memory allocation for idFrame impossible");
+    return NULL;
+  }
+  idFrame->channels = (IdElement**) malloc(channelNumber*sizeof(*idFrame->channels));
+  idFrame->handles = (unsigned int*) malloc(channelNumber*sizeof(*idFrame->handles));
+  idFrame->offsets = (unsigned int*) malloc((channelNumber+1)*sizeof(*idFrame->offsets));
+  if (idFrame->channels == NULL || idFrame->handles == NULL || idFrame->offsets == NULL)
+  {
+    perror("Error : Memory allocation for idFrame impossible");
+    idFrameDeinitialize(idFrame);
+    return NULL;
+  }
+  idFrame->channelNumber = channelNumber;
+  idFrame->idStack = myIdStack;
+  idFrame->offsets[0] = 0;
+  for (unsigned int i = 0; i < channelNumber; i++)
+  {
+    idFrame->channels[i] = handleIdElement(myIdStack, handles[i]);
+    if (idFrame->channels[i] == NULL || idFrame->channels[i]->timeStack != NULL)
+    {
+      perror("Error : The Element corresponding to the handle is inexistant or irregular");
+      idFrameDeinitialize(idFrame);
+      return NULL;
+    }
+    idFrame->handles[i] = handles[i];
+    idFrame->offsets[i+1] = idFrame->offsets[i] + sizeDataType(idFrame->channels[i]->dataType);
+  }
+  return idFrame;
+}
+
+/**
+ * \fn void idFrameDeinitialize(IdFrame *idFrame)
+ * \brief Function used to deinitialize an IdFrame instance. The IdElements are not modified.
+ *
+ * \param idFrame IdFrame instance which have to be deinitialized.
+ */
+
+void idFrameDeinitialize(IdFrame *idFrame)
+{
+  if (idFrame == NULL)
+    return;
+  free(idFrame->channels);
+  free(idFrame->handles);
+  free(idFrame->offsets);
+  free(idFrame);
+}
+
+/**
+ * \fn int dataIdFramePush(IdFrame *idFrame, void *frame)
+ * \brief Push one value into each IdElement of the IdFrame, in one pass over the packed frame.
+ *
+ * Nothing is pushed if one of the IdElements has been popped or made irregular since idFrameInitialize.
+ *
+ * \param idFrame IdFrame compiled by idFrameInitialize.
+ * \param frame Pointer on the packed values (idFrame->offsets[idFrame->channelNumber] bytes).
+ * \return number of pushed values. -1 if it FAILED.
+ */
+
+int dataIdFramePush(IdFrame *idFrame, void *frame)
+{
+  if (idFrame == NULL || frame == NULL)
+  {
+    perror("Error : idFrame and frame should be initialized");
+    return -1;
+  }
+  IdElement **channels = idFrame->channels;
+  unsigned int *offsets = idFrame->offsets;
+  IdStack *myIdStack = idFrame->idStack;
+  size_t memory;
+  for (unsigned int i = 0; i < idFrame->channelNumber; i++)
+  {
+    if (myIdStack->handles[idFrame->handles[i]] != channels[i] || channels[i]->timeStack != NULL)
+    {
+      perror("Error : An IdElement of the idFrame has been popped or made irregular");
+      return -1;
+    }
+  }
+  for (unsigned int i = 0; i < idFrame->channelNumber; i++)
+  {
+    memory = idElementMemory(channels[i]);
+    stackPush(channels[i]->dataStack, (char*)frame + offsets[i], offsets[i+1]-offsets[i]);
+    addData(channels[i], 1);
+    myIdStack->memoryUsed += idElementMemory(channels[i]) - memory;
+    notifyPush(myIdStack, channels[i]);
+    if (channels[i]->quota != 0 && idElementMemory(channels[i]) > channels[i]->quota)
+      checkMemory(myIdStack, channels[i]);
+  }
+  if (myIdStack->memoryBudget != 0 && myIdStack->memoryUsed > myIdStack->memoryBudget)
+    idStackEvict(myIdStack);
+  return (int)idFrame->channelNumber;
+}
+
+/**
+ * \fn static void releaseRings(IdStack *myIdStack)
+ * \brief Free the RingBuffers given to the IdElements by a failed idStackConcurrent.
+ */
+
+static void releaseRings(IdStack *myIdStack)
+{
+  for (IdElement *idElement = myIdStack->first; idElement != NULL; idElement = idElement->next)
+  {
+    if (idElement->ring == NULL)
+      continue;
+    myIdStack->memoryUsed -= allocationSize(sizeof(RingBuffer)) + allocationSize((size_t)(idElement->ring->mask+1)*idElement->ring->numberSize);
+    ringDeinitialize(idElement->ring);
+    idElement->ring = NULL;
+  }
+}
+
+/**
+ * \fn int idStackConcurrent(IdStack *myIdStack, unsigned int ringSize)
+ * \brief Switch an IdStack to the concurrent mode : every IdElement gets a RingBuffer filled by dataHandleProduce.
+ *
+ * It has to be called before the producer threads start. The IdStack can't go back to the single thread mode.
+ *
+ * \param myIdStack IdStack instance.
+ * \param ringSize Number of data each RingBuffer can hold between two drains (rounded up to a power of 2).
+ * \return 0 if it SUCCESSED, -1 if it FAILED.
+ */
+
+int idStackConcurrent(IdStack *myIdStack, unsigned int ringSize)
+{
+  IdElement *idElement;
+  if (myIdStack == NULL)
+    {
+        perror("Error : myIdStack uninitialized");
+    return -1;
+    }
+  if (myIdStack->concurrent != NULL)
+  {
+    perror("Error : myIdStack is already concurrent");
+    return -1;
+  }
+  for (idElement = myIdStack->first; idElement != NULL; idElement = idElement->next)
+  {
+    if (idElement->timeStack != NULL)
+      continue;
+    idElement->ring = ringInitialize(ringSize, sizeDataType(idElement->dataType));
+    if (idElement->ring == NULL)
+    {
+      releaseRings(myIdStack);
+      return -1;
+    }
+    myIdStack->memoryUsed += allocationSize(sizeof(RingBuffer)) + allocationSize((size_t)(idElement->ring->mask+1)*idElement->ring->numberSize);
+  }
+  IdConcurrent *concurrent = (IdConcurrent*) malloc(sizeof(*concurrent));
+  if (concurrent == NULL)
+  {
+    perror("Error : Memory allocation for concurrent impossible");
+    releaseRings(myIdStack);
+    return -1;
+  }
+  atomic_init(&concurrent->table, NULL);
+  atomic_init(&concurrent->epoch, 0);
+  atomic_init(&concurrent->readers[0], 0);
+  atomic_init(&concurrent->readers[1], 0);
+  concurrent->ringSize = ringSize;
+  concurrent->retired = NULL;
+  myIdStack->concurrent = concurrent;
+  if (publishHandle(myIdStack, myIdStack->handleSize, NULL) != 0)
+  {
+    myIdStack->concurrent = NULL;
+    free(concurrent);
+    releaseRings(myIdStack);
+    return -1;
+  }
+  return 0;
+}
+
+/**
+ * \fn int dataHandleProduce(IdStack *myIdStack, unsigned int handle, void *newAdress)
+ * \brief Push a new data into the RingBuffer of the IdElement corresponding to the handle, from a producer thread.
+ *
+ * This function is lock-free and never waits for the consumer. Only one thread may produce data for a given handle.
+ *
+ * \param myIdStack concurrent IdStack instance.
+ * \param handle Handle of the IdElement (IdElement->handle).
+ * \param newAdress Pointer on the data we want to push into the IdElement.
+ * \return 0 if it SUCCESSED, -1 if the handle doesn't exist, is an irregular channel (never published to the producers) or if the RingBuffer is full (the consumer should drain more often).
+ */
+
+int dataHandleProduce(IdStack *myIdStack, unsigned int handle, void *newAdress)
+{
+  IdConcurrent *concurrent = myIdStack->concurrent;
+  IdTable *table;
+  IdElement *idElement = NULL;
+  unsigned int epoch;
+  int result = -1;
+  if (concurrent == NULL)
+  {
+    perror("Error : myIdStack should be concurrent");
+    return -1;
+  }
+  while (1)
+  {
+    epoch = atomic_load(&concurrent->epoch);
+    atomic_fetch_add(&concurrent->readers[epoch%2], 1);
+    if (atomic_load(&concurrent->epoch) == epoch)
+      break;
+    atomic_fetch_sub(&concurrent->readers[epoch%2], 1);
+  }
+  table = atomic_load_explicit(&concurrent->table, memory_order_acquire);
+  if (handle < table->size)
+    idElement = atomic_load_explicit(&table->slots[handle], memory_order_acquire);
+  if (idElement != NULL)
+    result = ringPush(idElement->ring, newAdress);
+  atomic_fetch_sub(&concurrent->readers[epoch%2], 1);
+  return result;
+}
+
+/**
+ * \fn int idElementDrain(IdStack *myIdStack, IdElement *idElement)
+ * \brief Move the data produced for an IdElement into its dataStack. Only called by the consumer thread.
+ *
+ * The budget isn't checked here, idStackDrain does it.
+ *
+ * \param myIdStack IdStack instance owning the IdElement.
+ * \param idElement IdElement to drain.
+ * \return number of moved data. -1 if it FAILED.
+ */
+
+int idElementDrain(IdStack *myIdStack, IdElement *idElement)
+{
+  if (myIdStack == NULL || idElement == NULL)
+  {
+    perror("Error : myIdStack and idElement should be initialized");
+    return -1;
+  }
+  return (int)drainIdElement(myIdStack, idElement);
+}
+
+/**
+ * \fn int idStackDrain(IdStack *myIdStack)
+ * \brief Move the data produced for every IdElement into the dataStacks, then free the unpublished IdElements and tables. Only called by the consumer thread.
+ *
+ * \param myIdStack concurrent IdStack instance.
+ * \return number of moved data. -1 if it FAILED.
+ */
+
+int idStackDrain(IdStack *myIdStack)
+{
+  IdElement *idElement;
+  int number = 0;
+  if (myIdStack == NULL || myIdStack->concurrent == NULL)
+  {
+    perror("Error : myIdStack should be concurrent");
+    return -1;
+  }
+  for (idElement = myIdStack->first; idElement != NULL; idElement = idElement->next)
+  {
+    number += drainIdElement(myIdStack, idElement);
+    notifyPush(myIdStack, idElement);
+  }
+  reclaim(myIdStack->concurrent);
+  if (myIdStack->memoryBudget != 0 && myIdStack->memoryUsed > myIdStack->memoryBudget)
+    idStackEvict(myIdStack);
+  return number;
+}
+
+/**
+ * \fn int idElementIrregular(IdStack *myIdStack, IdElement *idElement)
+ * \brief Switch an empty IdElement to an irregular channel : each data is then pushed with its own time.
+ *
+ * The timeInterval of the IdElement becomes 0 and its startTime is the time of its oldest data. In a concurrent
+ * IdStack, the IdElement is removed from the handle table of the producers : dataHandleProduce then returns -1.
+ *
+ * \param myIdStack IdStack instance owning the IdElement.
+ * \param idElement Empty IdElement.
+ * \return 0 if it SUCCESSED, -1 if it FAILED.
+ */
+
+int idElementIrregular(IdStack *myIdStack, IdElement *idElement)
+{
+  if (myIdStack == NULL || idElement == NULL)
+  {
+    perror("Error : myIdStack and idElement should be initialized");
+    return -1;
+  }
+  if (idElement->timeStack != NULL)
+    return 0;
+  drainIdElement(myIdStack, idElement);
+  if (idElement->dataNumber != 0)
+  {
+    perror("Error : Only an empty IdElement can become irregular");
+    return -1;
+  }
+  size_t memory = idElementMemory(idElement);
+  idElement->timeStack = timeInitialize(sizeDataType(idElement->dataType));
+  if (idElement->timeStack == NULL)
+    return -1;
+  /*The producers stop finding the IdElement, its RingBuffer is freed with it (a producer may still be using it)*/
+  if (myIdStack->concurrent != NULL)
+    publishHandle(myIdStack, idElement->handle, NULL);
+  stackTrim(idElement->dataStack);
+  idElement->startTime = 0;
+  idElement->timeInterval = 0;
+  myIdStack->memoryUsed += idElementMemory(idElement);
+  myIdStack->memoryUsed -= memory;
+  return 0;
+}
+
+/**
+ * \fn static IdElement* dataTimeElementPush(IdStack *myIdStack, IdElement *idElement, unsigned int time, void *newAdress)
+ * \brief Push a new data and its time into an irregular IdElement already found.
+ *
+ * \return pointer to the idElement in which was pushed the new data. NULL if it FAILED.
+ */
+
+static IdElement* dataTimeElementPush(IdStack *myIdStack, IdElement *idElement, unsigned int time, void *newAdress)
+{
+  if (idElement == NULL || idElement->timeStack == NULL)
+  {
+    perror("Error : The Element corresponding to the ID is inexistant or not irregular");
+    return NULL;
+  }
+  size_t memory = idElementMemory(idElement);
+  if (timeStackPush(idElement->timeStack, time, newAdress) != 0)
+    return NULL;
+  if (idElement->dataNumber == 0)
+    idElement->startTime = time;
+  idElement->dataNumber++;
+  myIdStack->memoryUsed += idElementMemory(idElement) - memory;
+  notifyPush(myIdStack, idElement);
+  checkMemory(myIdStack, idElement);
+  return idElement;
+}
+
+/**
+ * \fn IdElement* dataIdStackPushTime(IdStack *myIdStack, Id_type id, unsigned int time, void *newAdress)
+ * \brief Push a new data and its time into the irregular idElement corresponding to the id.
+ *
+ * \param myIdStack IdStack instance in which we want to search the IdElement.
+ * \param id Type of the ID we are looking for (defined in the Id_type enum).
+ * \param time Time of the data. It can't be lower than the time of the newest data of the IdElement.
+ * \param newAdress Pointer on the data we want to push into the IdElement.
+ * \return pointer to the idElement in which was pushed the new data. NULL if it FAILED.
  */
 
-IdStack* idInitialize()
+IdElement* dataIdStackPushTime(IdStack *myIdStack, Id_type id, unsigned int time, void *newAdress)
 {
-    IdStack *idStack = (IdStack*) malloc(sizeof(*idStack));
-  if (idStack == NULL)
+  if (myIdStack == NULL)
     {
-        perror("Error : Memory allocation for idStack impossible");
+        perror("Error : myIdStack uninitialized");
     return NULL;
     }
-    idStack->first = NULL;
-  return idStack;
+  return dataTimeElementPush(myIdStack, searchIdElement(myIdStack, id), time, newAdress);
 }
 
 /**
- * \fn void idDeinitialize(IdStack* myIdStack)
- * \brief Function used to deinitialize a idStack instance.
- *
- * This function have to be used after everything else function to deinitialise an IdStack instance.
+ * \fn IdElement* dataHandlePushTime(IdStack *myIdStack, unsigned int handle, unsigned int time, void *newAdress)
+ * \brief Push a new data and its time into the irregular idElement corresponding to the handle.
  *
- * \param myIdStack IdStack instance which have to be deinitialized.
+ * \param myIdStack IdStack instance owning the handle.
+ * \param handle Handle of the IdElement (IdElement->handle).
+ * \param time Time of the data. It can't be lower than the time of the newest data of the IdElement.
+ * \param newAdress Pointer on the data we want to push into the IdElement.
+ * \return pointer to the idElement in which was pushed the new data. NULL if it FAILED.
  */
-void idDeinitialize(IdStack* myIdStack)
+
+IdElement* dataHandlePushTime(IdStack *myIdStack, unsigned int handle, unsigned int time, void *newAdress)
 {
-  if (myIdStack == NULL)
-    {
-    perror("Error : myIdStack uninitialized");
-        return;
-    }
-  else
-    {
-    while(myIdStack->first != NULL)
-    {
-      firstIdStackPop(myIdStack);
-    }
-  }
-  free(myIdStack);
+  return dataTimeElementPush(myIdStack, handleIdElement(myIdStack, handle), time, newAdress);
 }
 
 /**
- * \fn IdElement* dataIdStackPush(IdStack* myIdStack, Id_type id, void *newAdress)
- * \brief Push a new data into the idElement corresponding to the id.
+ * \fn static void* dataTimeElementPop(IdStack *myIdStack, IdElement *idElement, unsigned int stopTime, unsigned int *number, unsigned int **times)
+ * \brief Pop the data of an irregular IdElement already found, from the oldest one to stopTime (included).
  *
- * \param myIdStack IdStack instance in which we want to search the IdElement where to put the new data.
- * \param id Type of the ID we are looking for (defined in the Id_type enum).
- * \param newAdress Pointer on the data we want to push into the IdElement.
- * \return pointer to the idElement in which was pushed the new data.
+ * \return pointer to the first element of the data array. NULL if none data corresponds.
  */
 
-IdElement* dataIdStackPush(IdStack* myIdStack, Id_type id, void *newAdress)
+static void* dataTimeElementPop(IdStack *myIdStack, IdElement *idElement, unsigned int stopTime, unsigned int *number, unsigned int **times)
 {
-  IdElement *idElement;
-  idElement = searchIdElement(myIdStack,id);
-  if (idElement != NULL)
+  void *array;
+  *number = 0;
+  if (times != NULL)
+    *times = NULL;
+  if (idElement == NULL || idElement->timeStack == NULL)
   {
-    stackPush(idElement->dataStack, newAdress, sizeDataType(idElement->dataType));
+    perror("Error : The Element corresponding to the ID is inexistant or not irregular");
+    return NULL;
   }
-  (idElement->dataNumber)++;
-  return idElement;
+  size_t memory = idElementMemory(idElement);
+  array = timeStackPop(idElement->timeStack, stopTime, number, times);
+  idElement->dataNumber -= *number;
+  idElement->startTime = timeStackStartTime(idElement->timeStack);
+  myIdStack->memoryUsed -= memory - idElementMemory(idElement);
+  return array;
 }
 
 /**
- * \fn void* dataIdStackPop(IdStack* myIdStack, Id_type id,unsigned int startTime,unsigned int stopTime)
- * \brief Push an array of data between the startTime of data and StopTime (included) corresponding to the id.
+ * \fn void* dataIdStackPopTime(IdStack *myIdStack, Id_type id, unsigned int stopTime, unsigned int *number, unsigned int **times)
+ * \brief Pop the data of the irregular IdElement corresponding to the id, from the oldest one to stopTime (included).
  *
- * \param myIdStack IdStack instance in which we want to search the IdElement to pop data from.
+ * \param myIdStack IdStack instance in which we want to search the IdElement.
  * \param id Type of the ID we are looking for (defined in the Id_type enum).
-
- * \param stopTime unsigned int corresponding to the wanted stoping time of data (Must be higher than the startTime of data and lower than the biggest time value)
- * \return pointer to the first element of the data array. NULL if the id doesn't exist or the stopTime is lower than startTime or higher than the highest time value.
+ * \param stopTime Time of the newest wanted data.
+ * \param number Set to the number of popped data.
+ * \param times If it isn't NULL, set to an array of the times of the popped data (to free after).
+ * \return pointer to the first element of the data array (to free after). NULL if none data corresponds.
  */
 
-void* dataIdStackPop(IdStack* myIdStack, Id_type id,unsigned int stopTime)
+void* dataIdStackPopTime(IdStack *myIdStack, Id_type id, unsigned int stopTime, unsigned int *number, unsigned int **times)
 {
-  IdElement *idElement;
-  unsigned int finalTime = 0;
-  int dataNumber=0;
-  if (myIdStack == NULL)
+  if (myIdStack == NULL || number == NULL)
     {
-        perror("Error : myIdStack uninitialized");
+        perror("Error : myIdStack and number should be initialized");
     return NULL;
     }
+  return dataTimeElementPop(myIdStack, searchIdElement(myIdStack, id), stopTime, number, times);
+}
 
-  idElement = searchIdElement(myIdStack,id);
-  if (idElement != NULL)
+/**
+ * \fn void* dataHandlePopTime(IdStack *myIdStack, unsigned int handle, unsigned int stopTime, unsigned int *number, unsigned int **times)
+ * \brief Pop the data of the irregular IdElement corresponding to the handle, from the oldest one to stopTime (included).
+ *
+ * \param myIdStack IdStack instance owning the handle.
+ * \param handle Handle of the IdElement (IdElement->handle).
+ * \param stopTime Time of the newest wanted data.
+ * \param number Set to the number of popped data.
+ * \param times If it isn't NULL, set to an array of the times of the popped data (to free after).
+ * \return pointer to the first element of the data array (to free after). NULL if none data corresponds.
+ */
+
+void* dataHandlePopTime(IdStack *myIdStack, unsigned int handle, unsigned int stopTime, unsigned int *number, unsigned int **times)
+{
+  if (number == NULL)
   {
-    unsigned int startTime = idElement->startTime;
-    if (startTime != idElement->startTime && stopTime != idElement->startTime+idElement->timeInterval*idElement->dataNumber){
-      perror("startTime and stopTime can't be different from the extremals values at the same time");
-      return NULL;
+    perror("Error : number should be initialized");
+    return NULL;
+  }
+  return dataTimeElementPop(myIdStack, handleIdElement(myIdStack, handle), stopTime, number, times);
+}
+
+/**
+ * \fn void* dataHandleReadTime(IdStack *myIdStack, unsigned int handle, unsigned int startTime, unsigned int stopTime, unsigned int *number, unsigned int **times)
+ * \brief Copy the data of the irregular IdElement corresponding to the handle between two times (included), without popping them.
+ *
+ * \param myIdStack IdStack instance owning the handle.
+ * \param handle Handle of the IdElement (IdElement->handle).
+ * \param startTime Time of the oldest wanted data.
+ * \param stopTime Time of the newest wanted data.
+ * \param number Set to the number of copied data.
+ * \param times If it isn't NULL, set to an array of the times of the copied data (to free after).
+ * \return pointer to the first element of the data array (to free after). NULL if none data corresponds.
+ */
+
+void* dataHandleReadTime(IdStack *myIdStack, unsigned int handle, unsigned int startTime, unsigned int stopTime, unsigned int *number, unsigned int **times)
+{
+  IdElement *idElement = handleIdElement(myIdStack, handle);
+  if (number == NULL)
+  {
+    perror("Error : number should be initialized");
+    return NULL;
+  }
+  if (idElement == NULL || idElement->timeStack == NULL)
+  {
+    perror("Error : The Element corresponding to the handle is inexistant or not irregular");
+    *number = 0;
+    return NULL;
+  }
+  return timeStackRead(idElement->timeStack, startTime, stopTime, number, times);
+}
+
+/**
+ * \fn static uint64_t alignPosition(uint64_t position)
+ * \brief Return the first multiple of SNAPSHOT_ALIGN higher or equal to position.
+ */
+
+static uint64_t alignPosition(uint64_t position)
+{
+  return position + (SNAPSHOT_ALIGN - position%SNAPSHOT_ALIGN)%SNAPSHOT_ALIGN;
+}
+
+/**
+ * \fn static int writeArray(FILE *file, uint64_t *position, uint64_t offset, const void *array, size_t size, size_t number)
+ * \brief Write zeros in a snapshot file up to offset, then an array of number elements of size bytes.
+ *
+ * \return 0 if it SUCCESSED, -1 if it FAILED.
+ */
+
+static int writeArray(FILE *file, uint64_t *position, uint64_t offset, const void *array, size_t size, size_t number)
+{
+  static const char zeros[SNAPSHOT_ALIGN];
+  size_t padding = offset - *position;
+  *position = offset + (uint64_t)size*number;
+  if (fwrite(zeros, 1, padding, file) != padding)
+    return -1;
+  return (number == 0 || fwrite(array, size, number, file) == number) ? 0 : -1;
+}
+
+/**
+ * \fn static int writeIdElement(FILE *file, uint64_t *position, IdElement *idElement, IdSnapshotRecord *record)
+ * \brief Write the data of an IdElement in a snapshot file, from the oldest one, then its times or its segments.
+ *
+ * \return 0 if it SUCCESSED, -1 if it FAILED.
+ */
+
+static int writeIdElement(FILE *file, uint64_t *position, IdElement *idElement, IdSnapshotRecord *record)
+{
+  Stack *stack = idElement->dataStack;
+  int numberSize = sizeDataType(idElement->dataType);
+  unsigned int elementNumber = idElement->dataNumber - stack->baseNumber;
+  Element *element = stack->first;
+  char *array;
+  int result;
+  if (idElement->timeStack != NULL)
+  {
+    unsigned int *times;
+    if (idElement->dataNumber == 0)
+      return writeArray(file, position, record->offset, NULL, numberSize, 0);
+    array = (char*) timeStackRead(idElement->timeStack, 0, ~0u, &elementNumber, &times);
+    if (array == NULL)
+      return -1;
+    result = writeArray(file, position, record->offset, array, numberSize, elementNumber);
+    if (result == 0)
+      result = writeArray(file, position, record->timeOffset, times, sizeof(*times), elementNumber);
+    free(array);
+    free(times);
+    return result;
+  }
+  if (writeArray(file, position, record->offset, stack->base, numberSize, stack->baseNumber) != 0)
+    return -1;
+  if (elementNumber != 0)
+  {
+    array = (char*) malloc((size_t)elementNumber*numberSize);
+    if (array == NULL)
+    {
+      perror("Error : Memory allocation for array impossible");
+      return -1;
     }
-    finalTime = (idElement->startTime) + (idElement->dataNumber-1)*(idElement->timeInterval);
-    dataNumber = stackNumberCount(idElement->dataStack, idElement->timeInterval, finalTime,startTime,stopTime);
-    if (dataNumber > 0)
+    for (unsigned int i = elementNumber; i > 0 && element != NULL; i--)
     {
-      idElement->dataNumber -= dataNumber;
-      if(startTime == idElement->startTime)
-        idElement->startTime = stopTime + idElement->timeInterval;
-      return (stackPop(idElement->dataStack, sizeDataType(idElement->dataType),idElement->timeInterval, finalTime, stopTime,dataNumber));
+      memcpy(array + (size_t)(i-1)*numberSize, element->number, numberSize);
+      element = element->next;
     }
+    result = writeArray(file, position, *position, array, numberSize, elementNumber);
+    free(array);
+    if (result != 0)
+      return -1;
   }
-  return NULL;
+  if (idElement->segmentNumber == 0)
+    return 0;
+  return writeArray(file, position, record->segmentOffset, idElement->segments, sizeof(IdSegment), idElement->segmentNumber);
 }
 
 /**
- * \fn IdElement* searchIdElement(IdStack *myIdStack, Id_type id)
- * \brief Search the pointer to the IdElement corresponding to the ID.
+ * \fn int idStackSnapshot(IdStack *myIdStack, const char *path)
+ * \brief Write every IdElement of an IdStack and its data into one file, which can be given to idRestore.
  *
- * \param myIdStack IdStack instance in which we want to search the IdElement.
- * \param id Type of the ID we are looking for (defined in the Id_type enum).
- * \return pointer to the idElement corresponding to the id. NULL if it doesn't exist.
+ * The file is written at path.tmp then renamed, so path always holds a complete snapshot (even the one used by
+ * the IdStack itself if it was restored from path). In concurrent mode, it is called by the consumer thread.
+ * The FftElements are not part of the snapshot.
+ *
+ * \param myIdStack IdStack instance to save.
+ * \param path Path of the snapshot file.
+ * \return 0 if it SUCCESSED, -1 if it FAILED.
  */
 
-
-IdElement* searchIdElement(IdStack *myIdStack, Id_type id)
+int idStackSnapshot(IdStack *myIdStack, const char *path)
 {
-  IdElement *idElement = NULL;
-  if (myIdStack == NULL)
+  IdSnapshotHeader header;
+  IdSnapshotRecord *records;
+  IdElement *idElement;
+  unsigned int elementNumber = 0, i;
+  uint64_t position;
+  char *tmpPath;
+  FILE *file;
+  int result = 0;
+  if (myIdStack == NULL || path == NULL)
     {
-        perror("Error : myIdStack uninitialized");
-    return NULL;
+        perror("Error : myIdStack and path should be initialized");
+    return -1;
     }
-  idElement = myIdStack->first;
-  if (myIdStack != NULL && myIdStack->first != NULL)
-    {
-    while(idElement != NULL && idElement->id != id)
+  for (idElement = myIdStack->first; idElement != NULL; idElement = idElement->next)
+  {
+    drainIdElement(myIdStack, idElement);
+    elementNumber++;
+  }
+  records = (IdSnapshotRecord*) calloc(elementNumber + 1, sizeof(*records));
+  tmpPath = (char*) malloc(strlen(path) + 5);
+  if (records == NULL || tmpPath == NULL)
+  {
+    perror("Error : Memory allocation for the snapshot impossible");
+    free(records);
+    free(tmpPath);
+    return -1;
+  }
+  position = sizeof(header) + (uint64_t)elementNumber*sizeof(*records);
+  for (idElement = myIdStack->first, i = 0; idElement != NULL; idElement = idElement->next, i++)
+  {
+    records[i].id = idElement->id;
+    records[i].dataType = idElement->dataType;
+    records[i].signalType = idElement->signalType;
+    records[i].startTime = idElement->startTime;
+    records[i].timeInterval = idElement->timeInterval;
+    records[i].dataNumber = idElement->dataNumber;
+    records[i].handle = idElement->handle;
+    records[i].priority = idElement->priority;
+    records[i].irregular = (idElement->timeStack != NULL);
+    records[i].segmentNumber = idElement->segmentNumber;
+    records[i].quota = idElement->quota;
+    memcpy(records[i].name, idElement->name, ID_NAME_SIZE);
+    records[i].offset = alignPosition(position);
+    position = records[i].offset + (uint64_t)idElement->dataNumber*sizeDataType(idElement->dataType);
+    if (idElement->timeStack != NULL && idElement->dataNumber != 0)
     {
-      idElement = idElement ->next;
+      records[i].timeOffset = alignPosition(position);
+      position = records[i].timeOffset + (uint64_t)idElement->dataNumber*sizeof(uint32_t);
     }
-    return idElement;
+    if (idElement->segmentNumber != 0)
+    {
+      records[i].segmentOffset = alignPosition(position);
+      position = records[i].segmentOffset + (uint64_t)idElement->segmentNumber*sizeof(IdSegment);
     }
-  return NULL;
+  }
+  memset(&header, 0, sizeof(header));
+  memcpy(header.magic, SNAPSHOT_MAGIC, sizeof(SNAPSHOT_MAGIC));
+  header.version = SNAPSHOT_VERSION;
+  header.elementNumber = elementNumber;
+  header.size = position;
+
+  sprintf(tmpPath, "%s.tmp", path);
+  file = fopen(tmpPath, "wb");
+  if (file == NULL)
+  {
+    perror("Error : Opening of the snapshot file impossible");
+    free(records);
+    free(tmpPath);
+    return -1;
+  }
+  position = sizeof(header) + (uint64_t)elementNumber*sizeof(*records);
+  if (fwrite(&header, sizeof(header), 1, file) != 1 || fwrite(records, sizeof(*records), elementNumber, file) != elementNumber)
+    result = -1;
+  for (idElement = myIdStack->first, i = 0; idElement != NULL && result == 0; idElement = idElement->next, i++)
+  {
+    result = writeIdElement(file, &position, idElement, &records[i]);
+  }
+  if (fclose(file) != 0 || result != 0 || rename(tmpPath, path) != 0)
+  {
+    perror("Error : Writing of the snapshot file impossible");
+    remove(tmpPath);
+    result = -1;
+  }
+  free(records);
+  free(tmpPath);
+  return result;
 }
 
 /**
- * \fn int getStartTime(IdStack *myIdStack)
- * \brief Return the start time of the first IdElement of the IdStack.
+ * \fn static int checkSegments(IdSnapshotHeader *header, IdSnapshotRecord *record, size_t size)
+ * \brief Check that the segments of a record are inside the snapshot and cover its data.
  *
- * \param myIdStack IdStack instance which we want the first IdElement start time.
- * \return int value of the first IdElement start time. -1 if the instance doesn't exist.
+ * \return 0 if the segments are valid, -1 otherwise.
  */
 
-int getStartTime(IdStack *myIdStack)
+static int checkSegments(IdSnapshotHeader *header, IdSnapshotRecord *record, size_t size)
 {
-  if (myIdStack != NULL)
-    if (myIdStack != NULL)
-      return (myIdStack->first->startTime);
-  return -1;
+  uint64_t dataNumber = 0;
+  if (record->irregular || record->segmentNumber < 2 || record->segmentOffset%SNAPSHOT_ALIGN != 0 || record->segmentOffset > size || (size - record->segmentOffset)/sizeof(IdSegment) < record->segmentNumber)
+    return -1;
+  IdSegment *segments = (IdSegment*)((char*)header + record->segmentOffset);
+  for (unsigned int i = 0; i < record->segmentNumber; i++)
+    dataNumber += segments[i].dataNumber;
+  if (dataNumber != record->dataNumber || segments[0].startTime != record->startTime)
+    return -1;
+  return 0;
 }
 
 /**
- * \fn int getTimeInterval(IdStack *myIdStack)
- * \brief Return the time of the first IdElement of the IdStack.
+ * \fn static int checkSnapshot(IdSnapshotHeader *header, size_t size)
+ * \brief Check that a mapped file is a snapshot and that every data array is inside it.
  *
- * \param myIdStack IdStack instance which we want the first IdElement time interval.
- * \return int value of the first IdElement time interval. -1 if the instance doesn't exist.
+ * \return 0 if the snapshot is valid, -1 otherwise.
  */
 
-int getTimeInterval(IdStack *myIdStack)
+static int checkSnapshot(IdSnapshotHeader *header, size_t size)
 {
-  if (myIdStack != NULL)
-    if (myIdStack->first != NULL)
-      return (myIdStack->first->timeInterval);
-  return -1;
+  IdSnapshotRecord *records = (IdSnapshotRecord*)(header + 1);
+  if (size < sizeof(*header) || memcmp(header->magic, SNAPSHOT_MAGIC, sizeof(SNAPSHOT_MAGIC)) != 0 || header->version != SNAPSHOT_VERSION || header->size != size)
+    return -1;
+  if (header->elementNumber > (size - sizeof(*header))/sizeof(*records))
+    return -1;
+  for (unsigned int i = 0; i < header->elementNumber; i++)
+  {
+    int numberSize = (records[i].dataType <= CHAR) ? sizeDataType((Data_type)records[i].dataType) : -1;
+    if (numberSize <= 0 || records[i].id > REGISTERED || records[i].signalType > OTHER_TYPE || records[i].name[ID_NAME_SIZE-1] != '\0')
+      return -1;
+    if (records[i].offset%SNAPSHOT_ALIGN != 0 || records[i].offset > size || (size - records[i].offset)/numberSize < records[i].dataNumber)
+      return -1;
+    if (records[i].handle >= SNAPSHOT_HANDLE_LIMIT)
+      return -1;
+    if (records[i].irregular && records[i].dataNumber != 0 && (records[i].timeOffset%SNAPSHOT_ALIGN != 0 || records[i].timeOffset > size || (size - records[i].timeOffset)/sizeof(uint32_t) < records[i].dataNumber))
+      return -1;
+    if (records[i].segmentNumber != 0 && checkSegments(header, &records[i], size) != 0)
+      return -1;
+  }
+  return 0;
 }
 
-
 /**
- * \fn IdElement* idStackPush(IdStack *myIdStack, Id_type newId,Signal_type newSignalType, Data_type newDataType,unsigned int newStartTime, unsigned int newTimeInterval)
- * \brief Function used to add and configure a new IdElement
+ * \fn IdStack* idRestore(const char *path)
+ * \brief Function used to initialize an IdStack instance from a file written by idStackSnapshot.
  *
- * This function have to be used after idInitialize().
+ * The file is mapped and its data arrays become the oldest data of the dataStacks : they are read in place and
+ * freed by idDeinitialize. The IdElements keep their handles. The data of the irregular channels are copied one by
+ * one into their TimeStacks, so their restore time grows with their number of data. The quotas are set after this
+ * copy : nothing is evicted during the restore.
  *
- * \param myIdStack IdStack instance in which an IdElement will be added.
- * \param newId Type of the new ID (defined in the enum Id_type).
- * \param newSignalType Type of the new ID Signal (defined in the enum Signal_type).
- * \param newDataType Type of the data (defined in the enum Data_type).
- * \param newStartTime Start time of the data.
- * \param newTimeInterval Time interval between each data value.
- * \return pointer on the new IdElement.
+ * \param path Path of the snapshot file.
+ * \return the restored IdStack instance. NULL if the file can't be read or isn't a valid snapshot.
  */
 
-IdElement* idStackPush(IdStack *myIdStack, Id_type newId,Signal_type newSignalType, Data_type newDataType,unsigned int newStartTime, unsigned int newTimeInterval)
+IdStack* idRestore(const char *path)
 {
-    IdElement *idElement = (IdElement*) malloc(sizeof(*idElement));
-  if (idElement == NULL)
-    {
-        perror("Error : Memory allocation for idElement impossible");
+  struct stat fileStat;
+  IdSnapshotHeader *header;
+  IdSnapshotRecord *records;
+  IdElement *idElement, **handles;
+  unsigned int handleNumber = 0, handleSize = 8;
+  void *mapping;
+  int fd = open(path, O_RDONLY);
+  if (fd < 0)
+  {
+    perror("Error : Opening of the snapshot file impossible");
+    return NULL;
+  }
+  if (fstat(fd, &fileStat) != 0 || fileStat.st_size < (off_t)sizeof(*header))
+  {
+    perror("Error : The snapshot file is invalid");
+    close(fd);
     return NULL;
+  }
+  mapping = mmap(NULL, fileStat.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+  close(fd);
+  if (mapping == MAP_FAILED)
+  {
+    perror("Error : Mapping of the snapshot file impossible");
+    return NULL;
+  }
+  header = (IdSnapshotHeader*) mapping;
+  records = (IdSnapshotRecord*)(header + 1);
+  if (checkSnapshot(header, fileStat.st_size) != 0)
+  {
+    perror("Error : The snapshot file is invalid");
+    munmap(mapping, fileStat.st_size);
+    return NULL;
+  }
+  IdStack *myIdStack = idInitialize();
+  if (myIdStack == NULL)
+  {
+    munmap(mapping, fileStat.st_size);
+    return NULL;
+  }
+  myIdStack->snapshot = mapping;
+  myIdStack->snapshotSize = fileStat.st_size;
+  /*The records are in the order of the list, so they are pushed from the last one*/
+  for (unsigned int i = header->elementNumber; i > 0; i--)
+  {
+    IdSnapshotRecord *record = &records[i-1];
+    idElement = newIdElement(myIdStack, (Id_type)record->id, record->name, (Signal_type)record->signalType, (Data_type)record->dataType, record->startTime, record->timeInterval);
+    if (idElement == NULL)
+    {
+      idDeinitialize(myIdStack);
+      return NULL;
     }
-    if (myIdStack == NULL)
+    idElement->priority = record->priority;
+    if (record->handle >= handleNumber)
+      handleNumber = record->handle + 1;
+    if (record->irregular)
     {
-        perror("Error : myIdStack uninitialized");
-    return NULL;
+      /*The data of an irregular channel are copied into its TimeStack*/
+      uint32_t *times = (uint32_t*)((char*)mapping + record->timeOffset);
+      char *data = (char*)mapping + record->offset;
+      if (idElementIrregular(myIdStack, idElement) != 0)
+      {
+        idDeinitialize(myIdStack);
+        return NULL;
+      }
+      for (unsigned int j = 0; j < record->dataNumber; j++)
+      {
+        if (dataTimeElementPush(myIdStack, idElement, times[j], data + (size_t)j*sizeDataType(idElement->dataType)) == NULL)
+        {
+          idDeinitialize(myIdStack);
+          return NULL;
+        }
+      }
     }
-  if (idElement == NULL)
+    else
     {
-        perror("Error : idElement uninitialized");
-    return NULL;
+      stackMap(idElement->dataStack, (char*)mapping + record->offset, record->dataNumber, sizeDataType(idElement->dataType));
+      idElement->dataNumber = record->dataNumber;
+      if (record->segmentNumber != 0)
+      {
+        idElement->segments = (IdSegment*) malloc(record->segmentNumber*sizeof(IdSegment));
+        if (idElement->segments == NULL)
+        {
+          perror("Error : Memory allocation for segments impossible");
+          idDeinitialize(myIdStack);
+          return NULL;
+        }
+        memcpy(idElement->segments, (char*)mapping + record->segmentOffset, record->segmentNumber*sizeof(IdSegment));
+        idElement->segmentNumber = record->segmentNumber;
+        idElement->segmentCapacity = record->segmentNumber;
+        myIdStack->memoryUsed += allocationSize(record->segmentNumber*sizeof(IdSegment));
+      }
     }
-  if (sizeDataType(newDataType) <= 0)
+    idElement->quota = record->quota;
+  }
+  while (handleSize < handleNumber)
   {
-        perror("Error : SizeDataType should be high than 0");
+    handleSize *= 2;
+  }
+  handles = (IdElement**) calloc(handleSize, sizeof(*handles));
+  if (handles == NULL)
+  {
+    perror("Error : Memory allocation for handles impossible");
+    idDeinitialize(myIdStack);
     return NULL;
+  }
+  /*The IdElement of the record i received the handle elementNumber-1-i when it was pushed*/
+  for (unsigned int i = 0; i < header->elementNumber; i++)
+  {
+    if (handles[records[i].handle] != NULL)
+    {
+      perror("Error : The snapshot file is invalid");
+      free(handles);
+      idDeinitialize(myIdStack);
+      return NULL;
     }
-  idElement->dataNumber=0;
-    idElement->id = newId;
-  idElement->signalType = newSignalType;
-    idElement->dataType = newDataType;
-    idElement->startTime = newStartTime;
-    idElement->timeInterval = newTimeInterval;
-    idElement->next = myIdStack->first;
-    myIdStack->first = idElement;
-  idElement->dataStack = initialize();
-  return idElement;
+    handles[records[i].handle] = myIdStack->handles[header->elementNumber-1-i];
+  }
+  for (unsigned int i = 0; i < header->elementNumber; i++)
+  {
+    handles[records[i].handle]->handle = records[i].handle;
+  }
+  free(myIdStack->handles);
+  myIdStack->handles = handles;
+  myIdStack->handleNumber = handleNumber;
+  myIdStack->handleSize = handleSize;
+  return myIdStack;
 }
 
 /**
@@ -298,8 +2209,7 @@ int firstIdStackPop(IdStack *myIdStack)
     {
         id = idElement->id;
         myIdStack->first = idElement->next;
-    deinitialize(idElement->dataStack);
-        free(idElement);
+    freeIdElement(myIdStack, idElement);
     }
     return id;
 }
@@ -343,8 +2253,7 @@ int idStackPop(IdStack *myIdStack, Id_type id)
       {
         oldStackElement->next = stackElement->next;
       }
-      deinitialize(stackElement->dataStack);
-      free(stackElement);
+      freeIdElement(myIdStack, stackElement);
       return 0;
     }
 
@@ -374,7 +2283,7 @@ void printIdStack(IdStack *idStack)
 
     while (current != NULL)
     {
-        printf("ID:%d  SignalType:%d  TypeSize:%d  StartTime:%d  TimeInterval:%d    Number of Element : %d\n", current->id,current->signalType,sizeDataType(current->dataType),current->startTime,current->timeInterval,current->dataNumber);
+        printf("ID:%d  Handle:%d  Name:%s  SignalType:%d  TypeSize:%d  StartTime:%d  TimeInterval:%d    Number of Element : %d\n", current->id,current->handle,current->name,current->signalType,sizeDataType(current->dataType),current->startTime,current->timeInterval,current->dataNumber);
     //printStack(current->dataStack);
         current = current->next;
     }
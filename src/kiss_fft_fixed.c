@@ -0,0 +1,28 @@
+/*
+ * Fixed point (Q31) build of kiss_fft.c and kiss_fftr.c, declared in kiss_fft_fixed.h.
+ *
+ * The two files are compiled a second time with FIXED_POINT == 32 and their external names renamed, so that the
+ * float and the fixed point transforms are linked together.
+ */
+
+#include <stdint.h>
+
+#define FIXED_POINT 32
+
+#define kiss_fft_cpx kiss_fft_fixed_cpx
+#define kiss_fft_cfg kiss_fft_fixed_cfg
+#define kiss_fft_state kiss_fft_fixed_state
+#define kiss_fftr_cfg kiss_fftr_fixed_cfg
+#define kiss_fftr_state kiss_fftr_fixed_state
+#define kiss_fft_alloc kiss_fft_fixed_alloc
+#define kiss_fft kiss_fft_fixed
+#define kiss_fft_stride kiss_fft_fixed_stride
+#define kiss_fft_cleanup kiss_fft_fixed_cleanup
+#define kiss_fft_next_fast_size kiss_fft_fixed_next_fast_size
+#define kiss_fftr_alloc kiss_fftr_fixed_alloc
+#define kiss_fftr kiss_fftr_fixed
+#define kiss_fftri kiss_fftri_fixed
+#define copycpx copycpx_fixed
+
+#include "kiss_fft.c"
+#include "kiss_fftr.c"
@@ -0,0 +1,120 @@
+/**
+ * \file ringBuffer.c
+ * \brief RingBuffer Functions
+ *
+ * Lock-free single-producer/single-consumer buffer of fixed size data, used by idStack.c in concurrent mode.
+ *
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "ringBuffer.h"
+
+/**
+ * \fn RingBuffer* ringInitialize(unsigned int size, unsigned int numberSize)
+ * \brief Function used to initialize a RingBuffer instance.
+ *
+ * \param size Number of data the RingBuffer can hold. It is rounded up to a power of 2.
+ * \param numberSize Size of a data.
+ * \return the initialized RingBuffer instance. NULL if it FAILED.
+ */
+
+RingBuffer* ringInitialize(unsigned int size, unsigned int numberSize)
+{
+	unsigned int realSize = 1;
+	if (size == 0 || numberSize == 0 || size > 0x80000000u)
+	{
+		perror("Error : Size of the RingBuffer should be higher than 0");
+		return NULL;
+	}
+	while (realSize < size)
+	{
+		realSize *= 2;
+	}
+	RingBuffer *ring = (RingBuffer*) aligned_alloc(64, sizeof(*ring));
+	if (ring == NULL)
+	{
+		perror("Error : Memory allocation for ring impossible");
+		return NULL;
+	}
+	ring->buffer = (char*) malloc((size_t)realSize*numberSize);
+	if (ring->buffer == NULL)
+	{
+		perror("Error : Memory allocation for ring buffer impossible");
+		free(ring);
+		return NULL;
+	}
+	atomic_init(&ring->head, 0);
+	atomic_init(&ring->tail, 0);
+	ring->mask = realSize-1;
+	ring->numberSize = numberSize;
+	return ring;
+}
+
+/**
+ * \fn void ringDeinitialize(RingBuffer *ring)
+ * \brief Function used to deinitialize a RingBuffer instance. No thread may use it anymore.
+ *
+ * \param ring RingBuffer instance which have to be deinitialized.
+ */
+
+void ringDeinitialize(RingBuffer *ring)
+{
+	if (ring == NULL)
+		return;
+	free(ring->buffer);
+	free(ring);
+}
+
+/**
+ * \fn int ringPush(RingBuffer *ring, void *newAdress)
+ * \brief Copy a data at the end of the RingBuffer. Only called by the producer thread.
+ *
+ * \param ring RingBuffer instance.
+ * \param newAdress Pointer on the data (ring->numberSize bytes).
+ * \return 0 if it SUCCESSED, -1 if the RingBuffer is full.
+ */
+
+int ringPush(RingBuffer *ring, void *newAdress)
+{
+	unsigned int tail = atomic_load_explicit(&ring->tail, memory_order_relaxed);
+	unsigned int head = atomic_load_explicit(&ring->head, memory_order_acquire);
+	if (tail - head > ring->mask)
+		return -1;
+	memcpy(ring->buffer + (size_t)(tail & ring->mask)*ring->numberSize, newAdress, ring->numberSize);
+	atomic_store_explicit(&ring->tail, tail+1, memory_order_release);
+	return 0;
+}
+
+/**
+ * \fn unsigned int ringAvailable(RingBuffer *ring)
+ * \brief Return the number of data which can be read. Only called by the consumer thread.
+ */
+
+unsigned int ringAvailable(RingBuffer *ring)
+{
+	return atomic_load_explicit(&ring->tail, memory_order_acquire) - atomic_load_explicit(&ring->head, memory_order_relaxed);
+}
+
+/**
+ * \fn void* ringPeek(RingBuffer *ring, unsigned int i)
+ * \brief Return a pointer on the i-th oldest data. Only called by the consumer thread, with i lower than ringAvailable(ring).
+ */
+
+void* ringPeek(RingBuffer *ring, unsigned int i)
+{
+	unsigned int head = atomic_load_explicit(&ring->head, memory_order_relaxed);
+	return ring->buffer + (size_t)((head + i) & ring->mask)*ring->numberSize;
+}
+
+/**
+ * \fn void ringRelease(RingBuffer *ring, unsigned int number)
+ * \brief Give the number oldest data back to the producer. Only called by the consumer thread.
+ */
+
+void ringRelease(RingBuffer *ring, unsigned int number)
+{
+	unsigned int head = atomic_load_explicit(&ring->head, memory_order_relaxed);
+	atomic_store_explicit(&ring->head, head+number, memory_order_release);
+}
@@ -32,6 +32,11 @@ Stack* initialize()
 		return NULL;
     }
     stack->first = NULL;
+    stack->spare = NULL;
+    stack->spareNumber = 0;
+    stack->base = NULL;
+    stack->baseNumber = 0;
+    stack->baseSize = 0;
 	return stack;
 }
 
@@ -57,6 +62,7 @@ void deinitialize(Stack* stack)
 		{
 			free(firstStackPop(stack));
 		}
+		stackTrim(stack);
 	}
 	free(stack);
 }
@@ -65,7 +71,8 @@ void deinitialize(Stack* stack)
  * \fn void stackPush(Stack *stack, void *newAdress, int numberSize)
  * \brief Function used to add and configure a new Element with it data into a Stack.
  *
- * This function have to be used after initialize().
+ * This function have to be used after initialize(). A spare Element is reused when there is one, so a Stack
+ * which is regularly popped doesn't allocate memory anymore.
  *
  * \param stack Stack instance in which an Element will be added.
  * \param newAdress Pointer on the data we want to push into the Stack.
@@ -74,28 +81,64 @@ void deinitialize(Stack* stack)
 
 void stackPush(Stack *stack, void *newAdress, int numberSize)
 {
-    Element *newNb = (Element*) malloc(sizeof(*newNb));
-	if (newNb == NULL)
-	{
-		perror("Error : Allocation of newNb Impossible");
-		return;
-	}
+    Element *newNb;
     if (stack == NULL)
     {
         perror("Error : Stack uninitialized");
 		return;
     }
-	newNb->number = malloc(numberSize);
-	if (newNb->number == NULL)
-    {
-        perror("Error : Number pointer invalid");
-		return;
-    }
+	if (stack->spare != NULL)
+	{
+		newNb = stack->spare;
+		stack->spare = newNb->next;
+		stack->spareNumber--;
+	}
+	else
+	{
+		newNb = (Element*) malloc(sizeof(*newNb));
+		if (newNb == NULL)
+		{
+			perror("Error : Allocation of newNb Impossible");
+			return;
+		}
+		newNb->number = malloc(numberSize);
+		if (newNb->number == NULL)
+		{
+			perror("Error : Number pointer invalid");
+			free(newNb);
+			return;
+		}
+	}
 	memcpy(newNb->number,newAdress, numberSize);
     newNb->next = stack->first;
     stack->first = newNb;
 }
 
+/**
+ * \fn static void releaseElement(Stack *stack, Element *element)
+ * \brief Keep a popped Element in the spare list of the Stack, or free it if the spare list is full.
+ *
+ * Every data of a Stack has the same size, so the data buffer of a spare Element can be reused as it is.
+ *
+ * \param stack Stack instance from which the Element was popped.
+ * \param element Element to release.
+ */
+
+static void releaseElement(Stack *stack, Element *element)
+{
+	if (stack->spareNumber < STACK_SPARE_MAX)
+	{
+		element->next = stack->spare;
+		stack->spare = element;
+		stack->spareNumber++;
+	}
+	else
+	{
+		free(element->number);
+		free(element);
+	}
+}
+
 /**
  * \fn void* firstStackPop(Stack *stack)
  * \brief Function used to Pop the first Element.
@@ -129,6 +172,9 @@ void* firstStackPop(Stack *stack)
  * \fn void* stackPop(Stack* myStack, int type, unsigned int timeInterval,unsigned int finalTime,unsigned int stopTime, int i)
  * \brief Function used to pop Elements between two time values.
  *
+ * When the Elements are not enough, the oldest data are read in the base of the Stack. The data of the base
+ * can only be popped from the oldest one, which is what dataIdStackPop does.
+ *
  * \param myStack Stack instance in which Element(s) will be popped.
  * \param type Size of a data value.
  * \param timeInterval Time interval between each data value.
@@ -141,6 +187,7 @@ void* firstStackPop(Stack *stack)
 void* stackPop(Stack* myStack, int type, unsigned int timeInterval,unsigned int finalTime,unsigned int stopTime, int dataNumber)
 {
 	unsigned int time = finalTime;
+	unsigned int baseLeft;
 	char *array, *array2;
 	int j =0;
 	array = malloc(dataNumber*type);
@@ -162,20 +209,41 @@ void* stackPop(Stack* myStack, int type, unsigned int timeInterval,unsigned int
     {
 
 		element = myStack->first;
+		baseLeft = myStack->baseNumber;
 		while (stopTime < time)
 		{
-			oldElement = element;
-			element = element->next;
+			if (element != NULL)
+			{
+				oldElement = element;
+				element = element->next;
+			}
+			else
+			{
+				baseLeft--;
+			}
 			time -= timeInterval;
 		}
+		/*The data of the base can only be popped from the oldest one : it is checked before any Element is released*/
+		Element *last = element;
+		int elementNumber = 0;
+		while (elementNumber<dataNumber && last != NULL)
+		{
+			last = last->next;
+			elementNumber++;
+		}
+		if (elementNumber<dataNumber && baseLeft != (unsigned int)(dataNumber-elementNumber))
+		{
+			perror("Error : The data of the base can only be popped from the oldest one");
+			free(array);
+			return NULL;
+		}
 		firstElement = oldElement;
-		while (j<dataNumber)
+		while (j<dataNumber && element != NULL)
 		{
 			memcpy(array2,element->number,type);
 			oldElement = element;
 			element = element->next;
-			free(oldElement->number);
-			free(oldElement);
+			releaseElement(myStack, oldElement);
 			j++;
 			array2 -= type;
 		}
@@ -183,11 +251,37 @@ void* stackPop(Stack* myStack, int type, unsigned int timeInterval,unsigned int
 				myStack->first = element;
 			else
 				firstElement->next=element;
+		if (j<dataNumber)
+		{
+			/*The oldest data are read in the base, which is contiguous and in chronological order*/
+			unsigned int number = dataNumber-j;
+			memcpy(array, myStack->base, (size_t)number*type);
+			myStack->base += (size_t)number*type;
+			myStack->baseNumber -= number;
+		}
 	}
 	/*Don't forget to free array Then*/
 	return array;
 }
 
+/**
+ * \fn static int olderData(Element **element, unsigned int *baseLeft)
+ * \brief Move a position of a Stack to the next older data.
+ *
+ * The position is an Element, or the data baseLeft-1 of the base when element is NULL.
+ *
+ * \return 1 if there is an older data, 0 otherwise.
+ */
+
+static int olderData(Element **element, unsigned int *baseLeft)
+{
+	if (*element != NULL)
+		*element = (*element)->next;
+	else
+		(*baseLeft)--;
+	return *element != NULL || *baseLeft > 0;
+}
+
 /**
  * \fn int stackNumberCount(Stack *myStack, unsigned int timeInterval, unsigned int finalTime,unsigned int startTime,unsigned int stopTime)
  * \brief Function used to count the number of data satisfying the time condition.
@@ -214,22 +308,27 @@ int stackNumberCount(Stack *myStack, unsigned int timeInterval, unsigned int fin
 		return -1;
 	}
 	Element *element;
+	unsigned int baseLeft;
 	if (myStack != NULL)
     {
 		element = myStack->first;
+		baseLeft = myStack->baseNumber;
+		if (element == NULL && baseLeft == 0)
+		{
+			return -1;
+		}
 		while (stopTime < time)
 		{
-			if (element->next == NULL)
+			if (!olderData(&element, &baseLeft))
 			{
 				return -1;
 			}
-			element = element->next;
 			time -= timeInterval;
 		}
 		while (startTime <= time)
 		{
 			i++;
-			if (element->next == NULL)
+			if (!olderData(&element, &baseLeft))
 			{
 				if (startTime >= time)
 				{
@@ -238,12 +337,115 @@ int stackNumberCount(Stack *myStack, unsigned int timeInterval, unsigned int fin
 				return -1;
 			}
 			time -= timeInterval;
-			element = element->next;
 		}
 	}
 	return i;
 }
 
+/**
+ * \fn void stackTrim(Stack *stack)
+ * \brief Function used to free the spare Elements of a Stack.
+ *
+ * \param stack Stack instance we want to give the spare memory back.
+ */
+
+void stackTrim(Stack *stack)
+{
+	if (stack == NULL)
+    {
+        perror("Error : Stack uninitialized");
+		return;
+    }
+	while(stack->spare != NULL)
+	{
+		Element *spareElement = stack->spare;
+		stack->spare = spareElement->next;
+		free(spareElement->number);
+		free(spareElement);
+	}
+	stack->spareNumber = 0;
+}
+
+/**
+ * \fn void stackDrop(Stack *stack, unsigned int keepNumber)
+ * \brief Function used to free the oldest Elements of a Stack, without copying their data.
+ *
+ * The oldest data of the base are dropped too.
+ *
+ * \param stack Stack instance we want to drop the oldest Elements.
+ * \param keepNumber Number of the newest Elements which are kept.
+ */
+
+void stackDrop(Stack *stack, unsigned int keepNumber)
+{
+	Element *element, *oldElement;
+	unsigned int i;
+	if (stack == NULL)
+    {
+        perror("Error : Stack uninitialized");
+		return;
+    }
+	if (keepNumber == 0)
+	{
+		element = stack->first;
+		stack->first = NULL;
+	}
+	else
+	{
+		oldElement = stack->first;
+		for (i = 1; i < keepNumber && oldElement != NULL; i++)
+		{
+			oldElement = oldElement->next;
+		}
+		if (oldElement == NULL)
+		{
+			/*Every Element is kept, the oldest data are dropped from the base*/
+			keepNumber -= i-1;
+			if (keepNumber < stack->baseNumber)
+			{
+				stack->base += (size_t)(stack->baseNumber - keepNumber)*stack->baseSize;
+				stack->baseNumber = keepNumber;
+			}
+			return;
+		}
+		element = oldElement->next;
+		oldElement->next = NULL;
+	}
+	stack->baseNumber = 0;
+	while (element != NULL)
+	{
+		oldElement = element;
+		element = element->next;
+		free(oldElement->number);
+		free(oldElement);
+	}
+}
+
+/**
+ * \fn void stackMap(Stack *stack, void *base, unsigned int baseNumber, int baseSize)
+ * \brief Function used to give an empty Stack its oldest data, stored contiguously in chronological order.
+ *
+ * The data are read in place and never written : base can be a read-only mapping. It must stay valid until the
+ * Stack is deinitialized or its base is completely popped. The new data are pushed over the base as usual.
+ *
+ * \param stack Empty Stack instance.
+ * \param base Pointer on the oldest data.
+ * \param baseNumber Number of data in base.
+ * \param baseSize Size of a data.
+ */
+
+void stackMap(Stack *stack, void *base, unsigned int baseNumber, int baseSize)
+{
+	if (stack == NULL || stack->first != NULL || stack->baseNumber != 0)
+    {
+        perror("Error : Stack should be initialized and empty");
+		return;
+    }
+	stack->base = (char*) base;
+	stack->baseNumber = baseNumber;
+	stack->baseSize = baseSize;
+}
+
 /**
  * \fn void printStack(Stack *stack)
  * \brief Function used to print data in a Stack belonging to a idStack of specific datatype. (Here Float)
@@ -269,6 +471,10 @@ void printStack(Stack *stack) /*FLOAT PRINT FUNCTION*/
         printf("	%f\n", *(float*)current->number);
         current = current->next;
     }
+	for (unsigned int i = stack->baseNumber; i > 0; i--)
+	{
+		printf("	%f\n", *(float*)(stack->base + (size_t)(i-1)*stack->baseSize));
+	}
 
     /*printf("\n");*/
 }
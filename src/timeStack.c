@@ -0,0 +1,492 @@
+/**
+ * \file timeStack.c
+ * \brief TimeStack Functions
+ *
+ * Functions only used by idStack.c to store the data of the irregular channels with their times.
+ *
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include "timeStack.h"
+
+/**
+ * \fn TimeStack* timeInitialize(int numberSize)
+ * \brief Function used to initialize a TimeStack instance.
+ *
+ * \param numberSize Size of a data.
+ * \return the initialized TimeStack instance. NULL if it FAILED.
+ */
+
+TimeStack* timeInitialize(int numberSize)
+{
+	if (numberSize <= 0)
+	{
+		perror("Error : numberSize should be higher than 0");
+		return NULL;
+	}
+	TimeStack *timeStack = (TimeStack*) malloc(sizeof(*timeStack));
+	if (timeStack == NULL)
+	{
+		perror("Error : Memory allocation for timeStack impossible");
+		return NULL;
+	}
+	timeStack->blocks = NULL;
+	timeStack->firstBlock = 0;
+	timeStack->blockNumber = 0;
+	timeStack->blockCapacity = 0;
+	timeStack->skipNumber = 0;
+	timeStack->dataNumber = 0;
+	timeStack->numberSize = numberSize;
+	timeStack->memory = 0;
+	return timeStack;
+}
+
+/**
+ * \fn static void freeBlock(TimeStack *timeStack, TimeBlock *block)
+ * \brief Free the times and the data of a TimeBlock.
+ */
+
+static void freeBlock(TimeStack *timeStack, TimeBlock *block)
+{
+	timeStack->memory -= block->timeCapacity + (size_t)TIME_BLOCK_SIZE*timeStack->numberSize;
+	free(block->times);
+	free(block->data);
+}
+
+/**
+ * \fn void timeDeinitialize(TimeStack *timeStack)
+ * \brief Function used to deinitialize a TimeStack instance.
+ *
+ * \param timeStack TimeStack instance which have to be deinitialized.
+ */
+
+void timeDeinitialize(TimeStack *timeStack)
+{
+	if (timeStack == NULL)
+		return;
+	for (unsigned int i = timeStack->firstBlock; i < timeStack->blockNumber; i++)
+	{
+		freeBlock(timeStack, &timeStack->blocks[i]);
+	}
+	free(timeStack->blocks);
+	free(timeStack);
+}
+
+/**
+ * \fn static void decodeTimes(TimeBlock *block, unsigned int *times)
+ * \brief Decode the times of every data of a TimeBlock.
+ *
+ * \param block TimeBlock to decode.
+ * \param times Array of TIME_BLOCK_SIZE times filled from the oldest data.
+ */
+
+static void decodeTimes(TimeBlock *block, unsigned int *times)
+{
+	unsigned int time = block->firstTime, delta = 0, position = 0;
+	times[0] = time;
+	for (unsigned int i = 1; i < block->dataNumber; i++)
+	{
+		uint64_t zigzag = 0;
+		unsigned int shift = 0;
+		unsigned char byte;
+		do
+		{
+			byte = block->times[position++];
+			zigzag |= (uint64_t)(byte & 0x7f) << shift;
+			shift += 7;
+		} while (byte & 0x80);
+		/*delta-of-delta = (zigzag >> 1) or ~(zigzag >> 1), the deltas are computed modulo 2^32*/
+		delta += (unsigned int)((zigzag & 1) ? ~(zigzag >> 1) : (zigzag >> 1));
+		time += delta;
+		times[i] = time;
+	}
+}
+
+/**
+ * \fn static int newBlock(TimeStack *timeStack, unsigned int time)
+ * \brief Add an empty TimeBlock after the newest one, which gives back its unused bytes of times.
+ *
+ * \return 0 if it SUCCESSED, -1 if it FAILED.
+ */
+
+static int newBlock(TimeStack *timeStack, unsigned int time)
+{
+	TimeBlock *block;
+	if (timeStack->blockNumber > timeStack->firstBlock)
+	{
+		block = &timeStack->blocks[timeStack->blockNumber-1];
+		unsigned char *times = (block->timeSize == 0 || block->timeSize == block->timeCapacity) ? NULL : (unsigned char*) realloc(block->times, block->timeSize);
+		if (times != NULL)
+		{
+			timeStack->memory -= block->timeCapacity - block->timeSize;
+			block->times = times;
+			block->timeCapacity = block->timeSize;
+		}
+	}
+	if (timeStack->blockNumber == timeStack->blockCapacity)
+	{
+		if (timeStack->firstBlock > 0)
+		{
+			memmove(timeStack->blocks, timeStack->blocks + timeStack->firstBlock, (timeStack->blockNumber - timeStack->firstBlock)*sizeof(*timeStack->blocks));
+			timeStack->blockNumber -= timeStack->firstBlock;
+			timeStack->firstBlock = 0;
+		}
+		else
+		{
+			unsigned int newCapacity = (timeStack->blockCapacity == 0) ? 4 : 2*timeStack->blockCapacity;
+			TimeBlock *blocks = (TimeBlock*) realloc(timeStack->blocks, newCapacity*sizeof(*blocks));
+			if (blocks == NULL)
+			{
+				perror("Error : Memory allocation for blocks impossible");
+				return -1;
+			}
+			timeStack->memory += (newCapacity - timeStack->blockCapacity)*sizeof(*blocks);
+			timeStack->blocks = blocks;
+			timeStack->blockCapacity = newCapacity;
+		}
+	}
+	block = &timeStack->blocks[timeStack->blockNumber];
+	block->data = (char*) malloc((size_t)TIME_BLOCK_SIZE*timeStack->numberSize);
+	if (block->data == NULL)
+	{
+		perror("Error : Memory allocation for block data impossible");
+		return -1;
+	}
+	block->firstTime = time;
+	block->lastTime = time;
+	block->lastDelta = 0;
+	block->dataNumber = 0;
+	block->timeSize = 0;
+	block->timeCapacity = 0;
+	block->times = NULL;
+	timeStack->memory += (size_t)TIME_BLOCK_SIZE*timeStack->numberSize;
+	timeStack->blockNumber++;
+	return 0;
+}
+
+/**
+ * \fn int timeStackPush(TimeStack *timeStack, unsigned int time, void *newAdress)
+ * \brief Function used to add a data and its time after the newest data of a TimeStack.
+ *
+ * A regularly sampled channel costs one byte of time per data.
+ *
+ * \param timeStack TimeStack instance.
+ * \param time Time of the data. It can't be lower than the time of the newest data.
+ * \param newAdress Pointer on the data (timeStack->numberSize bytes).
+ * \return 0 if it SUCCESSED, -1 if it FAILED.
+ */
+
+int timeStackPush(TimeStack *timeStack, unsigned int time, void *newAdress)
+{
+	TimeBlock *block;
+	if (timeStack == NULL)
+	{
+		perror("Error : TimeStack uninitialized");
+		return -1;
+	}
+	if (timeStack->dataNumber > 0 && time < timeStack->blocks[timeStack->blockNumber-1].lastTime)
+	{
+		perror("Error : The time should not be lower than the time of the newest data");
+		return -1;
+	}
+	if (timeStack->dataNumber == 0 || timeStack->blocks[timeStack->blockNumber-1].dataNumber == TIME_BLOCK_SIZE)
+	{
+		if (newBlock(timeStack, time) != 0)
+			return -1;
+		block = &timeStack->blocks[timeStack->blockNumber-1];
+	}
+	else
+	{
+		block = &timeStack->blocks[timeStack->blockNumber-1];
+		if (block->timeSize + 5 > block->timeCapacity)
+		{
+			unsigned int newCapacity = (block->timeCapacity == 0) ? 32 : 2*block->timeCapacity;
+			unsigned char *times = (unsigned char*) realloc(block->times, newCapacity);
+			if (times == NULL)
+			{
+				perror("Error : Memory allocation for block times impossible");
+				return -1;
+			}
+			timeStack->memory += newCapacity - block->timeCapacity;
+			block->times = times;
+			block->timeCapacity = newCapacity;
+		}
+		unsigned int delta = time - block->lastTime;
+		int64_t deltaOfDelta = (int64_t)delta - (int64_t)block->lastDelta;
+		uint64_t zigzag = (deltaOfDelta < 0) ? ~((uint64_t)deltaOfDelta << 1) : (uint64_t)deltaOfDelta << 1;
+		while (zigzag >= 0x80)
+		{
+			block->times[block->timeSize++] = (unsigned char)(zigzag | 0x80);
+			zigzag >>= 7;
+		}
+		block->times[block->timeSize++] = (unsigned char)zigzag;
+		block->lastTime = time;
+		block->lastDelta = delta;
+	}
+	memcpy(block->data + (size_t)block->dataNumber*timeStack->numberSize, newAdress, timeStack->numberSize);
+	block->dataNumber++;
+	timeStack->dataNumber++;
+	return 0;
+}
+
+/**
+ * \fn static void locate(TimeStack *timeStack, unsigned int time, int after, unsigned int *block, unsigned int *index)
+ * \brief Find the oldest data with a time higher or equal to time (higher than time if after is 1).
+ *
+ * The TimeBlock is found with a binary search, then it is decoded. If there is no such data, block is timeStack->blockNumber.
+ *
+ * \param block Index of the TimeBlock of the data.
+ * \param index Index of the data in the TimeBlock.
+ */
+
+static void locate(TimeStack *timeStack, unsigned int time, int after, unsigned int *block, unsigned int *index)
+{
+	unsigned int times[TIME_BLOCK_SIZE];
+	unsigned int low = timeStack->firstBlock, high = timeStack->blockNumber, i;
+	while (low < high)
+	{
+		unsigned int middle = low + (high-low)/2;
+		unsigned int lastTime = timeStack->blocks[middle].lastTime;
+		if (lastTime < time || (after && lastTime == time))
+			low = middle+1;
+		else
+			high = middle;
+	}
+	*block = low;
+	*index = 0;
+	if (low == timeStack->blockNumber)
+		return;
+	decodeTimes(&timeStack->blocks[low], times);
+	i = (low == timeStack->firstBlock) ? timeStack->skipNumber : 0;
+	while (times[i] < time || (after && times[i] == time))
+	{
+		i++;
+	}
+	*index = i;
+}
+
+/**
+ * \fn static unsigned int countData(TimeStack *timeStack, unsigned int block0, unsigned int index0, unsigned int block1, unsigned int index1)
+ * \brief Return the number of data from the position (block0, index0) included to the position (block1, index1) excluded.
+ */
+
+static unsigned int countData(TimeStack *timeStack, unsigned int block0, unsigned int index0, unsigned int block1, unsigned int index1)
+{
+	unsigned int number = 0;
+	if (block0 == block1)
+		return (index1 > index0) ? index1 - index0 : 0;
+	if (block0 > block1)
+		return 0;
+	for (unsigned int i = block0; i < block1; i++)
+	{
+		number += timeStack->blocks[i].dataNumber;
+	}
+	return number - index0 + index1;
+}
+
+/**
+ * \fn static void copyData(TimeStack *timeStack, unsigned int block, unsigned int index, unsigned int number, char *data, unsigned int *times)
+ * \brief Copy number data (and their times if times isn't NULL) from the position (block, index).
+ */
+
+static void copyData(TimeStack *timeStack, unsigned int block, unsigned int index, unsigned int number, char *data, unsigned int *times)
+{
+	unsigned int blockTimes[TIME_BLOCK_SIZE];
+	int numberSize = timeStack->numberSize;
+	while (number > 0)
+	{
+		TimeBlock *timeBlock = &timeStack->blocks[block];
+		unsigned int copyNumber = timeBlock->dataNumber - index;
+		if (copyNumber > number)
+			copyNumber = number;
+		memcpy(data, timeBlock->data + (size_t)index*numberSize, (size_t)copyNumber*numberSize);
+		data += (size_t)copyNumber*numberSize;
+		if (times != NULL)
+		{
+			decodeTimes(timeBlock, blockTimes);
+			memcpy(times, blockTimes + index, copyNumber*sizeof(*times));
+			times += copyNumber;
+		}
+		number -= copyNumber;
+		block++;
+		index = 0;
+	}
+}
+
+/**
+ * \fn static void* copyRange(TimeStack *timeStack, unsigned int block, unsigned int index, unsigned int number, unsigned int **times)
+ * \brief Allocate and fill the arrays of number data (and times) from the position (block, index).
+ *
+ * \return pointer to the data array. NULL if it FAILED.
+ */
+
+static void* copyRange(TimeStack *timeStack, unsigned int block, unsigned int index, unsigned int number, unsigned int **times)
+{
+	char *data = (char*) malloc((size_t)number*timeStack->numberSize);
+	if (times != NULL)
+		*times = (unsigned int*) malloc(number*sizeof(**times));
+	if (data == NULL || (times != NULL && *times == NULL))
+	{
+		perror("Error : Memory allocation for array impossible");
+		free(data);
+		if (times != NULL)
+		{
+			free(*times);
+			*times = NULL;
+		}
+		return NULL;
+	}
+	copyData(timeStack, block, index, number, data, (times != NULL) ? *times : NULL);
+	return data;
+}
+
+/**
+ * \fn unsigned int timeStackStartTime(TimeStack *timeStack)
+ * \brief Return the time of the oldest data of a TimeStack (0 if it is empty).
+ */
+
+unsigned int timeStackStartTime(TimeStack *timeStack)
+{
+	unsigned int times[TIME_BLOCK_SIZE];
+	if (timeStack == NULL || timeStack->dataNumber == 0)
+		return 0;
+	if (timeStack->skipNumber == 0)
+		return timeStack->blocks[timeStack->firstBlock].firstTime;
+	decodeTimes(&timeStack->blocks[timeStack->firstBlock], times);
+	return times[timeStack->skipNumber];
+}
+
+/**
+ * \fn unsigned int timeStackCount(TimeStack *timeStack, unsigned int startTime, unsigned int stopTime)
+ * \brief Function used to count the number of data between two times (included).
+ *
+ * \param timeStack TimeStack instance.
+ * \param startTime Time of the oldest wanted data.
+ * \param stopTime Time of the newest wanted data.
+ * \return number of data between startTime and stopTime.
+ */
+
+unsigned int timeStackCount(TimeStack *timeStack, unsigned int startTime, unsigned int stopTime)
+{
+	unsigned int block0, index0, block1, index1;
+	if (timeStack == NULL || timeStack->dataNumber == 0 || startTime > stopTime)
+		return 0;
+	locate(timeStack, startTime, 0, &block0, &index0);
+	locate(timeStack, stopTime, 1, &block1, &index1);
+	return countData(timeStack, block0, index0, block1, index1);
+}
+
+/**
+ * \fn void* timeStackRead(TimeStack *timeStack, unsigned int startTime, unsigned int stopTime, unsigned int *number, unsigned int **times)
+ * \brief Function used to copy the data between two times (included), without popping them.
+ *
+ * \param timeStack TimeStack instance.
+ * \param startTime Time of the oldest wanted data.
+ * \param stopTime Time of the newest wanted data.
+ * \param number Set to the number of copied data.
+ * \param times If it isn't NULL, set to an array of the times of the copied data (to free after).
+ * \return pointer to the first element of the data array (to free after). NULL if none data corresponds.
+ */
+
+void* timeStackRead(TimeStack *timeStack, unsigned int startTime, unsigned int stopTime, unsigned int *number, unsigned int **times)
+{
+	unsigned int block0, index0, block1, index1;
+	*number = 0;
+	if (times != NULL)
+		*times = NULL;
+	if (timeStack == NULL || timeStack->dataNumber == 0 || startTime > stopTime)
+		return NULL;
+	locate(timeStack, startTime, 0, &block0, &index0);
+	locate(timeStack, stopTime, 1, &block1, &index1);
+	*number = countData(timeStack, block0, index0, block1, index1);
+	if (*number == 0)
+		return NULL;
+	return copyRange(timeStack, block0, index0, *number, times);
+}
+
+/**
+ * \fn void* timeStackPop(TimeStack *timeStack, unsigned int stopTime, unsigned int *number, unsigned int **times)
+ * \brief Function used to pop the data from the oldest one to stopTime (included).
+ *
+ * \param timeStack TimeStack instance.
+ * \param stopTime Time of the newest wanted data.
+ * \param number Set to the number of popped data.
+ * \param times If it isn't NULL, set to an array of the times of the popped data (to free after).
+ * \return pointer to the first element of the data array (to free after). NULL if none data corresponds.
+ */
+
+void* timeStackPop(TimeStack *timeStack, unsigned int stopTime, unsigned int *number, unsigned int **times)
+{
+	unsigned int block1, index1;
+	void *data;
+	*number = 0;
+	if (times != NULL)
+		*times = NULL;
+	if (timeStack == NULL || timeStack->dataNumber == 0)
+		return NULL;
+	locate(timeStack, stopTime, 1, &block1, &index1);
+	*number = countData(timeStack, timeStack->firstBlock, timeStack->skipNumber, block1, index1);
+	if (*number == 0)
+		return NULL;
+	data = copyRange(timeStack, timeStack->firstBlock, timeStack->skipNumber, *number, times);
+	if (data == NULL)
+	{
+		*number = 0;
+		return NULL;
+	}
+	timeStackDrop(timeStack, *number);
+	return data;
+}
+
+/**
+ * \fn void timeStackDrop(TimeStack *timeStack, unsigned int number)
+ * \brief Function used to remove the number oldest data of a TimeStack, without copying them.
+ *
+ * A TimeBlock is freed when all its data are removed.
+ *
+ * \param timeStack TimeStack instance.
+ * \param number Number of data to remove (all the data if it is higher than timeStack->dataNumber).
+ */
+
+void timeStackDrop(TimeStack *timeStack, unsigned int number)
+{
+	if (timeStack == NULL)
+		return;
+	if (number > timeStack->dataNumber)
+		number = timeStack->dataNumber;
+	timeStack->dataNumber -= number;
+	while (number > 0)
+	{
+		TimeBlock *block = &timeStack->blocks[timeStack->firstBlock];
+		unsigned int available = block->dataNumber - timeStack->skipNumber;
+		if (number < available)
+		{
+			timeStack->skipNumber += number;
+			return;
+		}
+		number -= available;
+		freeBlock(timeStack, block);
+		timeStack->firstBlock++;
+		timeStack->skipNumber = 0;
+	}
+	if (timeStack->dataNumber == 0)
+	{
+		timeStack->firstBlock = 0;
+		timeStack->blockNumber = 0;
+	}
+}
+
+/**
+ * \fn size_t timeStackMemory(TimeStack *timeStack)
+ * \brief Return the number of bytes allocated by a TimeStack.
+ */
+
+size_t timeStackMemory(TimeStack *timeStack)
+{
+	if (timeStack == NULL)
+		return 0;
+	return sizeof(*timeStack) + timeStack->memory;
+}